@@ -36,6 +36,7 @@
 #include "Banks/CachedDDR3Bank/CachedDDR3Bank.h"
 #include "include/NVMHelpers.h"
 #include "src/EventQueue.h"
+#include "src/ConfigSchema.h"
 
 #include <cassert>
 
@@ -76,12 +77,18 @@ CachedDDR3Bank::~CachedDDR3Bank( )
 
 void CachedDDR3Bank::SetConfig( Config *config, bool createChildren )
 {
+    /* Resolved once, since every bank reads these. */
+    static const ConfigKey colsKey( "COLS" );
+    static const ConfigKey readOnlyKey( "CachedRowsReadOnly" );
+    static const ConfigKey rowSizeKey( "CachedRowSize" );
+    static const ConfigKey rowCountKey( "CachedRowCount" );
+
     // Assume entire row is cached if CachedRowSize is unset
-    config->GetValueUL( "COLS", rowBufferSize );
+    config->GetValueUL( colsKey, rowBufferSize );
 
-    config->GetBool( "CachedRowsReadOnly", readOnlyBuffers );
-    config->GetValueUL( "CachedRowSize", rowBufferSize );
-    config->GetValueUL( "CachedRowCount", rowBufferCount );
+    config->GetBool( readOnlyKey, readOnlyBuffers );
+    config->GetValueUL( rowSizeKey, rowBufferSize );
+    config->GetValueUL( rowCountKey, rowBufferCount );
 
     /* Initialize row buffers. */
     cachedRowBuffer = new CachedRowBuffer*[rowBufferCount];
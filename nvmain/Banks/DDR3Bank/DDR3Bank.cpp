@@ -36,6 +36,7 @@
 #include "Banks/DDR3Bank/DDR3Bank.h"
 #include "src/MemoryController.h"
 #include "src/EventQueue.h"
+#include "src/ConfigSchema.h"
 
 #include <signal.h>
 #include <cassert>
@@ -117,9 +118,13 @@ DDR3Bank::~DDR3Bank( )
 
 void DDR3Bank::SetConfig( Config *config, bool createChildren )
 {
+    /* Resolved once, since every bank reads these. */
+    static const ConfigKey matWidthKey( "MATWidth" );
+    static const ConfigKey decoderKey( "Decoder" );
+
     /* customize MAT size */
-    if( config->KeyExists( "MATWidth" ) )
-        MATWidth = static_cast<ncounter_t>( config->GetValue( "MATWidth" ) );
+    if( config->KeyExists( matWidthKey ) )
+        MATWidth = static_cast<ncounter_t>( config->GetValue( matWidthKey ) );
 
     Params *params = new Params( );
     params->SetParams( config );
@@ -131,7 +136,7 @@ void DDR3Bank::SetConfig( Config *config, bool createChildren )
     if( createChildren )
     {
         /* When selecting a child, use the subarray field from the decoder. */
-        AddressTranslator *bankAT = DecoderFactory::CreateDecoderNoWarn( config->GetString( "Decoder" ) );
+        AddressTranslator *bankAT = DecoderFactory::CreateDecoderNoWarn( config->GetString( decoderKey ) );
         TranslationMethod *method = GetParent()->GetTrampoline()->GetDecoder()->GetTranslationMethod();
         bankAT->SetTranslationMethod( method );
         bankAT->SetDefaultField( SUBARRAY_FIELD );
@@ -32,6 +32,7 @@
 *******************************************************************************/
 
 #include "DataEncoders/FlipNWrite/FlipNWrite.h"
+#include "src/ConfigSchema.h"
 
 #include <iostream>
 
@@ -56,12 +57,15 @@ FlipNWrite::~FlipNWrite( )
 
 void FlipNWrite::SetConfig( Config *config, bool /*createChildren*/ )
 {
+    /* Resolved once, since every subarray has an encoder. */
+    static const ConfigKey granularityKey( "FlipNWriteGranularity" );
+
     Params *params = new Params( );
     params->SetParams( config );
     SetParams( params );
 
     /* Cache granularity size. */
-    fpSize = config->GetValue( "FlipNWriteGranularity" );
+    fpSize = config->GetValue( granularityKey );
 
     /* Some default size if the parameter is not specified */
     if( fpSize == -1 )
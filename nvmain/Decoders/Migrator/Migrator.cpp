@@ -41,14 +41,19 @@ using namespace NVM;
 
 Migrator::Migrator( )
 {
-    migrating = false;
-    inputPage = 0;
-    outputPage = 0;
+    migrationBuffers = 1;
     
     migratedAccesses = 0;
 
-    migrationMap.clear( );
-    migrationState.clear( );
+    /* Start small; the table doubles as pages are migrated. */
+    MigrationEntry empty;
+    empty.key = emptyKey;
+    empty.channel = 0;
+    empty.state = MIGRATION_UNKNOWN;
+
+    migrationTable.assign( 1024, empty );
+    migrationTableMask = migrationTable.size( ) - 1;
+    migrationTableCount = 0;
 }
 
 
@@ -69,6 +74,12 @@ void Migrator::SetConfig( Config *config, bool /*createChildren*/ )
     numBanks = config->GetValue( "BANKS" );
     numRanks = config->GetValue( "RANKS" );
     numSubarrays = config->GetValue( "ROWS" ) / config->GetValue( "MATHeight" );
+
+    /* Number of page pairs that may be migrating at once. */
+    config->GetValueUL( "MigrationBuffers", migrationBuffers );
+
+    if( migrationBuffers == 0 )
+        migrationBuffers = 1;
 }
 
 
@@ -99,6 +110,81 @@ uint64_t Migrator::GetAddressKey( NVMAddress& address )
 }
 
 
+Migrator::MigrationEntry *Migrator::FindEntry( uint64_t key )
+{
+    uint64_t slot = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+
+    while( true )
+    {
+        MigrationEntry& entry = migrationTable[slot & migrationTableMask];
+
+        if( entry.key == key )
+            return &entry;
+        else if( entry.key == emptyKey )
+            return NULL;
+
+        slot++;
+    }
+}
+
+
+Migrator::MigrationEntry *Migrator::InsertEntry( uint64_t key )
+{
+    assert( key != emptyKey );
+
+    /* Keep the load factor at or below one half so probes stay short. */
+    if( (migrationTableCount + 1) * 2 > migrationTable.size( ) )
+        GrowTable( );
+
+    uint64_t slot = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+
+    while( true )
+    {
+        MigrationEntry& entry = migrationTable[slot & migrationTableMask];
+
+        if( entry.key == key )
+        {
+            return &entry;
+        }
+        else if( entry.key == emptyKey )
+        {
+            entry.key = key;
+            entry.channel = 0;
+            entry.state = MIGRATION_UNKNOWN;
+            migrationTableCount++;
+
+            return &entry;
+        }
+
+        slot++;
+    }
+}
+
+
+void Migrator::GrowTable( )
+{
+    std::vector<MigrationEntry> oldTable;
+    std::vector<MigrationEntry>::iterator it;
+
+    oldTable.swap( migrationTable );
+
+    MigrationEntry empty;
+    empty.key = emptyKey;
+    empty.channel = 0;
+    empty.state = MIGRATION_UNKNOWN;
+
+    migrationTable.assign( oldTable.size( ) * 2, empty );
+    migrationTableMask = migrationTable.size( ) - 1;
+    migrationTableCount = 0;
+
+    for( it = oldTable.begin( ); it != oldTable.end( ); it++ )
+    {
+        if( it->key != emptyKey )
+            *InsertEntry( it->key ) = *it;
+    }
+}
+
+
 void Migrator::StartMigration( NVMAddress& promotee, NVMAddress& demotee )
 {
     /* 
@@ -115,50 +201,69 @@ void Migrator::StartMigration( NVMAddress& promotee, NVMAddress& demotee )
     uint64_t promokey = GetAddressKey( promotee );
     uint64_t demokey = GetAddressKey( demotee );
 
-    /* Ensure we are not already migrating a page. */
-    assert( migrating == false );
+    /* Ensure there is a free migration buffer. */
+    assert( !Migrating( ) );
 
     /*
      *  Set the new channel decodings immediately, but mark the migration
      *  as being in progress.
      */
-    migrationMap[promokey] = promoChannel;
-    migrationMap[demokey] = demoChannel;
-    migrationState[promokey] = MIGRATION_READING;
-    migrationState[demokey] = MIGRATION_READING;
+    MigrationEntry *promoEntry = InsertEntry( promokey );
+    promoEntry->channel = promoChannel;
+    promoEntry->state = MIGRATION_READING;
 
-    /*
-     *  Only one migration is allowed at a time; These values hold the
-     *  key values for each migration page and marks a migration in
-     *  progress.
-     */
-    migrating = true;
-    inputPage = promokey;
-    outputPage = demokey;
+    MigrationEntry *demoEntry = InsertEntry( demokey );
+    demoEntry->channel = demoChannel;
+    demoEntry->state = MIGRATION_READING;
+
+    /* Hold the page keys until both pages are migrated to free the buffer. */
+    activeMigrations.push_back( std::make_pair( promokey, demokey ) );
 }
 
 void Migrator::SetMigrationState( NVMAddress& address, MigratorState newState )
 {
     /* Get the key and set the new state; Ensure the state is really new. */
     uint64_t key = GetAddressKey( address );
+    MigrationEntry *entry = FindEntry( key );
+
+    assert( entry != NULL );
+    assert( entry->state != newState );
 
-    assert( migrationState.count( key ) != 0 );
-    assert( migrationState[key] != newState );
+    entry->state = newState;
 
-    migrationState[key] = newState;
+    if( newState != MIGRATION_DONE )
+        return;
 
-    /* If migration is done we can handle another migration */
-    if( migrationState[inputPage] == MIGRATION_DONE &&
-        migrationState[outputPage] == MIGRATION_DONE )
+    /* If both pages of the migration are done, its buffer is free again. */
+    std::vector<std::pair<uint64_t, uint64_t> >::iterator it;
+
+    for( it = activeMigrations.begin( ); it != activeMigrations.end( ); it++ )
     {
-        migrating = false;
+        if( it->first == key || it->second == key )
+        {
+            if( FindEntry( it->first )->state == MIGRATION_DONE 
+                && FindEntry( it->second )->state == MIGRATION_DONE )
+            {
+                activeMigrations.erase( it );
+            }
+
+            break;
+        }
     }
 }
 
 
 bool Migrator::Migrating( )
 {
-    return migrating;
+    return (activeMigrations.size( ) >= migrationBuffers);
+}
+
+
+bool Migrator::IsMigrating( NVMAddress& address )
+{
+    MigrationEntry *entry = FindEntry( GetAddressKey( address ) );
+
+    return (entry != NULL && entry->state != MIGRATION_DONE);
 }
 
 
@@ -168,16 +273,9 @@ bool Migrator::Migrating( )
  */
 bool Migrator::IsMigrated( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = FindEntry( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && migrationState[key] == MIGRATION_DONE )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && entry->state == MIGRATION_DONE);
 }
 
 
@@ -188,16 +286,10 @@ bool Migrator::IsMigrated( NVMAddress& address )
  */
 bool Migrator::IsBuffered( NVMAddress& address )
 {
-    uint64_t key = GetAddressKey( address );
-    bool rv = false;
+    MigrationEntry *entry = FindEntry( GetAddressKey( address ) );
 
-    if( migrationMap.count( key ) != 0 && migrationState.count( key ) != 0
-        && (migrationState[key] == MIGRATION_BUFFERED || migrationState[key] == MIGRATION_WRITING ) )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return (entry != NULL && (entry->state == MIGRATION_BUFFERED 
+                              || entry->state == MIGRATION_WRITING));
 }
 
 
@@ -215,14 +307,13 @@ void Migrator::Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64
     uint64_t key = GetAddressKey( keyAddress );
 
     /* Check if the page was migrated and migration is complete. */
-    if( migrationMap.count( key ) != 0 )
+    MigrationEntry *entry = FindEntry( key );
+
+    if( entry != NULL && entry->state == MIGRATION_DONE )
     {
-        if( migrationState[key] == MIGRATION_DONE )
-        {
-            *channel = migrationMap[key];
+        *channel = entry->channel;
 
-            migratedAccesses++;
-        }
+        migratedAccesses++;
     }
 }
 
@@ -249,11 +340,14 @@ void Migrator::CreateCheckpoint( std::string dir )
          *  Therefore, we assume requests have completed (i.e., there is some 
          *  draining process) and only checkpoint addresses and not state.
          */
-        std::map<uint64_t, uint64_t>::iterator it;
-        for( it = migrationMap.begin(); it != migrationMap.end(); it++ )
+        std::vector<MigrationEntry>::iterator it;
+        for( it = migrationTable.begin(); it != migrationTable.end(); it++ )
         {
-            cpt_handle.write( (const char*)&(it->first), sizeof(uint64_t) );
-            cpt_handle.write( (const char*)&(it->second), sizeof(uint64_t) );
+            if( it->key == emptyKey )
+                continue;
+
+            cpt_handle.write( (const char*)&(it->key), sizeof(uint64_t) );
+            cpt_handle.write( (const char*)&(it->channel), sizeof(uint64_t) );
         }
 
         cpt_handle.close( );
@@ -320,8 +414,10 @@ void Migrator::RestoreCheckpoint( std::string dir )
             cpt_handle.read( (char*)(&address), sizeof(uint64_t) );
             cpt_handle.read( (char*)(&channel), sizeof(uint64_t) );
 
-            std::pair<uint64_t, uint64_t> migration( address, channel );
-            migrationMap.insert( migration );
+            /* Migrations are drained before checkpointing, so they are done. */
+            MigrationEntry *entry = InsertEntry( address );
+            entry->channel = channel;
+            entry->state = MIGRATION_DONE;
         }
 
         cpt_handle.close( );
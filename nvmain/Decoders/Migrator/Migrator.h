@@ -38,6 +38,8 @@
 #include "src/Config.h"
 #include "include/NVMAddress.h"
 
+#include <vector>
+
 namespace NVM
 {
 
@@ -66,9 +68,12 @@ class Migrator : public AddressTranslator
 
     void StartMigration( NVMAddress& promotee, NVMAddress& demotee );
     void SetMigrationState( NVMAddress& address, MigratorState newState );
+    /* True if every migration buffer is in use. */
     bool Migrating( );
     bool IsBuffered( NVMAddress& address );
     bool IsMigrated( NVMAddress& address );
+    /* True if the page is part of a migration that has not completed. */
+    bool IsMigrating( NVMAddress& address );
 
     void RegisterStats( );
 
@@ -76,18 +81,36 @@ class Migrator : public AddressTranslator
     void RestoreCheckpoint( std::string dir );
 
   private:
-    std::map<uint64_t, uint64_t> migrationMap;
-    std::map<uint64_t, MigratorState> migrationState;
+    /* 
+     *  Migrated pages are kept in an open-addressing hash table with linear
+     *  probing. Pages are never removed once migrated, so no tombstones are
+     *  needed. A key of emptyKey marks an unused slot.
+     */
+    struct MigrationEntry
+    {
+        uint64_t key;
+        uint64_t channel;
+        MigratorState state;
+    };
+
+    static const uint64_t emptyKey = ~0ULL;
+
+    std::vector<MigrationEntry> migrationTable;
+    uint64_t migrationTableMask;
+    uint64_t migrationTableCount;
 
     uint64_t numChannels, numBanks, numRanks, numSubarrays;
 
-    /* Pages being swapped in and swapped out. */
-    bool migrating;
-    uint64_t inputPage, outputPage;
+    /* Pages being swapped in and swapped out, one pair per buffer. */
+    uint64_t migrationBuffers;
+    std::vector<std::pair<uint64_t, uint64_t> > activeMigrations;
 
     ncounter_t migratedAccesses;
 
     uint64_t GetAddressKey( NVMAddress& address );
+    MigrationEntry *FindEntry( uint64_t key );
+    MigrationEntry *InsertEntry( uint64_t key );
+    void GrowTable( );
 
 };
 
@@ -0,0 +1,552 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Decoders/StartGap/StartGap.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace NVM;
+
+StartGap::StartGap( )
+{
+    numChannels = numRanks = numBanks = numSubarrays = 1;
+    rowsPerSubarray = rowsPerBank = 0;
+    regionRows = regionLines = regionsPerBank = 0;
+    visibleRows = 0;
+    moveInterval = 100;
+
+    randomize = false;
+    randomMultiplier = randomInverse = 1;
+    randomOffset = 0;
+
+    moving = false;
+    movingRegion = 0;
+    movingSource = 0;
+    owedMoves = 0;
+
+    maxLogicalWrites = 0;
+    maxPhysicalWrites = 0;
+
+    demandWrites = 0;
+    outOfRangeWrites = 0;
+    gapMoves = 0;
+    gapRotations = 0;
+    gapMoveOverhead = 0.0;
+    enduranceGain = 0.0;
+}
+
+
+StartGap::~StartGap( )
+{
+
+}
+
+
+/* Returns the inverse of value modulo modulus, or 0 if there is none. */
+static uint64_t ModularInverse( uint64_t value, uint64_t modulus )
+{
+    int64_t t = 0, newT = 1;
+    int64_t r = static_cast<int64_t>( modulus );
+    int64_t newR = static_cast<int64_t>( value % modulus );
+
+    while( newR != 0 )
+    {
+        int64_t quotient = r / newR;
+        int64_t tmp;
+
+        tmp = t - quotient * newT; t = newT; newT = tmp;
+        tmp = r - quotient * newR; r = newR; newR = tmp;
+    }
+
+    if( r != 1 )
+        return 0;
+
+    if( t < 0 )
+        t += static_cast<int64_t>( modulus );
+
+    return static_cast<uint64_t>( t );
+}
+
+
+void StartGap::SetConfig( Config *config, bool /*createChildren*/ )
+{
+    /* Cache the geometry, since GetValue is slow during simulation. */
+    numChannels = config->GetValue( "CHANNELS" );
+    numRanks = config->GetValue( "RANKS" );
+    numBanks = config->GetValue( "BANKS" );
+    rowsPerBank = config->GetValue( "ROWS" );
+
+    if( config->KeyExists( "MATHeight" ) )
+        rowsPerSubarray = config->GetValue( "MATHeight" );
+    else
+        rowsPerSubarray = rowsPerBank;
+
+    numSubarrays = rowsPerBank / rowsPerSubarray;
+
+    config->GetValueUL( "StartGapInterval", moveInterval );
+
+    regionRows = rowsPerBank;
+    config->GetValueUL( "StartGapRegionRows", regionRows );
+
+    if( regionRows < 2 || rowsPerBank % regionRows != 0 )
+    {
+        std::cout << "StartGap: StartGapRegionRows must be at least 2 and divide "
+                  << "the " << rowsPerBank << " rows of a bank. Using one region "
+                  << "per bank." << std::endl;
+        regionRows = rowsPerBank;
+    }
+
+    regionsPerBank = rowsPerBank / regionRows;
+
+    /* One row of each region is always the gap and is not addressable. */
+    regionLines = regionRows - 1;
+    visibleRows = regionsPerBank * regionLines;
+
+    if( config->KeyExists( "StartGapRandomize" ) )
+        randomize = config->GetBool( "StartGapRandomize" );
+
+    /* A single addressable row has nothing to shuffle. */
+    if( visibleRows < 2 )
+        randomize = false;
+
+    if( randomize )
+    {
+        uint64_t seed = 1;
+        config->GetValueUL( "StartGapSeed", seed );
+
+        /* Any multiplier coprime to the row count gives a bijection. */
+        randomMultiplier = ((seed * 0x9E3779B97F4A7C15ULL) % visibleRows) | 1;
+        while( ModularInverse( randomMultiplier, visibleRows ) == 0 )
+            randomMultiplier = (randomMultiplier + 1) % visibleRows;
+
+        randomInverse = ModularInverse( randomMultiplier, visibleRows );
+        randomOffset = (seed * 0xC2B2AE3D27D4EB4FULL) % visibleRows;
+    }
+
+    /* The gap starts out as the last row of each region. */
+    RegionState initial;
+    initial.start = 0;
+    initial.gap = regionLines;
+    initial.writes = 0;
+    initial.pendingMoves = 0;
+
+    regions.assign( numChannels * numRanks * numBanks * regionsPerBank, initial );
+}
+
+
+void StartGap::RegisterStats( )
+{
+    AddStat(demandWrites);
+    AddStat(outOfRangeWrites);
+    AddStat(gapMoves);
+    AddStat(gapRotations);
+    AddStat(gapMoveOverhead);
+    AddStat(enduranceGain);
+}
+
+
+void StartGap::CalculateStats( )
+{
+    gapMoveOverhead = 0.0;
+    enduranceGain = 0.0;
+
+    if( demandWrites != 0 )
+        gapMoveOverhead = static_cast<double>( gapMoves ) 
+                        / static_cast<double>( demandWrites );
+
+    /* Without leveling, the hottest row would take all of its writes. */
+    if( maxPhysicalWrites != 0 )
+        enduranceGain = static_cast<double>( maxLogicalWrites )
+                      / static_cast<double>( maxPhysicalWrites );
+}
+
+
+uint64_t StartGap::GetBankKey( uint64_t bank, uint64_t rank, uint64_t channel )
+{
+    assert( channel < numChannels && rank < numRanks && bank < numBanks );
+
+    return (channel * numRanks + rank) * numBanks + bank;
+}
+
+
+uint64_t StartGap::RandomizeRow( uint64_t bankRow )
+{
+    return (bankRow * randomMultiplier + randomOffset) % visibleRows;
+}
+
+
+uint64_t StartGap::UnrandomizeRow( uint64_t shuffledRow )
+{
+    return ((shuffledRow + visibleRows - randomOffset) % visibleRows) 
+           * randomInverse % visibleRows;
+}
+
+
+/*
+ *  Returns the logical row a row of the bank is shuffled to. Rows past the
+ *  addressable rows wrap around, as addresses past the memory size do.
+ */
+uint64_t StartGap::ShuffleRow( uint64_t bankRow )
+{
+    bankRow %= visibleRows;
+
+    return randomize ? RandomizeRow( bankRow ) : bankRow;
+}
+
+
+/*
+ *  Maps a row of a bank to the row it is stored in. Rows are numbered
+ *  across the subarrays of the bank.
+ */
+uint64_t StartGap::MapRow( uint64_t bankKey, uint64_t bankRow )
+{
+    uint64_t shuffledRow = ShuffleRow( bankRow );
+    uint64_t region = shuffledRow / regionLines;
+    uint64_t offset = shuffledRow % regionLines;
+
+    RegionState& state = regions[bankKey * regionsPerBank + region];
+    uint64_t physicalRow = (offset + state.start) % regionLines;
+
+    if( physicalRow >= state.gap )
+        physicalRow++;
+
+    return region * regionRows + physicalRow;
+}
+
+
+void StartGap::Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank,
+                          uint64_t *rank, uint64_t *channel, uint64_t *subarray )
+{
+    AddressTranslator::Translate( address, row, col, bank, rank, channel, subarray );
+
+    uint64_t bankKey = GetBankKey( *bank, *rank, *channel );
+    uint64_t physicalRow = MapRow( bankKey, *subarray * rowsPerSubarray + *row );
+
+    *row = physicalRow % rowsPerSubarray;
+    *subarray = physicalRow / rowsPerSubarray;
+}
+
+
+void StartGap::CountPhysicalWrite( uint64_t bankKey, uint64_t bankRow )
+{
+    uint32_t& writes = physicalWrites[bankKey * rowsPerBank + bankRow];
+
+    writes++;
+
+    if( writes > maxPhysicalWrites )
+        maxPhysicalWrites = writes;
+}
+
+
+bool StartGap::RecordWrite( uint64_t address )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+    bool rv = false;
+
+    AddressTranslator::Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+
+    uint64_t bankKey = GetBankKey( bank, rank, channel );
+    uint64_t bankRow = subarray * rowsPerSubarray + row;
+
+    /* Only allocate the write counters once writes are seen. */
+    if( logicalWrites.empty( ) )
+    {
+        logicalWrites.assign( numChannels * numRanks * numBanks * rowsPerBank, 0 );
+        physicalWrites.assign( numChannels * numRanks * numBanks * rowsPerBank, 0 );
+    }
+
+    uint32_t& writes = logicalWrites[bankKey * rowsPerBank + bankRow];
+
+    writes++;
+
+    if( writes > maxLogicalWrites )
+        maxLogicalWrites = writes;
+
+    CountPhysicalWrite( bankKey, MapRow( bankKey, bankRow ) );
+
+    demandWrites++;
+
+    if( bankRow >= visibleRows )
+        outOfRangeWrites++;
+
+    uint64_t regionKey = bankKey * regionsPerBank + ShuffleRow( bankRow ) / regionLines;
+    RegionState& state = regions[regionKey];
+
+    state.writes++;
+
+    if( state.writes >= moveInterval )
+    {
+        state.writes = 0;
+        owedMoves++;
+
+        /* Each region is queued once, however many moves it is owed. */
+        if( state.pendingMoves++ == 0 )
+            pendingMoves.push_back( regionKey );
+
+        rv = true;
+    }
+
+    return rv;
+}
+
+
+bool StartGap::GapMovePending( )
+{
+    return (!moving && !pendingMoves.empty( ));
+}
+
+
+bool StartGap::Moving( )
+{
+    return moving;
+}
+
+
+bool StartGap::IsMovingRow( uint64_t address )
+{
+    if( !moving )
+        return false;
+
+    uint64_t row, col, bank, rank, channel, subarray;
+    uint64_t srcRow, srcCol, srcBank, srcRank, srcChannel, srcSubarray;
+
+    AddressTranslator::Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+    AddressTranslator::Translate( movingSource, &srcRow, &srcCol, &srcBank, 
+                                  &srcRank, &srcChannel, &srcSubarray );
+
+    return (row == srcRow && subarray == srcSubarray && bank == srcBank 
+            && rank == srcRank && channel == srcChannel);
+}
+
+
+uint64_t StartGap::GetOwedMoves( )
+{
+    return owedMoves;
+}
+
+
+uint64_t StartGap::GetGapMoveSource( )
+{
+    assert( !pendingMoves.empty( ) );
+
+    uint64_t regionKey = pendingMoves.front( );
+    RegionState& state = regions[regionKey];
+
+    /* The row below the gap moves up, or the last row wraps to the first. */
+    uint64_t sourceRow = (state.gap == 0) ? regionLines : state.gap - 1;
+    uint64_t packedRow = (sourceRow > state.gap) ? sourceRow - 1 : sourceRow;
+    uint64_t offset = (packedRow + regionLines - state.start) % regionLines;
+
+    uint64_t shuffledRow = (regionKey % regionsPerBank) * regionLines + offset;
+    uint64_t bankRow = randomize ? UnrandomizeRow( shuffledRow ) : shuffledRow;
+
+    uint64_t bankKey = regionKey / regionsPerBank;
+    uint64_t bank = bankKey % numBanks;
+    uint64_t rank = (bankKey / numBanks) % numRanks;
+    uint64_t channel = bankKey / (numBanks * numRanks);
+
+    return ReverseTranslate( bankRow % rowsPerSubarray, 0, bank, rank, channel, 
+                             bankRow / rowsPerSubarray );
+}
+
+
+void StartGap::StartGapMove( )
+{
+    assert( !moving && !pendingMoves.empty( ) );
+
+    moving = true;
+    movingSource = GetGapMoveSource( );
+    movingRegion = pendingMoves.front( );
+    pendingMoves.pop_front( );
+    owedMoves--;
+
+    /* Regions that still owe moves go to the back of the line. */
+    if( --regions[movingRegion].pendingMoves != 0 )
+        pendingMoves.push_back( movingRegion );
+}
+
+
+void StartGap::TranslateToGap( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank,
+                               uint64_t *rank, uint64_t *channel, uint64_t *subarray )
+{
+    assert( moving );
+
+    AddressTranslator::Translate( address, row, col, bank, rank, channel, subarray );
+
+    uint64_t physicalRow = (movingRegion % regionsPerBank) * regionRows 
+                         + regions[movingRegion].gap;
+
+    *row = physicalRow % rowsPerSubarray;
+    *subarray = physicalRow / rowsPerSubarray;
+}
+
+
+void StartGap::MoveGap( )
+{
+    assert( moving );
+
+    RegionState& state = regions[movingRegion];
+    uint64_t destinationRow = state.gap;
+
+    if( state.gap == 0 )
+    {
+        /* Every row has shifted once; start over from the top. */
+        state.gap = regionLines;
+        state.start = (state.start + 1) % regionLines;
+
+        gapRotations++;
+    }
+    else
+    {
+        state.gap--;
+    }
+
+    CountPhysicalWrite( movingRegion / regionsPerBank, 
+                        (movingRegion % regionsPerBank) * regionRows + destinationRow );
+
+    gapMoves++;
+}
+
+
+void StartGap::FinishGapMove( )
+{
+    assert( moving );
+
+    moving = false;
+}
+
+
+void StartGap::CreateCheckpoint( std::string dir )
+{
+    std::stringstream cpt_file;
+    cpt_file.str("");
+    cpt_file << dir << "/" << StatName( );
+
+    std::ofstream cpt_handle;
+
+    cpt_handle.open( cpt_file.str().c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << StatName( ) << ": Warning: Could not open checkpoint file: "
+                  << cpt_file.str() << std::endl;
+    }
+    else
+    {
+        /* 
+         *  Gap moves in flight are not checkpointed. As with the Migrator, we
+         *  assume the memory is drained and only save each region's mapping.
+         */
+        std::vector<RegionState>::iterator it;
+        for( it = regions.begin(); it != regions.end(); it++ )
+        {
+            cpt_handle.write( (const char*)&(it->start), sizeof(uint64_t) );
+            cpt_handle.write( (const char*)&(it->gap), sizeof(uint64_t) );
+            cpt_handle.write( (const char*)&(it->writes), sizeof(uint64_t) );
+        }
+
+        cpt_handle.close( );
+
+        /* Write checkpoint information. */
+        /* Note: For future compatability only at the memory. This is not read during restoration. */
+        std::string cpt_info = cpt_file.str() + ".json";
+
+        cpt_handle.open( cpt_info.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary );
+
+        if( !cpt_handle.is_open() )
+        {
+            std::cout << StatName( ) << ": Warning: Could not open checkpoint " 
+                      << "info file: " << cpt_info << std::endl;
+        }
+        else
+        {
+            std::string cpt_info_str = "{\n\t\"Version\": 1\n}";
+            cpt_handle.write( cpt_info_str.c_str(), cpt_info_str.length() ); 
+
+            cpt_handle.close();
+        }
+    }
+}
+
+
+void StartGap::RestoreCheckpoint( std::string dir )
+{
+    std::stringstream cpt_file;
+    cpt_file.str("");
+    cpt_file << dir << "/" << StatName( );
+
+    std::ifstream cpt_handle;
+
+    cpt_handle.open( cpt_file.str().c_str(), std::ifstream::ate | std::ofstream::binary );
+
+    if( !cpt_handle.is_open() )
+    {
+        std::cout << StatName( ) << ": Warning: Could not open checkpoint file: "
+                  << cpt_file.str() << std::endl;
+    }
+    else
+    {
+        std::streampos cpt_size = cpt_handle.tellg( );
+        uint64_t expectedSize = regions.size( ) * sizeof(uint64_t) * 3;
+
+        cpt_handle.close( );
+
+        /* The region layout depends on the configuration, so it must match. */
+        if( static_cast<uint64_t>( cpt_size ) != expectedSize )
+        {
+            std::cout << StatName( ) << ": Warning: Expected checkpoint size to be "
+                      << expectedSize << " for this configuration. Ignoring checkpoint."
+                      << std::endl;
+            return;
+        }
+
+        cpt_handle.open( cpt_file.str().c_str(), std::ifstream::in | std::ifstream::binary );
+
+        std::vector<RegionState>::iterator it;
+        for( it = regions.begin(); it != regions.end(); it++ )
+        {
+            cpt_handle.read( (char*)(&it->start), sizeof(uint64_t) );
+            cpt_handle.read( (char*)(&it->gap), sizeof(uint64_t) );
+            cpt_handle.read( (char*)(&it->writes), sizeof(uint64_t) );
+            it->pendingMoves = 0;
+        }
+
+        pendingMoves.clear( );
+        owedMoves = 0;
+
+        cpt_handle.close( );
+    }
+}
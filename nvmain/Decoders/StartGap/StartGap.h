@@ -0,0 +1,161 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_STARTGAP_H__
+#define __NVMAIN_STARTGAP_H__
+
+#include "src/AddressTranslator.h"
+#include "src/Config.h"
+#include "include/NVMAddress.h"
+
+#include <deque>
+#include <vector>
+
+namespace NVM
+{
+
+/*
+ *  Start-Gap wear leveling (Qureshi et al., MICRO 2009). The rows of each
+ *  bank are split into regions of StartGapRegionRows rows. One row of each
+ *  region is the gap and holds no data. After every StartGapInterval writes
+ *  to a region, the row next to the gap is copied into it, moving the gap by
+ *  one. Each time the gap wraps around, every row in the region has shifted
+ *  by one, so the write traffic rotates over all rows of the region.
+ *
+ *  A region of N+1 rows holds N logical rows, so one row of every region is
+ *  not addressable. The addressable rows of a bank are the first
+ *  (StartGapRegionRows - 1) * regions rows. Rows past them wrap around, the
+ *  same way addresses past the memory size do, and writes to them are
+ *  counted in outOfRangeWrites.
+ *
+ *  With StartGapRandomize, rows of a bank are shuffled by a fixed bijection
+ *  before being split into regions, so hot rows that are close together do
+ *  not land in the same region.
+ *
+ *  The translator only holds the mapping. The GapMover hook issues the
+ *  read and write that move each gap through the memory controller.
+ */
+class StartGap : public AddressTranslator
+{
+  public:
+    StartGap( );
+    ~StartGap( );
+
+    void SetConfig( Config *config, bool createChildren = true );
+
+    virtual void Translate( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank, 
+                            uint64_t *rank, uint64_t *channel, uint64_t *subarray );
+    using AddressTranslator::Translate;
+
+    /* Counts a demand write. Returns true if this made a gap move due. */
+    bool RecordWrite( uint64_t address );
+
+    /* 
+     *  True if a gap move is due and no other move is in progress. Moves
+     *  owed by the same region are coalesced into one queue entry.
+     */
+    bool GapMovePending( );
+    /* 
+     *  Address of the row to copy for the next gap move. The same address
+     *  refers to the row's new location once MoveGap is called.
+     */
+    uint64_t GetGapMoveSource( );
+    void StartGapMove( );
+    /* Translates an address of the row being copied to the gap it is written to. */
+    void TranslateToGap( uint64_t address, uint64_t *row, uint64_t *col, uint64_t *bank,
+                         uint64_t *rank, uint64_t *channel, uint64_t *subarray );
+    /* Remaps the row being copied into the gap. Call once the copy is written. */
+    void MoveGap( );
+    void FinishGapMove( );
+    bool Moving( );
+    /* True if a move is in flight and the address is in the row being copied. */
+    bool IsMovingRow( uint64_t address );
+    /* Number of gap moves that are due but not started. */
+    uint64_t GetOwedMoves( );
+
+    void RegisterStats( );
+    void CalculateStats( );
+
+    void CreateCheckpoint( std::string dir );
+    void RestoreCheckpoint( std::string dir );
+
+  private:
+    struct RegionState
+    {
+        uint64_t start;
+        uint64_t gap;
+        uint64_t writes;
+        uint64_t pendingMoves;
+    };
+
+    uint64_t numChannels, numRanks, numBanks, numSubarrays;
+    uint64_t rowsPerSubarray, rowsPerBank;
+    uint64_t regionRows, regionLines, regionsPerBank;
+    uint64_t visibleRows;
+    uint64_t moveInterval;
+
+    bool randomize;
+    uint64_t randomMultiplier, randomInverse, randomOffset;
+
+    std::vector<RegionState> regions;
+    std::deque<uint64_t> pendingMoves;
+    bool moving;
+    uint64_t movingRegion;
+    uint64_t movingSource;
+    uint64_t owedMoves;
+
+    /* Writes per row before and after remapping, to estimate the gain. */
+    std::vector<uint32_t> logicalWrites;
+    std::vector<uint32_t> physicalWrites;
+    uint64_t maxLogicalWrites, maxPhysicalWrites;
+
+    ncounter_t demandWrites;
+    ncounter_t outOfRangeWrites;
+    ncounter_t gapMoves;
+    ncounter_t gapRotations;
+    double gapMoveOverhead;
+    double enduranceGain;
+
+    uint64_t GetBankKey( uint64_t bank, uint64_t rank, uint64_t channel );
+    uint64_t RandomizeRow( uint64_t bankRow );
+    uint64_t UnrandomizeRow( uint64_t shuffledRow );
+    uint64_t ShuffleRow( uint64_t bankRow );
+    uint64_t MapRow( uint64_t bankKey, uint64_t bankRow );
+    void CountPhysicalWrite( uint64_t bankKey, uint64_t bankRow );
+};
+
+
+};
+
+
+#endif
@@ -44,7 +44,7 @@ BitModel::BitModel( )
      *  happen to be allocated somewhere that thinks it contains 
      *  values.
      */
-    life.clear( );
+    life.Clear( );
 
     SetGranularity( 1 );
 }
@@ -64,6 +64,11 @@ void BitModel::SetConfig( Config *config, bool createChildren )
     SetParams( params );
 
     EnduranceModel::SetConfig( config, createChildren );
+
+    /* One page holds the bits of one word. */
+    uint64_t wordSize = p->BusWidth * p->tBURST * p->RATE / 8;
+    life.SetPageSize( wordSize * 8 );
+    life.SetPartitionCount( p->MATHeight * p->COLS * wordSize * 8 );
 }
 
 ncycles_t BitModel::Read( NVMainRequest *request )
@@ -85,29 +90,19 @@ ncycles_t BitModel::Read( NVMainRequest *request )
 
     rowSize = p->COLS * wordSize; 
     
+    /*
+     *  Think of each row being partitioned into 1-bit divisions. 
+     *  Each row has rowSize * 8 paritions. For the key we will use:
+     *
+     *  row * number of partitions + partition in this row
+     */
+    partitionCount = rowSize * 8;
+    
+    wordkey = row * partitionCount + (col * wordSize * 8);
+
     /* Check each bit to see if it is dead */
-    for( uint64_t i = 0; i < wordSize; ++i )
-    {
-        for( int j = 0; j < 8; j++ )
-        {
-            /*
-             *  Think of each row being partitioned into 1-bit divisions. 
-             *  Each row has rowSize * 8 paritions. For the key we will use:
-             *
-             *  row * number of partitions + partition in this row
-             */
-            partitionCount = rowSize * 8;
-            
-            wordkey = row * partitionCount 
-                             + (col * wordSize * 8) + i * 8 + j;
-
-            if( IsDead( wordkey ) )
-            {
-                rv = -(rv + 1);
-                return rv;
-            }
-        }
-    }
+    if( life.AnyDead( wordkey, wordSize * 8 ) )
+        rv = -(rv + 1);
 
     return rv;
 }
@@ -117,23 +112,12 @@ ncycles_t BitModel::Write( NVMainRequest *request, NVMDataBlock& oldData )
     NVMDataBlock& newData = request->data;
     NVMAddress& address = request->address;
 
-    /*
-     *  The default life map is an stl map< uint64_t, uint64_t >. 
-     *  You may map row and col to this map_key however you want.
-     *  It is up to you to ensure there are no collisions here.
-     */
     uint64_t row;
     uint64_t col;
     ncycles_t rv = 0;
 
     address.GetTranslatedAddress( &row, &col, NULL, NULL, NULL, NULL );
     
-    /*
-     *  If using the default life map, we can call the DecrementLife
-     *  function which will check if the map_key already exists. If so,
-     *  the life value is decremented (write count incremented). Otherwise 
-     *  the map_key is inserted with a write count of 1.
-     */
     uint64_t wordkey;
     uint64_t rowSize;
     uint64_t wordSize;
@@ -145,55 +129,51 @@ ncycles_t BitModel::Write( NVMainRequest *request, NVMDataBlock& oldData )
 
     rowSize = p->COLS * wordSize; 
 
-    /* Check each byte to see if it was modified */
-    for( uint64_t i = 0; i < wordSize; ++i )
-    {
-        /*
-         *  If no bytes have changed we can just continue. Yes, I know this
-         *  will check the byte 8 times, but i'd rather not change the iter.
-         */
-        uint8_t oldByte, newByte;
-
-        oldByte = oldData.GetByte( i );
-        newByte = newData.GetByte( i );
-
-        if( oldByte == newByte ) 
-            continue;
-
-        /*
-         *  If the bytes are different, then at least one bit has changed.
-         *  check each bit individually.
-         */
-        for( int j = 0; j < 8; j++ )
-        {
-            uint8_t oldBit, newBit;
-
-            oldBit = ( oldByte >> j ) & 0x1;
-            newBit = ( newByte >> j ) & 0x1;
-
-            if( oldBit == newBit )
-                continue;
+    /*
+     *  Build a mask of the changed bits, 64 at a time. Bit j of byte i is
+     *  bit (i * 8 + j) of the mask, matching the partition order below.
+     */
+    changedBits.assign( (wordSize + 7) / 8, 0 );
 
-            //std::cout << "Bit " << j << " changed in byte " << i << std::endl;
+    if( oldData.IsValid( ) && newData.IsValid( ) 
+        && oldData.GetSize( ) >= wordSize && newData.GetSize( ) >= wordSize )
+    {
+        const uint8_t *oldBytes = oldData.rawData;
+        const uint8_t *newBytes = newData.rawData;
 
-            /*
-             *  Think of each row being partitioned into 1-bit divisions. 
-             *  Each row has rowSize * 8 paritions. For the key we will use:
-             *
-             *  row * number of partitions + partition in this row
-             */
-            partitionCount = rowSize * 8;
-            
-            wordkey = row * partitionCount 
-                             + (col * wordSize * 8) + i * 8 + j;
+        for( uint64_t i = 0; i < wordSize; ++i )
+        {
+            uint64_t changed = oldBytes[i] ^ newBytes[i];
 
-            //std::cout << "Key is " << wordkey << std::endl;
+            changedBits[i / 8] |= changed << ((i % 8) * 8);
+        }
+    }
+    else
+    {
+        for( uint64_t i = 0; i < wordSize; ++i )
+        {
+            uint64_t changed = oldData.GetByte( i ) ^ newData.GetByte( i );
 
-            if( !DecrementLife( wordkey ) )
-                rv = -1;
+            changedBits[i / 8] |= changed << ((i % 8) * 8);
         }
     }
 
+    /*
+     *  Think of each row being partitioned into 1-bit divisions. 
+     *  Each row has rowSize * 8 paritions. For the key we will use:
+     *
+     *  row * number of partitions + partition in this row
+     */
+    partitionCount = rowSize * 8;
+    
+    wordkey = row * partitionCount + (col * wordSize * 8);
+
+    /*
+     *  Each changed bit decrements its life. Bits written for the first
+     *  time are assigned a life from the endurance distribution.
+     */
+    if( !life.DecrementMask( wordkey, &changedBits[0], wordSize * 8 ) )
+        rv = -1;
+
     return rv;
 }
-
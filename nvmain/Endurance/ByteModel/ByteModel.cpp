@@ -44,7 +44,7 @@ ByteModel::ByteModel( )
      *  happen to be allocated somewhere that thinks it contains 
      *  values.
      */
-    life.clear( );
+    life.Clear( );
 
     SetGranularity( 8 );
 }
@@ -64,6 +64,11 @@ void ByteModel::SetConfig( Config *config, bool createChildren )
     SetParams( params );
 
     EnduranceModel::SetConfig( config, createChildren );
+
+    /* One page holds the bytes of one word. */
+    uint64_t wordSize = p->BusWidth * p->tBURST * p->RATE / 8;
+    life.SetPageSize( wordSize );
+    life.SetPartitionCount( p->MATHeight * p->COLS * wordSize );
 }
 
 ncycles_t ByteModel::Read( NVMainRequest *request ) 
@@ -90,53 +95,34 @@ ncycles_t ByteModel::Read( NVMainRequest *request )
     /* Size of a row in bytes */
     rowSize = p->COLS * wordSize;
 
-    /* Check each byte to see if it was modified */
-    for( int i = (int)wordSize - 1; i >= 0; --i )
-    {
-        /*
-         *  Think of each row being partitioned into 8-bit divisions. Each 
-         *  row has rowSize / 8 paritions. For the key we will use:
-         *
-         *  row * number of partitions + partition in this row
-         */
-        partitionCount = ( rowSize / 8 );
-
-        wordkey = row * partitionCount + col * wordSize + i;
+    /*
+     *  Think of each row being partitioned into 8-bit divisions. Each 
+     *  row has rowSize paritions. For the key we will use:
+     *
+     *  row * number of partitions + partition in this row
+     */
+    partitionCount = rowSize;
+
+    wordkey = row * partitionCount + col * wordSize;
       
-        if( IsDead( wordkey ) )
-        {
-            rv = -(rv + 1);  
-            return rv;
-        }
-    }
+    /* Check each byte to see if it is dead */
+    if( life.AnyDead( wordkey, wordSize ) )
+        rv = -(rv + 1);  
 
     return rv;
 }
+
 ncycles_t ByteModel::Write( NVMainRequest *request, NVMDataBlock& oldData ) 
 {
     NVMDataBlock& newData = request->data;
-    NVMAddress address = request->address;
+    NVMAddress& address = request->address;
 
-    /*
-     *  The default life map is an stl map< uint64_t, uint64_t >. 
-     *  You may map row and col to this map_key however you want.
-     *  It is up to you to ensure there are no collisions here.
-     */
     uint64_t row;
     uint64_t col;
     ncycles_t rv = 0;
 
-    /*
-     *  For our simple row model, we just set the key equal to the row.
-     */
     address.GetTranslatedAddress( &row, &col, NULL, NULL, NULL, NULL );
     
-    /*
-     *  If using the default life map, we can call the DecrementLife
-     *  function which will check if the map_key already exists. If so,
-     *  the life value is decremented (write count incremented). Otherwise 
-     *  the map_key is inserted with a write count of 1.
-     */
     uint64_t wordkey;
     uint64_t rowSize;
     uint64_t wordSize;
@@ -153,31 +139,27 @@ ncycles_t ByteModel::Write( NVMainRequest *request, NVMDataBlock& oldData )
     /* Size of a row in bytes */
     rowSize = p->COLS * wordSize;
 
-    /* Check each byte to see if it was modified */
-    for( int i = (int)wordSize - 1; i >= 0; --i )
-    {
-        uint8_t oldByte, newByte;
+    /* Mark each byte that was modified. */
+    changedBytes.assign( (wordSize + 63) / 64, 0 );
 
-        oldByte = oldData.GetByte( i );
-        newByte = newData.GetByte( i );
-
-        if( oldByte == newByte ) 
-            continue;
+    for( uint64_t i = 0; i < wordSize; ++i )
+    {
+        if( oldData.GetByte( i ) != newData.GetByte( i ) ) 
+            changedBytes[i / 64] |= (1ULL << (i % 64));
+    }
 
-        /*
-         *  Think of each row being partitioned into 8-bit divisions. Each 
-         *  row has rowSize / 8 paritions. For the key we will use:
-         *
-         *  row * number of partitions + partition in this row
-         */
-        partitionCount = ( rowSize / 8 );
+    /*
+     *  Think of each row being partitioned into 8-bit divisions. Each 
+     *  row has rowSize paritions. For the key we will use:
+     *
+     *  row * number of partitions + partition in this row
+     */
+    partitionCount = rowSize;
 
-        wordkey = row * partitionCount + col * wordSize + i;
+    wordkey = row * partitionCount + col * wordSize;
       
-        if( !DecrementLife( wordkey ) )
-            rv = -1;  
-    }
+    if( !life.DecrementMask( wordkey, &changedBytes[0], wordSize ) )
+        rv = -1;  
 
     return rv;
 }
-
@@ -36,6 +36,8 @@
 
 #include "src/EnduranceModel.h"
 
+#include <vector>
+
 namespace NVM {
 
 class ByteModel : public EnduranceModel
@@ -49,6 +51,8 @@ class ByteModel : public EnduranceModel
     ncycles_t Read( NVMainRequest *request );
     ncycles_t Write( NVMainRequest *request, NVMDataBlock& oldData );
 
+  private:
+    std::vector<uint64_t> changedBytes;
 };
 
 };
@@ -32,6 +32,7 @@
 *******************************************************************************/
 
 #include "Endurance/Distributions/Normal.h"
+#include "src/ConfigSchema.h"
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
@@ -41,13 +42,18 @@ using namespace NVM;
 NormalDistribution::NormalDistribution( )
 {
     nextEndurance = 0.0f;
+    seed = 1;
 }
 
 NormalDistribution::NormalDistribution( Config *conf )
 {
+    /* Resolved once, since every subarray has a distribution. */
+    static const ConfigKey meanKey( "EnduranceDistMean" );
+    static const ConfigKey varianceKey( "EnduranceDistVariance" );
+
     config = conf;
 
-    if( conf->GetValue( "EnduranceDistMean" ) == -1 )
+    if( conf->GetValue( meanKey ) == -1 )
     {
         std::cout << "EnduranceDistMean parameter not found for normal \
             distribution!!\n";
@@ -55,11 +61,11 @@ NormalDistribution::NormalDistribution( Config *conf )
     }
     else
     {
-        mean = conf->GetValue( "EnduranceDistMean" );
+        mean = conf->GetValue( meanKey );
     }
 
 
-    if( conf->GetValue( "EnduranceDistVariance" ) == -1 )
+    if( conf->GetValue( varianceKey ) == -1 )
     {
         std::cout << "EnduranceDistVariance parameter not found for normal \
             distribution!!\n";
@@ -67,10 +73,11 @@ NormalDistribution::NormalDistribution( Config *conf )
     }
     else
     {
-        variance = conf->GetValue( "EnduranceDistVariance" );
+        variance = conf->GetValue( varianceKey );
     }
 
     nextEndurance = 0.0f;
+    seed = 1;
 }
 
 uint64_t NormalDistribution::GetEndurance( )
@@ -93,14 +100,16 @@ uint64_t NormalDistribution::GetEndurance( )
     }
 
     /*
-     *  rand() is a uniform distribution. Use the Box-Muller method to
-     *  convert the output from rand() to a normal distribution.
+     *  rand_r() is a uniform distribution. Use the Box-Muller method to
+     *  convert the output from rand_r() to a normal distribution. Each
+     *  distribution keeps its own seed so that simulations running in
+     *  parallel threads do not share (and race on) the global rand() state.
      */
     w = 2.0f;
     while( w >= 1.0f )
     {
-        x1 = 2.0 * ( (double)(rand( ) % 1000000) / 1000000.0f ) - 1.0f;
-        x2 = 2.0 * ( (double)(rand( ) % 1000000) / 1000000.0f ) - 1.0f;
+        x1 = 2.0 * ( (double)(::rand_r( &seed ) % 1000000) / 1000000.0f ) - 1.0f;
+        x2 = 2.0 * ( (double)(::rand_r( &seed ) % 1000000) / 1000000.0f ) - 1.0f;
         w = x1 * x1 + x2 * x2;
     }
 
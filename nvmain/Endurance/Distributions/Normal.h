@@ -46,6 +46,7 @@ class NormalDistribution : public EnduranceDistribution
     ~NormalDistribution( ) { }
 
     uint64_t GetEndurance( );
+    void SetSeed( unsigned int s ) { seed = s; }
 
     void SetMean( uint64_t m ) { mean = m; }
     void SetVariance( uint64_t var ) { variance = var; }
@@ -59,6 +60,7 @@ class NormalDistribution : public EnduranceDistribution
     uint64_t mean;
     uint64_t variance;
     double nextEndurance;
+    unsigned int seed;
 };
 
 };
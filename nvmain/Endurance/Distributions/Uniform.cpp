@@ -32,6 +32,7 @@
 *******************************************************************************/
 
 #include "Endurance/Distributions/Uniform.h"
+#include "src/ConfigSchema.h"
 #include <math.h>
 #include <iostream>
 
@@ -39,10 +40,13 @@ using namespace NVM;
 
 UniformDistribution::UniformDistribution( Config *conf )
 {
+    /* Resolved once, since every subarray has a distribution. */
+    static const ConfigKey meanKey( "EnduranceDistMean" );
+
     config = conf;
 
 
-    if( conf->GetValue( "EnduranceDistMean" ) == -1 )
+    if( conf->GetValue( meanKey ) == -1 )
     {
         std::cout << "EnduranceDistMean parameter not found for normal \
             distribution!!\n";
@@ -50,7 +54,7 @@ UniformDistribution::UniformDistribution( Config *conf )
     }
     else
     {
-        mean = conf->GetValue( "EnduranceDistMean" );
+        mean = conf->GetValue( meanKey );
     }
 }
 
@@ -46,6 +46,8 @@ class NullModel : public EnduranceModel
 
     ncycles_t Read( NVMainRequest *request );
     ncycles_t Write( NVMainRequest *request, NVMDataBlock& oldData );
+
+    bool UsesLifeStore( ) { return false; }
 };
 
 };
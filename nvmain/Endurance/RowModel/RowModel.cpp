@@ -43,7 +43,7 @@ RowModel::RowModel( )
      *  happen to be allocated somewhere that thinks it contains 
      *  values.
      */
-    life.clear( );
+    life.Clear( );
 }
 
 RowModel::~RowModel( )
@@ -63,6 +63,8 @@ void RowModel::SetConfig( Config *conf, bool createChildren )
     SetGranularity( p->COLS * 8 );
 
     EnduranceModel::SetConfig( conf, createChildren );
+
+    life.SetPartitionCount( p->MATHeight );
 }
 
 ncycles_t RowModel::Read( NVMainRequest *request )
@@ -44,7 +44,7 @@ WordModel::WordModel( )
      *  happen to be allocated somewhere that thinks it contains 
      *  values.
      */
-    life.clear( );
+    life.Clear( );
 }
 
 WordModel::~WordModel( )
@@ -64,6 +64,10 @@ void WordModel::SetConfig( Config *config, bool createChildren )
     SetGranularity( p->BusWidth * 8 );
 
     EnduranceModel::SetConfig( config, createChildren );
+
+    /* Rows are often written sparsely, so use pages smaller than a row. */
+    life.SetPageSize( 64 );
+    life.SetPartitionCount( p->MATHeight * p->COLS );
 }
 
 ncycles_t WordModel::Read( NVMainRequest *request )
@@ -29,6 +29,9 @@ class AbstractDRAMCache : public MemoryController
   virtual bool IssueFunctional( NVMainRequest *req ) = 0;
   virtual bool IsIssuable( NVMainRequest *request, FailReason *reason = NULL ) = 0;
 
+  /* True if the request was made by this DRAM cache, e.g., a memory read. */
+  virtual bool OwnsRequest( NVMainRequest *req ) { return (req->owner == this); }
+
 };
 
 
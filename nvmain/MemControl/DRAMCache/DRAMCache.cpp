@@ -253,7 +253,7 @@ bool DRAMCache::RequestComplete( NVMainRequest *req )
 
         for( ncounter_t i = 0; i < numChannels; i++ )
         {
-            if( req->owner == drcChannels[i] )
+            if( drcChannels[i]->OwnsRequest( req ) )
             {
                 drcRequest = true;
                 break;
@@ -342,8 +342,11 @@ void FRFCFS_WQF::Cycle( ncycle_t steps )
         /* switch to write drain */
         m_draining = true;
     }
-    /* or, if the write drain has completed */
-    else if( m_draining == true && writeQueue->size() <= LowWaterMark && force_drain == false )
+    /*
+     * or, if the write drain has completed. A forced drain may start while
+     * a write drain is in progress, so it must not keep the reads blocked.
+     */
+    else if( m_draining == true && writeQueue->size() <= LowWaterMark )
     {
         /* record the drain end cycle */
         m_drain_end_cycle = GetEventQueue()->GetCurrentCycle();
@@ -132,6 +132,21 @@ void LH_Cache::SetConfig( Config *conf, bool createChildren )
     ranks = static_cast<ncounter_t>( conf->GetValue( "RANKS" ) );
     banks = static_cast<ncounter_t>( conf->GetValue( "BANKS" ) );
 
+    /* 
+     *  Keep only tags when trace data is ignored, unless set explicitly.
+     *  Writebacks carry the line data, so tags alone are not enough when
+     *  data is simulated.
+     */
+    bool tagOnly = conf->KeyExists( "IgnoreData" ) && conf->GetBool( "IgnoreData" );
+    if( conf->KeyExists( "DRCTagOnly" ) )
+        tagOnly = conf->GetBool( "DRCTagOnly" );
+
+    if( tagOnly && !( conf->KeyExists( "IgnoreData" ) && conf->GetBool( "IgnoreData" ) ) )
+    {
+        std::cout << "Error: DRCTagOnly requires IgnoreData true." << std::endl;
+        exit(1);
+    }
+
     bankLocked = new bool*[ranks];
     functionalCache = new CacheBank**[ranks];
     for( i = 0; i < ranks; i++ )
@@ -143,7 +158,8 @@ void LH_Cache::SetConfig( Config *conf, bool createChildren )
         {
             bankLocked[i][j] = false;
             functionalCache[i][j] = new CacheBank( 
-                                         conf->GetValue( "ROWS" ), 1, 29, 64 );
+                                         conf->GetValue( "ROWS" ), 1, 29, 64,
+                                         tagOnly );
         }
     }
 
@@ -218,15 +234,56 @@ bool LH_Cache::IssueAtomic( NVMainRequest *req )
 
     req->address.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
 
+    /* Hits only update the LRU position (and dirty bit for writes). */
+    if( functionalCache[rank][bank]->Present( req->address ) )
+    {
+        if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+            (void)functionalCache[rank][bank]->Write( req->address, req->data );
+        else
+            (void)functionalCache[rank][bank]->Read( req->address, &dummy );
+
+        return true;
+    }
+
+    /* Read misses fetch the line from main memory functionally. */
+    if( req->type == READ || req->type == READ_PRECHARGE )
+    {
+        NVMainRequest *memReq = new NVMainRequest( );
+
+        *memReq = *req;
+        memReq->owner = this;
+        memReq->tag = DRC_MEMREAD;
+
+        mainMemory->IssueAtomic( memReq );
+
+        delete memReq;
+    }
+
     if( functionalCache[rank][bank]->SetFull( req->address ) ) 
     {
         NVMAddress victim;
 
         (void)functionalCache[rank][bank]->ChooseVictim( req->address, &victim );
-        (void)functionalCache[rank][bank]->Evict( victim, &dummy );
+
+        if( functionalCache[rank][bank]->Evict( victim, &dummy ) )
+        {
+            NVMainRequest *memReq = new NVMainRequest( );
+
+            memReq->address = victim;
+            memReq->owner = this;
+            memReq->type = WRITE;
+            memReq->data = dummy;
+
+            mainMemory->IssueAtomic( memReq );
+
+            delete memReq;
+        }
     }
 
-    (void)functionalCache[rank][bank]->Install( req->address, dummy ); 
+    (void)functionalCache[rank][bank]->Install( req->address, req->data ); 
+
+    if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+        (void)functionalCache[rank][bank]->Write( req->address, req->data );
 
     return true;
 }
@@ -39,12 +39,12 @@
 
 namespace NVM {
 
-#define DRC_TAGREAD1 tagGen->CreateTag("DRC_TAGREAD1")
-#define DRC_TAGREAD2 tagGen->CreateTag("DRC_TAGREAD2")
-#define DRC_TAGREAD3 tagGen->CreateTag("DRC_TAGREAD3")
-#define DRC_MEMREAD  tagGen->CreateTag("DRC_MEMREAD")
-#define DRC_FILL     tagGen->CreateTag("DRC_FILL")
-#define DRC_ACCESS   tagGen->CreateTag("DRC_ACCESS")
+#define DRC_TAGREAD1 TAG_DRC_TAGREAD1
+#define DRC_TAGREAD2 TAG_DRC_TAGREAD2
+#define DRC_TAGREAD3 TAG_DRC_TAGREAD3
+#define DRC_MEMREAD  TAG_DRC_MEMREAD
+#define DRC_FILL     TAG_DRC_FILL
+#define DRC_ACCESS   TAG_DRC_ACCESS
 
 class NVMain;
 
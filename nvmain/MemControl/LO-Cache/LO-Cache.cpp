@@ -37,9 +37,11 @@
 #include "NVM/nvmain.h"
 #include "src/EventQueue.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <cstdlib>
 #include <cassert>
 
 
@@ -70,6 +72,26 @@ LO_Cache::LO_Cache( )
     perfectFills = false;
     max_addr = 0;
 
+    setSampling = 1;
+    sampleSeed = 1;
+    tagStride = 0;
+
+    sampledReads = 0;
+    sampledReadHits = 0;
+    sampledInstalls = 0;
+    sampledDirtyEvicts = 0;
+    readLatencySum = 0;
+    readLatencyCount = 0;
+    writeLatencySum = 0;
+    writeLatencyCount = 0;
+    estBusFree = 0;
+
+    est_requests = 0;
+    est_hits = 0;
+    est_miss = 0;
+    est_writebacks = 0;
+    est_drc_hitrate = 0.0;
+
     psInterval = 0;
 
     /*
@@ -98,12 +120,27 @@ void LO_Cache::SetConfig( Config *conf, bool createChildren )
     if( conf->KeyExists( "PerfectFills" ) && conf->GetString( "PerfectFills" ) == "true" )
         perfectFills = true;
 
+    /* Simulate one in DRCSetSampling sets in detail. */
+    if( conf->KeyExists( "DRCSetSampling" ) )
+        setSampling = static_cast<ncounter_t>( conf->GetValue( "DRCSetSampling" ) );
+    if( setSampling == 0 )
+        setSampling = 1;
+
 
     ranks = static_cast<ncounter_t>( conf->GetValue( "RANKS" ) );
     banks = static_cast<ncounter_t>( conf->GetValue( "BANKS" ) );
     rows  = static_cast<ncounter_t>( conf->GetValue( "ROWS" ) );
     cols  = static_cast<ncounter_t>( conf->GetValue( "COLS" ) );
 
+    if( setSampling > 1 )
+    {
+        estBankFree.assign( ranks * banks, 0 );
+
+        std::cout << "LO_Cache: Simulating one in " << setSampling << " sets in "
+                  << "detail. The latency of the other sets is estimated, so "
+                  << "cycle counts and latencies are approximate." << std::endl;
+    }
+
     /*
      * Calculate the memory word size under the default burst length.
      * This will be the width of the bus multiplied by the number of
@@ -115,6 +152,21 @@ void LO_Cache::SetConfig( Config *conf, bool createChildren )
               * static_cast<ncounter_t>( conf->GetValue( "tBURST" ) );
     word_size /= 8;
 
+    /* 
+     *  Line data is only needed when data is simulated below the cache, so
+     *  keep only tags when trace data is ignored, unless set explicitly.
+     *  Writebacks carry the line data, so tags alone are not enough when
+     *  data is simulated.
+     */
+    bool tagOnly = conf->KeyExists( "IgnoreData" ) && conf->GetBool( "IgnoreData" );
+    if( conf->KeyExists( "DRCTagOnly" ) )
+        tagOnly = conf->GetBool( "DRCTagOnly" );
+
+    if( tagOnly && !( conf->KeyExists( "IgnoreData" ) && conf->GetBool( "IgnoreData" ) ) )
+    {
+        std::cout << "Error: DRCTagOnly requires IgnoreData true." << std::endl;
+        exit(1);
+    }
 
     functionalCache = new CacheBank**[ranks];
     for( ncounter_t i = 0; i < ranks; i++ )
@@ -132,12 +184,15 @@ void LO_Cache::SetConfig( Config *conf, bool createChildren )
              *  an assoc of 1, and cache line size of 64 bytes.
              */
             lines = (cols * word_size) / 72;
-            functionalCache[i][j] = new CacheBank( rows, lines, 1, 64 );
+            functionalCache[i][j] = new CacheBank( rows, lines, 1, 64, tagOnly );
         }
     }
 
     MemoryController::SetConfig( conf, createChildren );
 
+    if( setSampling > 1 )
+        tagStride = TagStride( );
+
     SetDebugName( "LO-Cache", conf );
 }
 
@@ -153,6 +208,16 @@ void LO_Cache::RegisterStats( )
     AddStat(rb_miss);
     AddStat(starvation_precharges);
 
+    /* Extrapolated from the sampled sets, not simulated in detail. */
+    if( setSampling > 1 )
+    {
+        AddStat(est_requests);
+        AddStat(est_hits);
+        AddStat(est_miss);
+        AddStat(est_writebacks);
+        AddStat(est_drc_hitrate);
+    }
+
     MemoryController::RegisterStats( );
 }
 
@@ -163,46 +228,89 @@ void LO_Cache::SetMainMemory( NVMain *mm )
 
 bool LO_Cache::IssueAtomic( NVMainRequest *req )
 {
-    uint64_t row, bank, rank, subarray;
+    uint64_t bank, rank;
 
-    req->address.GetTranslatedAddress( &row, NULL, &bank, &rank, NULL, &subarray );
+    req->address.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
 
     if( req->address.GetPhysicalAddress() > max_addr ) max_addr = req->address.GetPhysicalAddress( );
 
     /*
-    *  Check for a hit for statistical purposes first.
-    */
-    if( req->type == WRITE || req->type == WRITE_PRECHARGE || functionalCache[rank][bank]->Present( req->address ) )
+     *  Follow the same install policy as the cycle-accurate path so the
+     *  cache contents are identical when the detailed simulation starts.
+     */
+    if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+    {
+        drc_hits++;
+
+        AtomicFill( req->address, req->data );
+    }
+    else if( functionalCache[rank][bank]->Present( req->address ) )
     {
         drc_hits++;
     }
     else
     {
-        /*
-         *  Simply install this cache line, evicting another cache line 
-         *  if needed.
-         */
-        NVMDataBlock dummy;
+        /* Read the line from main memory so its state is warmed up as well. */
+        NVMainRequest *memReq = new NVMainRequest( );
 
-        if( functionalCache[rank][bank]->SetFull( req->address ) )
-        {
-            NVMAddress victim;
+        *memReq = *req;
+        memReq->owner = this;
+        memReq->tag = DRC_MEMREAD;
+        memReq->type = READ;
 
-            (void)functionalCache[rank][bank]->ChooseVictim( req->address, &victim );
-            (void)functionalCache[rank][bank]->Evict( victim, &dummy );
+        mainMemory->IssueAtomic( memReq );
 
-            drc_evicts++;
-        }
+        delete memReq;
 
         drc_miss++;
-        drc_fills++;
 
-        (void)functionalCache[rank][bank]->Install( req->address, dummy );
+        AtomicFill( req->address, req->data );
     }
 
     return true;
 }
 
+void LO_Cache::AtomicFill( NVMAddress& addr, NVMDataBlock& data )
+{
+    uint64_t rank, bank;
+    NVMDataBlock vicData;
+    bool dirtyEvict = false;
+    NVMAddress victim;
+
+    addr.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+
+    if( functionalCache[rank][bank]->SetFull( addr )
+        && !functionalCache[rank][bank]->Present( addr ) )
+    {
+        (void)functionalCache[rank][bank]->ChooseVictim( addr, &victim );
+        dirtyEvict = functionalCache[rank][bank]->Evict( victim, &vicData );
+
+        drc_evicts++;
+    }
+
+    (void)functionalCache[rank][bank]->Install( addr, data );
+
+    drc_fills++;
+
+    /* Write back dirty victims to main memory functionally. */
+    if( dirtyEvict )
+    {
+        NVMainRequest *memReq = new NVMainRequest( );
+
+        memReq->address = victim;
+        memReq->owner = this;
+        memReq->tag = DRC_EVICT;
+        memReq->type = WRITE;
+        memReq->data = vicData;
+
+        mainMemory->IssueAtomic( memReq );
+
+        delete memReq;
+
+        drc_dirty_evicts++;
+    }
+}
+
 bool LO_Cache::IssueFunctional( NVMainRequest *req )
 {
     uint64_t bank, rank;
@@ -224,7 +332,7 @@ bool LO_Cache::IsIssuable( NVMainRequest * /*request*/, FailReason * /*fail*/ )
     /*
      *  Limit the number of commands in the queue. This will stall the caches/CPU.
      */ 
-    if( drcQueue->size( ) >= drcQueueSize )
+    if( drcQueue->size( ) + QueuedEstimates( ) >= drcQueueSize )
     {
         rv = false;
     }
@@ -238,6 +346,22 @@ bool LO_Cache::IssueCommand( NVMainRequest *req )
 
     if( req->address.GetPhysicalAddress() > max_addr ) max_addr = req->address.GetPhysicalAddress( );
 
+    if( setSampling > 1 )
+    {
+        if( req->owner != this && !IsSampledSet( req->address ) )
+        {
+            EstimateRequest( req );
+            return rv;
+        }
+
+        /* Sampled requests keep the banks busy for the estimated ones too. */
+        (void)ReserveBank( req->address, 
+                           req->type == WRITE || req->type == WRITE_PRECHARGE, false );
+
+        if( req->owner != this )
+            sampledArrivals[req] = GetEventQueue()->GetCurrentCycle();
+    }
+
     if( perfectFills && (req->type == WRITE || req->type == WRITE_PRECHARGE) )
     {
         uint64_t rank, bank;
@@ -278,6 +402,10 @@ bool LO_Cache::RequestComplete( NVMainRequest *req )
     {
         ProcessRefreshPulse( req );
     }
+    else if( setSampling > 1 && estimatedRequests.count( req ) > 0 )
+    {
+        ResolveEstimate( req );
+    }
     else if( req->owner == this )
     {
         if( req->tag == DRC_FILL )
@@ -302,6 +430,7 @@ bool LO_Cache::RequestComplete( NVMainRequest *req )
             (void)functionalCache[rank][bank]->Install( req->address, req->data );
 
             drc_fills++;
+            CalibrationSample( sampledInstalls, sampledDirtyEvicts, dirtyEvict ? 1 : 0 );
 
             /* If we are replacing a dirty block we need to write back to main
              * memory. We are assuming the DRC read miss contains the data and
@@ -336,22 +465,32 @@ bool LO_Cache::RequestComplete( NVMainRequest *req )
          */
         else if( req->tag == DRC_MEMREAD )
         {
+            /* Find the original request to send back to the requestor. */
+            assert( outstandingFills.count( req ) > 0 );
+            NVMainRequest *originalReq = outstandingFills[req];
+            outstandingFills.erase( req );
 
-            /* Issue as a fill request. */
-            NVMainRequest *fillReq = new NVMainRequest( );
+            /* Fills to sets that are not sampled are only estimated. */
+            if( setSampling > 1 && !IsSampledSet( originalReq->address ) )
+            {
+                /* The fill is not simulated, but it still occupies the bank. */
+                (void)ReserveBank( originalReq->address, true, true );
 
-            *fillReq = *req;
-            fillReq->owner = this;
-            fillReq->tag = DRC_FILL;
-            fillReq->type = WRITE;
-            fillReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
+                EstimateWriteback( originalReq );
+            }
+            else
+            {
+                /* Issue as a fill request. */
+                NVMainRequest *fillReq = new NVMainRequest( );
 
-            this->IssueCommand( fillReq );
+                *fillReq = *req;
+                fillReq->owner = this;
+                fillReq->tag = DRC_FILL;
+                fillReq->type = WRITE;
+                fillReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
 
-            /* Find the original request and send back to requestor. */
-            assert( outstandingFills.count( req ) > 0 );
-            NVMainRequest *originalReq = outstandingFills[req];
-            outstandingFills.erase( req );
+                this->IssueCommand( fillReq );
+            }
 
             GetParent( )->RequestComplete( originalReq );
             rv = false;
@@ -392,6 +531,9 @@ bool LO_Cache::RequestComplete( NVMainRequest *req )
 
             (void)functionalCache[rank][bank]->Install( req->address, req->data );
 
+            CalibrationSample( sampledInstalls, sampledDirtyEvicts, dirtyEvict ? 1 : 0 );
+            RecordSampledLatency( req );
+
             /* Send back to requestor. */
             GetParent( )->RequestComplete( req );
             rv = false;
@@ -433,6 +575,9 @@ bool LO_Cache::RequestComplete( NVMainRequest *req )
             /* Check for a hit. */
             bool hit = functionalCache[rank][bank]->Present( req->address );
 
+            CalibrationSample( sampledReads, sampledReadHits, hit ? 1 : 0 );
+            RecordSampledLatency( req );
+
             /* On a miss, send to main memory. */
             if( !hit )
             {
@@ -521,9 +666,274 @@ void LO_Cache::CalculateStats( )
     if( drc_hits+drc_miss > 0 )
         drc_hitrate = static_cast<float>(drc_hits) / static_cast<float>(drc_miss+drc_hits);
 
+    est_drc_hitrate = 0.0;
+    if( drc_hits+drc_miss+est_hits+est_miss > 0 )
+        est_drc_hitrate = static_cast<double>(drc_hits+est_hits) 
+                        / static_cast<double>(drc_hits+drc_miss+est_hits+est_miss);
+
     MemoryController::CalculateStats( );
 }
 
+bool LO_Cache::IsSampledSet( NVMAddress& addr )
+{
+    uint64_t rank, bank, set;
+    CacheBank *bankCache;
+
+    addr.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+
+    bankCache = functionalCache[rank][bank];
+    set = (rank * banks + bank) * bankCache->numRows * bankCache->numSets
+        + bankCache->SetIndex( addr );
+
+    /* Hash the set number so the sample does not alias with the address mapping. */
+    return (((set * 0x9E3779B97F4A7C15ULL) >> 32) % setSampling) == 0;
+}
+
+ncycle_t LO_Cache::MeanLatency( ncounter_t sum, ncounter_t count )
+{
+    ncycle_t latency = 1;
+
+    if( count > 0 && sum / count > 1 )
+        latency = sum / count;
+
+    return latency;
+}
+
+void LO_Cache::CalibrationSample( ncounter_t& count, ncounter_t& sum, ncounter_t value )
+{
+    count++;
+    sum += value;
+
+    if( count >= calibrationWindow )
+    {
+        count /= 2;
+        sum /= 2;
+    }
+}
+
+void LO_Cache::RecordSampledLatency( NVMainRequest *req )
+{
+    std::map<NVMainRequest *, ncycle_t>::iterator it = sampledArrivals.find( req );
+
+    if( it == sampledArrivals.end( ) )
+        return;
+
+    ncycle_t latency = GetEventQueue()->GetCurrentCycle() - it->second;
+
+    if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+        CalibrationSample( writeLatencyCount, writeLatencySum, latency );
+    else
+        CalibrationSample( readLatencyCount, readLatencySum, latency );
+
+    sampledArrivals.erase( it );
+}
+
+/*
+ *  Reserves the bank of addr for the expected occupancy of one read or
+ *  write, given the row buffer hit rate of the sampled sets, and the data
+ *  bus for one burst. Returns the cycle the data burst can start.
+ */
+ncycle_t LO_Cache::ReserveBank( NVMAddress& addr, bool write, bool estimated )
+{
+    uint64_t rank, bank;
+    ncycle_t now = GetEventQueue()->GetCurrentCycle();
+    double rbHitRate = 0.0;
+
+    addr.GetTranslatedAddress( NULL, NULL, &bank, &rank, NULL, NULL );
+
+    if( rb_hits + rb_miss > 0 )
+        rbHitRate = static_cast<double>(rb_hits) / static_cast<double>(rb_hits + rb_miss);
+
+    /* A row miss holds the bank from activate until the precharge is done. */
+    double hitOccupancy = static_cast<double>( std::max( p->tCCD, p->tBURST ) );
+    double missOccupancy = static_cast<double>( p->tRAS + p->tRP );
+
+    if( write )
+    {
+        missOccupancy = static_cast<double>( std::max( p->tRAS, 
+                        p->tRCD + p->tCWD + p->tBURST + p->tWR ) + p->tRP );
+    }
+    ncycle_t occupancy = static_cast<ncycle_t>( rbHitRate * hitOccupancy
+                       + (1.0 - rbHitRate) * missOccupancy + 0.5 );
+
+    ncycle_t& bankFree = estBankFree[rank * banks + bank];
+    ncycle_t start = std::max( now, bankFree );
+    ncycle_t dataStart = std::max( start, estBusFree );
+
+    bankFree = start + occupancy;
+    estBusFree = dataStart + p->tBURST;
+
+    if( estimated && start > now )
+        estimatedStarts.insert( start );
+
+    return dataStart;
+}
+
+/* Estimated requests that are still waiting for their bank. */
+ncounter_t LO_Cache::QueuedEstimates( )
+{
+    ncycle_t now = GetEventQueue()->GetCurrentCycle();
+
+    while( !estimatedStarts.empty( ) && *estimatedStarts.begin( ) <= now )
+        estimatedStarts.erase( estimatedStarts.begin( ) );
+
+    return estimatedStarts.size( );
+}
+
+/*
+ *  Complete a request to a set that is not sampled after it waits for its
+ *  bank and the data bus, plus the mean DRAM cache access latency seen by
+ *  the sampled sets. Misses are decided at that point and still go to main
+ *  memory, so main memory traffic is simulated in detail.
+ */
+void LO_Cache::EstimateRequest( NVMainRequest *req )
+{
+    bool write = (req->type == WRITE || req->type == WRITE_PRECHARGE);
+    ncycle_t latency = ReserveBank( req->address, write, true )
+                     - GetEventQueue()->GetCurrentCycle();
+
+    if( write )
+        latency += MeanLatency( writeLatencySum, writeLatencyCount );
+    else
+        latency += MeanLatency( readLatencySum, readLatencyCount );
+
+    estimatedRequests.insert( req );
+    est_requests++;
+
+    GetEventQueue()->InsertEvent( EventResponse, this, req, 
+                                  GetEventQueue()->GetCurrentCycle() + latency );
+}
+
+void LO_Cache::ResolveEstimate( NVMainRequest *req )
+{
+    estimatedRequests.erase( req );
+
+    if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+    {
+        EstimateWriteback( req );
+
+        GetParent( )->RequestComplete( req );
+        return;
+    }
+
+    double hitRate = 0.0;
+    double coinToss = static_cast<double>(::rand_r(&sampleSeed)) 
+                    / static_cast<double>(RAND_MAX);
+
+    if( sampledReads > 0 )
+        hitRate = static_cast<double>(sampledReadHits) / static_cast<double>(sampledReads);
+
+    if( coinToss < hitRate )
+    {
+        GetParent( )->RequestComplete( req );
+
+        est_hits++;
+    }
+    else
+    {
+        NVMainRequest *memReq = new NVMainRequest( );
+
+        *memReq = *req;
+        memReq->owner = this;
+        memReq->tag = DRC_MEMREAD;
+        memReq->type = READ;
+        memReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
+
+        assert( outstandingFills.count( memReq ) == 0 );
+        outstandingFills.insert( std::pair<NVMainRequest*, NVMainRequest*>( memReq, req ) );
+
+        IssueMainMemory( memReq );
+
+        est_miss++;
+    }
+}
+
+/*
+ *  Addresses that differ only above the bits used by the decoder map to the
+ *  same set with a different tag. Returns the lowest such address stride.
+ */
+uint64_t LO_Cache::TagStride( )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+    uint64_t baseRow, baseCol, baseBank, baseRank, baseChannel, baseSubarray;
+    uint64_t address = 0, stride = 64;
+
+    GetDecoder( )->Translate( address, &baseRow, &baseCol, &baseBank, &baseRank,
+                              &baseChannel, &baseSubarray );
+
+    for( unsigned int bit = 6; bit < 63; bit++ )
+    {
+        address = 1ULL << bit;
+        GetDecoder( )->Translate( address, &row, &col, &bank, &rank,
+                                  &channel, &subarray );
+
+        if( row != baseRow || col != baseCol || bank != baseBank 
+            || rank != baseRank || channel != baseChannel 
+            || subarray != baseSubarray )
+        {
+            stride = 1ULL << (bit + 1);
+        }
+    }
+
+    return stride;
+}
+
+/*
+ *  An estimated install evicts a dirty line as often as installs in the
+ *  sampled sets do. Sets that are not sampled keep no tags, so the victim is
+ *  a random other tag of the same set within the addresses seen so far.
+ */
+void LO_Cache::EstimateWriteback( NVMainRequest *req )
+{
+    double evictRate = 0.0;
+    double coinToss = static_cast<double>(::rand_r(&sampleSeed)) 
+                    / static_cast<double>(RAND_MAX);
+
+    if( sampledInstalls > 0 )
+        evictRate = static_cast<double>(sampledDirtyEvicts) 
+                  / static_cast<double>(sampledInstalls);
+
+    if( coinToss >= evictRate )
+        return;
+
+    uint64_t address = req->address.GetPhysicalAddress( );
+    uint64_t tag = address / tagStride;
+    uint64_t tagCount = max_addr / tagStride + 1;
+    uint64_t victimTag = tag + 1;
+
+    if( tagCount > 1 )
+    {
+        victimTag = static_cast<uint64_t>(::rand_r(&sampleSeed)) % (tagCount - 1);
+        if( victimTag >= tag )
+            victimTag++;
+    }
+
+    NVMainRequest *memReq = new NVMainRequest( );
+
+    memReq->address.SetPhysicalAddress( victimTag * tagStride + address % tagStride );
+    memReq->owner = this;
+    memReq->tag = DRC_EVICT;
+    memReq->type = WRITE;
+    memReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
+
+    IssueMainMemory( memReq );
+
+    est_writebacks++;
+}
+
+void LO_Cache::IssueMainMemory( NVMainRequest *memReq )
+{
+    if( mainMemory->IsIssuable( memReq, NULL ) ) 
+    {
+        mainMemory->IssueCommand( memReq );
+    } 
+    else 
+    {
+        /* Hold the request until main memory can accept it. */
+        mainMemory->EnqueuePendingMemoryRequests( memReq );
+    }
+}
+
 void LO_Cache::CreateCheckpoint( std::string dir )
 {
     /* Use our statName as the file to write in the checkpoint directory. */
@@ -546,12 +956,7 @@ void LO_Cache::CreateCheckpoint( std::string dir )
             }
             else
             {
-                /* Iterate over cache sets, since they may not be allocated contiguously. */
-                for( uint64_t set = 0; set < functionalCache[rankIdx][bankIdx]->numSets; set++ )
-                {
-                    cpt_handle.write( (const char *)(functionalCache[rankIdx][bankIdx]->cacheEntry[set]), 
-                                      sizeof(CacheEntry)*functionalCache[rankIdx][bankIdx]->numAssoc );
-                }
+                functionalCache[rankIdx][bankIdx]->WriteCheckpoint( cpt_handle );
 
                 cpt_handle.close( );
             }
@@ -600,7 +1005,7 @@ void LO_Cache::RestoreCheckpoint( std::string dir )
             }
             else
             {
-                std::streampos expectedSize = sizeof(CacheEntry)*functionalCache[rankIdx][bankIdx]->numSets*functionalCache[rankIdx][bankIdx]->numAssoc;
+                std::streampos expectedSize = functionalCache[rankIdx][bankIdx]->GetCheckpointSize( );
                 if( cpt_handle.tellg( ) != expectedSize )
                 {
                     std::cout << "LO_Cache: Warning: Expected checkpoint size differs from DRAM cache configuration. Skipping restore." << std::endl;
@@ -611,16 +1016,11 @@ void LO_Cache::RestoreCheckpoint( std::string dir )
 
                     cpt_handle.open( cpt_file.str().c_str(), std::ifstream::in | std::ifstream::binary );
 
-                    /* Iterate over cache sets, since they may not be allocated contiguously. */
-                    for( uint64_t set = 0; set < functionalCache[rankIdx][bankIdx]->numSets; set++ )
-                    {
-                        cpt_handle.read( (char *)(functionalCache[rankIdx][bankIdx]->cacheEntry[set]), 
-                                          sizeof(CacheEntry)*functionalCache[rankIdx][bankIdx]->numAssoc );
-                    }
+                    functionalCache[rankIdx][bankIdx]->ReadCheckpoint( cpt_handle );
 
                     cpt_handle.close( );
 
-                    std::cout << "LO_Cache: Checkpoint read " << (sizeof(CacheEntry)*functionalCache[rankIdx][bankIdx]->numAssoc*functionalCache[rankIdx][bankIdx]->numSets) << " bytes." << std::endl;
+                    std::cout << "LO_Cache: Checkpoint read " << functionalCache[rankIdx][bankIdx]->GetCheckpointSize( ) << " bytes." << std::endl;
                 }
             }
         }
@@ -41,14 +41,16 @@
 
 
 #include <map>
+#include <set>
+#include <vector>
 
 
 namespace NVM {
 
 
-#define DRC_MEMREAD tagGen->CreateTag("DRC_MEMREAD")
-#define DRC_FILL    tagGen->CreateTag("DRC_FILL")
-#define DRC_EVICT   tagGen->CreateTag("DRC_EVICT")
+#define DRC_MEMREAD TAG_DRC_MEMREAD
+#define DRC_FILL    TAG_DRC_FILL
+#define DRC_EVICT   TAG_DRC_EVICT
 
 
 class NVMain;
@@ -98,6 +100,54 @@ class LO_Cache : public AbstractDRAMCache
     double drc_hitrate;
 
     std::map<NVMainRequest *, NVMainRequest *> outstandingFills;
+
+    /*
+     *  Set sampling: only one in setSampling sets is simulated in detail.
+     *  Requests to the other sets are resolved with the hit rate, latency
+     *  and dirty eviction rate recently measured on the sampled sets. Each
+     *  pair of counters is halved once the count reaches calibrationWindow,
+     *  so the estimates follow the cache as it warms up.
+     *
+     *  The DRAM cache banks only see the sampled requests, so the contention
+     *  the other requests would cause is modeled separately: every request
+     *  reserves its bank for its expected occupancy and the data bus for a
+     *  burst, and estimated requests wait for both before the mean latency
+     *  starts. Estimated requests still waiting for their bank count toward
+     *  DRCQueueSize.
+     */
+    static const ncounter_t calibrationWindow = 64;
+
+    ncounter_t setSampling;
+    unsigned int sampleSeed;
+    uint64_t tagStride;
+    std::set<NVMainRequest *> estimatedRequests;
+    std::map<NVMainRequest *, ncycle_t> sampledArrivals;
+
+    ncounter_t sampledReads, sampledReadHits;
+    ncounter_t sampledInstalls, sampledDirtyEvicts;
+    ncounter_t readLatencySum, readLatencyCount;
+    ncounter_t writeLatencySum, writeLatencyCount;
+
+    std::vector<ncycle_t> estBankFree;
+    ncycle_t estBusFree;
+    std::multiset<ncycle_t> estimatedStarts;
+
+    ncounter_t est_requests, est_hits, est_miss, est_writebacks;
+    double est_drc_hitrate;
+
+    void AtomicFill( NVMAddress& addr, NVMDataBlock& data );
+
+    bool IsSampledSet( NVMAddress& addr );
+    ncycle_t MeanLatency( ncounter_t sum, ncounter_t count );
+    void CalibrationSample( ncounter_t& count, ncounter_t& sum, ncounter_t value );
+    void RecordSampledLatency( NVMainRequest *req );
+    ncycle_t ReserveBank( NVMAddress& addr, bool write, bool estimated );
+    ncounter_t QueuedEstimates( );
+    void EstimateRequest( NVMainRequest *req );
+    void ResolveEstimate( NVMainRequest *req );
+    uint64_t TagStride( );
+    void EstimateWriteback( NVMainRequest *req );
+    void IssueMainMemory( NVMainRequest *memReq );
 };
 
 
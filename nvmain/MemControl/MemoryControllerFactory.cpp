@@ -39,6 +39,7 @@
 #include "MemControl/DRAMCache/DRAMCache.h"
 #include "MemControl/LH-Cache/LH-Cache.h"
 #include "MemControl/LO-Cache/LO-Cache.h"
+#include "MemControl/MissMap/MissMap.h"
 #include "MemControl/PredictorDRC/PredictorDRC.h"
 
 #include <iostream>
@@ -66,6 +67,8 @@ MemoryController *MemoryControllerFactory::CreateNewController( std::string cont
         memoryController = new LH_Cache( );
     else if( controller == "LO_Cache" )
         memoryController = new LO_Cache( );
+    else if( controller == "MissMap" )
+        memoryController = new MissMap( );
     else if( controller == "PredictorDRC" )
         memoryController = new PredictorDRC( );
 
@@ -32,10 +32,10 @@
 *******************************************************************************/
 
 #include "MemControl/MissMap/MissMap.h"
-#include "Decoders/DRCDecoder/DRCDecoder.h"
-#include "MemControl/LH-Cache/LH-Cache.h"
 #include "include/NVMHelpers.h"
 #include "NVM/nvmain.h"
+#include "src/EventQueue.h"
+#include <sstream>
 #include <assert.h>
 
 using namespace NVM;
@@ -43,6 +43,8 @@ using namespace NVM;
 MissMap::MissMap( )
 {
     missMap = NULL;
+    mainMemory = NULL;
+    drcCache = NULL;
 
     missMapAllocations = 0;
     missMapWrites = 0;
@@ -51,21 +53,28 @@ MissMap::MissMap( )
     missMapForceEvicts = 0;
     missMapMemReads = 0;
 
+    missFilter = NULL;
+    filterBypasses = 0;
+    filterFalsePositives = 0;
+    filterFalsePositiveRate = 0.0;
+    probeCycles = 0;
+    filterCyclesSaved = 0;
+
     psInterval = 0;
 }
 
 MissMap::~MissMap( )
 {
+    delete missFilter;
 }
 
-void MissMap::SetConfig( Config *conf, bool createChildren )
+void MissMap::SetMainMemory( NVMain *mm )
 {
-    /* Initialize DRAM Cache channels */
-    if( conf->KeyExists( "DRC_CHANNELS" ) )
-        numChannels = static_cast<ncounter_t>( conf->GetValue( "DRC_CHANNELS" ) );
-    else
-        numChannels = 1;
+    mainMemory = mm;
+}
 
+void MissMap::SetConfig( Config *conf, bool createChildren )
+{
     /* MissMap Setup */
     uint64_t mmSets, mmAssoc;
 
@@ -85,43 +94,46 @@ void MissMap::SetConfig( Config *conf, bool createChildren )
     if( conf->KeyExists( "MissMapLatency" ) ) 
         missMapLatency = static_cast<uint64_t>( conf->GetValue( "MissMapLatency" ) );
 
-    if( createChildren )
+    /* Optional counting Bloom filter in front of the miss map. */
+    if( conf->KeyExists( "MissMapFilter" ) && conf->GetBool( "MissMapFilter" ) )
     {
-        /* Initialize off-chip memory */
-        std::string configFile;
-        Config *mainMemoryConfig;
+        uint64_t filterCounters = 65536;
+        if( conf->KeyExists( "MissMapFilterCounters" ) ) 
+            filterCounters = static_cast<uint64_t>( conf->GetValue( "MissMapFilterCounters" ) );
 
-        configFile  = NVM::GetFilePath( conf->GetFileName( ) );
-        configFile += conf->GetString( "MM_CONFIG" );
+        uint64_t filterHashes = 3;
+        if( conf->KeyExists( "MissMapFilterHashes" ) ) 
+            filterHashes = static_cast<uint64_t>( conf->GetValue( "MissMapFilterHashes" ) );
 
-        mainMemoryConfig = new Config( );
-        mainMemoryConfig->Read( configFile );
-
-        mainMemory = new NVMain( );
-        mainMemory->SetConfig( mainMemoryConfig, "offChipMemory", createChildren );
-        mainMemory->SetParent( this ); 
+        missFilter = new CountingBloomFilter( filterCounters, filterHashes );
+    }
 
-        std::string drcVariant = "LH_Cache";
-        if( conf->KeyExists( "DRCVariant" ) ) 
-            drcVariant = conf->GetString( "DRCVariant" );
+    if( createChildren )
+    {
+        /* 
+         *  The DRAM cache behind the miss map. LH_Cache is no longer working,
+         *  so this is always an LO_Cache. It shares our channel's main memory.
+         */
+        std::stringstream formatter;
 
-        drcChannels = new LH_Cache*[numChannels];
-        for( ncounter_t i = 0; i < numChannels; i++ )
-        {
-            drcChannels[i] = dynamic_cast<LH_Cache *>( 
-                    MemoryControllerFactory::CreateNewController( drcVariant ));
+        /* The LO_Cache sizes its decoder from ours, i.e., the DRC decoder. */
+        decoder = GetParent( )->GetTrampoline( )->GetDecoder( );
 
-            drcChannels[i]->SetMainMemory( mainMemory );
+        drcCache = dynamic_cast<AbstractDRAMCache *>( 
+                MemoryControllerFactory::CreateNewController( "LO_Cache" ) );
+        drcCache->SetMainMemory( mainMemory );
 
-            drcChannels[i]->SetID( static_cast<unsigned int>(i) );
-            drcChannels[i]->StatName( this->statName ); 
+        formatter << StatName( ) << ".LO_Cache";
+        drcCache->SetID( GetID( ) );
+        drcCache->StatName( formatter.str( ) ); 
 
-            drcChannels[i]->SetParent( this );
-            AddChild( drcChannels[i] );
+        drcCache->SetParent( this );
+        AddChild( drcCache );
 
-            drcChannels[i]->SetConfig( conf, createChildren );
-        }
+        drcCache->SetConfig( conf, createChildren );
+        drcCache->RegisterStats( );
 
+        /* The line bit-vectors are stored as data, so this is never tag-only. */
         missMap = new CacheBank( 1, mmSets, mmAssoc, 64 ); 
         missMap->isMissMap = true;
 
@@ -143,6 +155,14 @@ void MissMap::RegisterStats( )
     AddStat(missMapMisses);
     AddStat(missMapForceEvicts);
     AddStat(missMapMemReads);
+
+    if( missFilter )
+    {
+        AddStat(filterBypasses);
+        AddStat(filterFalsePositives);
+        AddStat(filterFalsePositiveRate);
+        AddStat(filterCyclesSaved);
+    }
 }
 
 bool MissMap::QueueFull( NVMainRequest * )
@@ -157,8 +177,7 @@ bool MissMap::IssueAtomic( NVMainRequest *req )
     NVMAddress testAddr;
     NVMDataBlock data;
 
-    /* 6 = log2(cacheline size), 12 = log2(segment size) */
-    testAddr.SetPhysicalAddress( (req->address.GetPhysicalAddress( ) >> 6) >> 12 ); 
+    testAddr = PageAddress( req->address );
 
     /* 6 = log2(cacheline size), 0xFFF = segment size - 1, 64 = 
      * segment size / cacheline size 
@@ -166,20 +185,20 @@ bool MissMap::IssueAtomic( NVMainRequest *req )
     lineOffset = ((req->address.GetPhysicalAddress( ) >> 6) & 0xFFF) / 64; 
     lineMask = (uint64_t)(1ULL << lineOffset);
 
-    std::cout << "Address 0x" << std::hex << req->address.GetPhysicalAddress() 
-        << " maps to page 0x" << testAddr.GetPhysicalAddress( ) << std::dec 
-        << " with offset " << lineOffset << std::endl;
-    
     /* Entry exists, so augment the existing bit-vector */
     if( missMap->Present( testAddr ) )
     {
-        missMap->Read( req->address, &data );
+        missMap->Read( testAddr, &data );
 
         lineMap = reinterpret_cast<uint64_t *>(data.rawData);
 
         if( !((*lineMap) & lineMask) ) // NOT in MissMap.
         {
             *lineMap |= lineMask;
+            missMap->UpdateData( testAddr, data );
+
+            if( missFilter )
+                missFilter->Insert( FilterKey( req->address ) );
         }
     }
     /* Entry doesn't exist. Create a new bit-vector and write it. */
@@ -193,24 +212,47 @@ bool MissMap::IssueAtomic( NVMainRequest *req )
 
             missMap->ChooseVictim( testAddr, &victim );
             missMap->Evict( victim, &dummy );
+
+            if( dummy.rawData != NULL )
+                RemoveLines( victim, *reinterpret_cast<uint64_t *>(dummy.rawData) );
         }
 
         /* Create a new bit-vector with just this cacheline as the entry. */
-        lineMap = new uint64_t;
+        data.SetSize( sizeof(uint64_t) );
+        lineMap = reinterpret_cast<uint64_t *>(data.rawData);
 
         *lineMap = lineMask;
-        data.rawData = reinterpret_cast<uint8_t*>(lineMap);
 
         missMap->Install( testAddr, data ); 
+
+        if( missFilter )
+            missFilter->Insert( FilterKey( req->address ) );
     }
 
-    return true;
+    /* The DRAM cache fetches read misses from main memory itself. */
+    return drcCache->IssueAtomic( req );
+}
+
+bool MissMap::IssueFunctional( NVMainRequest *req )
+{
+    return drcCache->IssueFunctional( req );
+}
+
+bool MissMap::IsIssuable( NVMainRequest *req, FailReason * /*reason*/ )
+{
+    return !QueueFull( req ) && drcCache->IsIssuable( req );
 }
 
 bool MissMap::IssueCommand( NVMainRequest *req )
 {
     bool rv = false;
 
+    if( missFilter && !missFilter->MayContain( FilterKey( req->address ) ) )
+    {
+        BypassMissMap( req );
+        return true;
+    }
+
     /* Make sure there is space in the MissMap's queue */
     if( missMapQueue.size( ) < missMapQueueSize )
     {
@@ -221,17 +263,16 @@ bool MissMap::IssueCommand( NVMainRequest *req )
         mmReq->tag = MISSMAP_READ;
         mmReq->reqInfo = static_cast<void *>( creq );
         mmReq->owner = this;
+        mmReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
 
         creq->optype = CACHE_READ;
-        creq->address = req->address; 
-
         /* Use the PAGE ADDRESS for the miss map */
-        creq->address.SetPhysicalAddress( 
-                (creq->address.GetPhysicalAddress( ) >> 6) >> 12 ); 
+        creq->address = PageAddress( req->address ); 
         creq->owner = this;
         creq->originalRequest = req;
 
         missMapQueue.push( mmReq );
+        ScheduleIssue( );
 
 #ifdef DBGMISSMAP
         std::cout << "Enqueued a request to the miss map. " << std::endl;
@@ -249,6 +290,10 @@ bool MissMap::RequestComplete( NVMainRequest *req )
 
     if( req->owner == this )
     {
+        /* The miss map is free again once this access returns. */
+        if( req->tag == MISSMAP_READ || req->tag == MISSMAP_WRITE )
+            ScheduleIssue( );
+
         if( req->tag == MISSMAP_READ )
         {
             CacheRequest *cacheReq = static_cast<CacheRequest *>( req->reqInfo );
@@ -258,20 +303,22 @@ bool MissMap::RequestComplete( NVMainRequest *req )
                 << cacheReq->hit << std::endl;
 #endif
 
+            /* The filter said this line may be cached. */
+            if( missFilter )
+                probeCycles += GetEventQueue()->GetCurrentCycle() - req->arrivalCycle;
+
             /* Found miss map entry for this page. */
             if( cacheReq->hit )
             {
                 /* Check MissMap entry for this cacheline. */
-                uint64_t *lineMap;
+                uint64_t lineMap;
                 uint64_t lineMask;
-                uint64_t lineOffset; 
 
-                lineOffset = ((req->address.GetPhysicalAddress( ) >> 6) & 0xFFF) / 64;
-                lineMap = reinterpret_cast<uint64_t *>(cacheReq->data.rawData);
-                lineMask = (uint64_t)(1ULL << lineOffset);
+                lineMap = *reinterpret_cast<uint64_t *>(cacheReq->data.rawData);
+                lineMask = LineMask( req->address );
 
                 /* Check for this bit corresponding to this cache line. */
-                if( (*lineMap) & lineMask )
+                if( lineMap & lineMask )
                 {
 #ifdef DBGMISSMAP
                     std::cout << "Found cacheline in miss map, issuing to DRC." 
@@ -279,14 +326,7 @@ bool MissMap::RequestComplete( NVMainRequest *req )
 #endif
 
                     /* In DRC -- Issue to DRC. */
-                    uint64_t chan;
-
-                    cacheReq->originalRequest->address.GetTranslatedAddress( 
-                            NULL, NULL, NULL, NULL, &chan, NULL );
-
-                    assert( chan < numChannels );
-
-                    drcChannels[chan]->IssueCommand( cacheReq->originalRequest );
+                    drcCache->IssueCommand( cacheReq->originalRequest );
 
                     missMapHits++;
                 }
@@ -297,115 +337,30 @@ bool MissMap::RequestComplete( NVMainRequest *req )
                         << std::endl;
 #endif
 
-                    /* 
-                     *  Not in DRC -- Issue to main memory.
-                     *  Writes go to DRC since they don't miss.
-                     */
-                    if( cacheReq->originalRequest->type == READ )
-                    {
-                        cacheReq->originalRequest->tag = MISSMAP_MEMREAD;
-                        mainMemory->IssueCommand( cacheReq->originalRequest );
-                    }
-                    else
-                    {
-                        uint64_t chan;
-
-                        cacheReq->originalRequest->address.GetTranslatedAddress( 
-                                NULL, NULL, NULL, NULL, &chan, NULL );
-
-                        drcChannels[chan]->IssueCommand( cacheReq->originalRequest );
-                    }
+                    IssueMiss( cacheReq->originalRequest );
 
                     /* Write the new miss map line as well. */
-                    NVMainRequest *mmFill = new NVMainRequest( );
-                    CacheRequest *fillCReq = new CacheRequest( );
-
-                    *lineMap |= (uint64_t)(1ULL << lineOffset);
-                    fillCReq->data.rawData = reinterpret_cast<uint8_t *>( lineMap );
-
-                    fillCReq->optype = CACHE_WRITE;
-                    fillCReq->address = req->address; 
-                    /* Use the PAGE ADDRESS for the miss map */
-                    fillCReq->address.SetPhysicalAddress( 
-                            (fillCReq->address.GetPhysicalAddress( ) >> 6) >> 12 ); 
-                    fillCReq->owner = this;
-                    fillCReq->originalRequest = NULL;
-
-                    *mmFill = *req;
-                    mmFill->owner = this;
-                    mmFill->reqInfo = static_cast<void *>( fillCReq );
-                    mmFill->tag = MISSMAP_WRITE;
-
-                    missMapWrites++;
-                    missMapMisses++;
+                    QueueFill( req, lineMap | lineMask );
 
-                    missMapFillQueue.push( mmFill );
+                    missMapMisses++;
 
-#ifdef DBGMISSMAP
-                    std::cout << "Updating miss map entry 0x" 
-                        << fillCReq->address.GetPhysicalAddress( )
-                        << " with bit vector 0x" << std::hex << (*lineMap) 
-                        << std::dec << std::endl;
-#endif
+                    if( missFilter )
+                        filterFalsePositives++;
                 }
             }
             /* No miss map entry for this page. */
             else
             {
-                /* 
-                 *  Not in DRC -- Issue to main memory.
-                 *  Writes go to DRC since they don't miss.
-                 */
-                if( cacheReq->originalRequest->type == READ )
-                {
-                    cacheReq->originalRequest->tag = MISSMAP_MEMREAD;
-                    mainMemory->IssueCommand( cacheReq->originalRequest );
-                }
-                else
-                {
-                    uint64_t chan;
-
-                    cacheReq->originalRequest->address.GetTranslatedAddress( 
-                            NULL, NULL, NULL, NULL, &chan, NULL );
-
-                    drcChannels[chan]->IssueCommand( cacheReq->originalRequest );
-                }
+                IssueMiss( cacheReq->originalRequest );
 
                 /* Install this line to MissMap. */
-                NVMainRequest *mmFill = new NVMainRequest( );
-                CacheRequest *fillCReq = new CacheRequest( );
-                uint64_t lineOffset = ((req->address.GetPhysicalAddress( ) >> 6) & 0xFFF) / 64;
-                uint64_t *lineMap = new uint64_t;
-
-                *lineMap = 0;
-                *lineMap |= (uint64_t)(1ULL << lineOffset);
-                fillCReq->data.rawData = reinterpret_cast<uint8_t *>(lineMap);
-
-                fillCReq->optype = CACHE_WRITE;
-                fillCReq->address = req->address; 
-                /* Use the PAGE ADDRESS for the miss map */
-                fillCReq->address.SetPhysicalAddress( 
-                        (fillCReq->address.GetPhysicalAddress( ) >> 6) >> 12 ); 
-                fillCReq->owner = this;
-                fillCReq->originalRequest = NULL;
-
-                *mmFill = *req;
-                mmFill->owner = this;
-                mmFill->reqInfo = static_cast<void *>( fillCReq );
-                mmFill->tag = MISSMAP_WRITE;
+                QueueFill( req, LineMask( req->address ) );
 
                 missMapAllocations++;
-                missMapWrites++;
                 missMapMisses++;
 
-                missMapFillQueue.push( mmFill );
-
-#ifdef DBGMISSMAP
-                std::cout << "Adding new miss map entry 0x" 
-                    << fillCReq->address.GetPhysicalAddress( )
-                    << " with bit vector 0x" << std::hex << (*lineMap) 
-                    << std::dec << std::endl;
-#endif
+                if( missFilter )
+                    filterFalsePositives++;
             }
 
             delete cacheReq;
@@ -419,84 +374,244 @@ bool MissMap::RequestComplete( NVMainRequest *req )
             std::cout << "Wrote to the miss map." << std::endl;
 #endif
 
-            /* Check if there was an eviction. */
+            /* 
+             *  Count the lines of an evicted entry. The LO_Cache cannot drop
+             *  them, so they stay cached until replaced. IssueMiss checks the
+             *  cache before going to main memory, so they are not refetched.
+             */
             if( creq->optype == CACHE_EVICT )
             {
-                /* Ensure consistency in DRC by evicting any cachelines in this miss map entry. */
-                uint64_t chan;
+#ifdef DBGMISSMAP
+                std::cout << "Miss map evicted a line.." << std::endl;
+#endif
 
-                req->address.GetTranslatedAddress( NULL, NULL, NULL, NULL, &chan, NULL );
-                assert( chan < numChannels );
+                uint64_t lineMap = *reinterpret_cast<uint64_t *>(creq->data.rawData);
 
-                NVMainRequest *evictReq = new NVMainRequest( );
+                missMapForceEvicts += RemoveLines( creq->address, lineMap );
+            }
 
-                *evictReq = *req;
-                evictReq->owner = this;
-                evictReq->tag = MISSMAP_FORCE_EVICT;
+            delete creq;
+        }
+        /* The line was read from main memory, so fill it in the DRAM cache. */
+        else if( req->tag == MISSMAP_MEMREAD )
+        {
+            NVMainRequest *originalRequest = static_cast<NVMainRequest *>( req->reqInfo );
 
 #ifdef DBGMISSMAP
-                std::cout << "Miss map evicted a line.." << std::endl;
+            std::cout << "MissMap memory access returned, filling DRAM cache. " 
+                << std::endl;
 #endif
 
-                /* Count the number of cachelines being evicted. */
-                uint64_t *lineMap = reinterpret_cast<uint64_t *>(creq->data.rawData);
-                uint64_t lineCount = 0;
-
-                for( int i = 0; i < 64; i++ )
-                {
-                    if( *lineMap & 0x1 )
-                        lineCount++;
+            GetParent( )->RequestComplete( originalRequest );
 
-                    *lineMap >>= 1;
-                }
+            /* Main memory's command flags (e.g., issued) do not apply here. */
+            req->type = WRITE;
+            req->tag = 0;
+            req->flags = 0;
+            req->reqInfo = NULL;
+            req->arrivalCycle = GetEventQueue()->GetCurrentCycle();
 
-                missMapForceEvicts += lineCount;
+            drcCache->IssueCommand( req );
 
-                /* 
-                 * We should be able to delete this allocated memory at this 
-                 * point. 
-                 */
-                delete lineMap;
+            missMapMemReads++;
 
-                drcChannels[chan]->IssueCommand( evictReq );
-            }
-
-            delete creq;
+            return true;
         }
 
         delete req;
         rv = true;
     }
-    /* 
-     * MISSMAP_MEMREAD is a tagged request originating from the sequencer, 
-     * so we aren't the owner. 
+    /* Requests the DRAM cache sent to main memory. */
+    else if( drcCache->OwnsRequest( req ) )
+    {
+        rv = drcCache->RequestComplete( req );
+    }
+    /* Requests the DRAM cache completed are sent back to the requestor. */
+    else
+    {
+        rv = GetParent( )->RequestComplete( req );
+    }
+
+    return rv;
+}
+
+bool MissMap::OwnsRequest( NVMainRequest *req )
+{
+    return (req->owner == this || drcCache->OwnsRequest( req ));
+}
+
+/* 
+ *  The miss map entry address of a line. The miss map has a single row, so
+ *  the translated address (e.g., the DRAM cache row) is left unset.
+ */
+NVMAddress MissMap::PageAddress( NVMAddress& addr )
+{
+    NVMAddress pageAddr;
+
+    /* 6 = log2(cacheline size), 12 = log2(segment size) */
+    pageAddr.SetPhysicalAddress( (addr.GetPhysicalAddress( ) >> 6) >> 12 );
+
+    return pageAddr;
+}
+
+/* Each bit of a miss map entry covers one 4KB segment of its page. */
+uint64_t MissMap::LineMask( NVMAddress& addr )
+{
+    /* 6 = log2(cacheline size), 0xFFF = segment size - 1, 64 = 
+     * segment size / cacheline size 
      */
-    else if( req->tag == MISSMAP_MEMREAD )
+    uint64_t lineOffset = ((addr.GetPhysicalAddress( ) >> 6) & 0xFFF) / 64;
+
+    return (uint64_t)(1ULL << lineOffset);
+}
+
+/* The filter key of a line, i.e., its page address and line offset. */
+uint64_t MissMap::FilterKey( NVMAddress& addr )
+{
+    return (addr.GetPhysicalAddress( ) >> 12);
+}
+
+/* Removes the lines of an evicted entry and returns how many there were. */
+uint64_t MissMap::RemoveLines( NVMAddress& pageAddr, uint64_t lineMap )
+{
+    uint64_t lineCount = 0;
+
+    for( uint64_t i = 0; i < 64; i++ )
+    {
+        if( lineMap & (1ULL << i) )
+        {
+            if( missFilter )
+                missFilter->Remove( (pageAddr.GetPhysicalAddress( ) << 6) | i );
+
+            lineCount++;
+        }
+    }
+
+    return lineCount;
+}
+
+/* 
+ *  Not in DRC -- Issue to main memory.
+ *  Writes go to DRC since they don't miss, and so do lines that are still
+ *  cached after their miss map entry was evicted.
+ */
+void MissMap::IssueMiss( NVMainRequest *request )
+{
+    if( request->type == READ && !drcCache->IssueFunctional( request ) )
+    {
+        NVMainRequest *memReq = new NVMainRequest( );
+
+        *memReq = *request;
+        memReq->owner = this;
+        memReq->tag = MISSMAP_MEMREAD;
+        memReq->reqInfo = static_cast<void *>( request );
+        memReq->arrivalCycle = GetEventQueue()->GetCurrentCycle();
+
+        IssueMainMemory( memReq );
+    }
+    else
     {
-        uint64_t chan;
+        drcCache->IssueCommand( request );
+    }
+}
 
-        req->address.GetTranslatedAddress( NULL, NULL, NULL, NULL, &chan, NULL );
+void MissMap::IssueMainMemory( NVMainRequest *memReq )
+{
+    if( mainMemory->IsIssuable( memReq, NULL ) ) 
+        mainMemory->IssueCommand( memReq );
+    else
+        mainMemory->EnqueuePendingMemoryRequests( memReq );
+}
 
-        // This is now a fill request.
-        req->type = WRITE;
-        req->tag = 0;
+/* Queue a write of the miss map entry for req's page with the new lineMap. */
+void MissMap::QueueFill( NVMainRequest *req, uint64_t lineMap )
+{
+    NVMainRequest *mmFill = new NVMainRequest( );
+    CacheRequest *fillCReq = new CacheRequest( );
+
+    fillCReq->data.SetSize( sizeof(uint64_t) );
+    *reinterpret_cast<uint64_t *>(fillCReq->data.rawData) = lineMap;
+
+    fillCReq->optype = CACHE_WRITE;
+    /* Use the PAGE ADDRESS for the miss map */
+    fillCReq->address = PageAddress( req->address ); 
+    fillCReq->owner = this;
+    fillCReq->originalRequest = NULL;
+
+    *mmFill = *req;
+    mmFill->owner = this;
+    mmFill->reqInfo = static_cast<void *>( fillCReq );
+    mmFill->tag = MISSMAP_WRITE;
+
+    missMapWrites++;
+
+    /* Add the line now so the filter never misses a line that is cached. */
+    if( missFilter )
+        missFilter->Insert( FilterKey( req->address ) );
+
+    missMapFillQueue.push( mmFill );
+    ScheduleIssue( );
 
 #ifdef DBGMISSMAP
-        std::cout << "MissMap memory access returned, filling DRAM cache. " 
-            << std::endl;
+    std::cout << "Updating miss map entry 0x" 
+        << fillCReq->address.GetPhysicalAddress( )
+        << " with bit vector 0x" << std::hex << lineMap 
+        << std::dec << std::endl;
 #endif
+}
 
-        drcChannels[chan]->IssueCommand( req );
+/*
+ *  The filter has never seen this line, so it is certainly not in the DRAM
+ *  cache. Skip the miss map probe and only queue the write of its entry.
+ */
+void MissMap::BypassMissMap( NVMainRequest *req )
+{
+    NVMAddress pageAddr = PageAddress( req->address );
+    uint64_t lineMap = 0;
 
-        missMapMemReads++;
+    if( missMap->Present( pageAddr ) )
+    {
+        NVMDataBlock data;
 
-        rv = false;
+        missMap->Read( pageAddr, &data );
+        lineMap = *reinterpret_cast<uint64_t *>(data.rawData);
+    }
+    else
+    {
+        missMapAllocations++;
     }
 
-    return rv;
+    QueueFill( req, lineMap | LineMask( req->address ) );
+    IssueMiss( req );
+
+    missMapMisses++;
+    filterBypasses++;
+}
+
+void MissMap::Cycle( ncycle_t steps )
+{
+    drcCache->Cycle( steps );
+
+    IssueCallback( NULL );
+}
+
+/*
+ *  Variants are not cycled every cycle, since the controllers wake on their
+ *  own events. The miss map schedules a callback after it gets work.
+ */
+void MissMap::ScheduleIssue( )
+{
+    ncycle_t nextIssue = GetEventQueue( )->GetCurrentCycle( ) + 1;
+
+    if( !GetEventQueue( )->FindCallback( this, (CallbackPtr)&MissMap::IssueCallback, 
+                                         nextIssue, NULL ) )
+    {
+        GetEventQueue( )->InsertCallback( this, (CallbackPtr)&MissMap::IssueCallback,
+                                          nextIssue, NULL );
+    }
 }
 
-void MissMap::Cycle( ncycle_t )
+void MissMap::IssueCallback( void * /*data*/ )
 {
     /* Issue MissMap commands */
     if( missMap && (!missMapQueue.empty( ) || !missMapFillQueue.empty()) )
@@ -531,4 +646,16 @@ void MissMap::Cycle( ncycle_t )
 
 void MissMap::CalculateStats( )
 {
+    drcCache->CalculateStats( );
+
+    filterFalsePositiveRate = 0.0;
+    if( filterBypasses + filterFalsePositives > 0 )
+        filterFalsePositiveRate = static_cast<double>(filterFalsePositives)
+                                / static_cast<double>(filterBypasses + filterFalsePositives);
+
+    /* Each bypass saves the mean time of a probe through the miss map queue. */
+    filterCyclesSaved = 0;
+    if( missMapHits + missMapMisses > filterBypasses )
+        filterCyclesSaved = filterBypasses * probeCycles 
+                          / (missMapHits + missMapMisses - filterBypasses);
 }
@@ -35,36 +35,45 @@
 #define __UTILS_MISSMAP_H__
 
 #include "Utils/Caches/CacheBank.h"
+#include "Utils/Caches/CountingBloomFilter.h"
 #include "src/Config.h"
-#include "src/MemoryController.h"
+#include "MemControl/DRAMCache/AbstractDRAMCache.h"
 #include "MemControl/MemoryControllerFactory.h"
 #include <queue>
 
 namespace NVM {
 
-#define MISSMAP_READ        tagGen->CreateTag("MISSMAP_READ")
-#define MISSMAP_WRITE       tagGen->CreateTag("MISSMAP_WRITE")
-#define MISSMAP_MEMREAD     tagGen->CreateTag("MISSMAP_MEMREAD")
-#define MISSMAP_FORCE_EVICT tagGen->CreateTag("MISSMAP_FORCE_EVICT")
+#define MISSMAP_READ        TAG_MISSMAP_READ
+#define MISSMAP_WRITE       TAG_MISSMAP_WRITE
+#define MISSMAP_MEMREAD     TAG_MISSMAP_MEMREAD
 
 class NVMain;
-class LH_Cache;
 
-class MissMap : public MemoryController
+/*
+ *  DRAM cache variant (DRCVariant MissMap) that keeps a MissMap of the lines
+ *  in an LO_Cache. Reads the MissMap does not have go to main memory without
+ *  probing the DRAM cache, and the line is filled afterwards.
+ */
+class MissMap : public AbstractDRAMCache
 {
   public:
     MissMap( );
     ~MissMap( );
 
     void SetConfig( Config *conf, bool createChildren = true );
+    void SetMainMemory( NVMain *mm );
 
     bool QueueFull( NVMainRequest *request );
 
     bool IssueAtomic( NVMainRequest *req );
     bool IssueCommand( NVMainRequest *req );
+    bool IssueFunctional( NVMainRequest *req );
+    bool IsIssuable( NVMainRequest *request, FailReason *reason = NULL );
     bool RequestComplete( NVMainRequest *req );
+    bool OwnsRequest( NVMainRequest *req );
 
     void Cycle( ncycle_t );
+    void IssueCallback( void *data );
 
     void RegisterStats( );
     void CalculateStats( );
@@ -76,14 +85,29 @@ class MissMap : public MemoryController
     uint64_t missMapQueueSize;
 
     NVMain *mainMemory;
-    LH_Cache **drcChannels;
-    ncounter_t numChannels;
+    AbstractDRAMCache *drcCache;
 
     /* Stats. */
     uint64_t missMapAllocations, missMapWrites;
     uint64_t missMapHits, missMapMisses;
     uint64_t missMapForceEvicts;
     uint64_t missMapMemReads;
+
+    /* Lines that may be in the DRAM cache, or NULL if not used. */
+    CountingBloomFilter *missFilter;
+    uint64_t filterBypasses, filterFalsePositives;
+    double filterFalsePositiveRate;
+    uint64_t probeCycles, filterCyclesSaved;
+
+    NVMAddress PageAddress( NVMAddress& addr );
+    uint64_t LineMask( NVMAddress& addr );
+    uint64_t FilterKey( NVMAddress& addr );
+    uint64_t RemoveLines( NVMAddress& pageAddr, uint64_t lineMap );
+    void IssueMiss( NVMainRequest *request );
+    void IssueMainMemory( NVMainRequest *memReq );
+    void QueueFill( NVMainRequest *req, uint64_t lineMap );
+    void BypassMissMap( NVMainRequest *req );
+    void ScheduleIssue( );
 };
 
 };
@@ -66,6 +66,10 @@ NVMain::NVMain( )
     prefetcher = NULL;
     successfulPrefetches = 0;
     unsuccessfulPrefetches = 0;
+    issuedPrefetches = 0;
+    droppedPrefetches = 0;
+    duplicatePrefetches = 0;
+    prefetchAccuracy = 0.0;
     for(int i= 0 ; i<9 ; i++){
         updateColumns[i] = 0;
     }
@@ -82,6 +86,10 @@ NVMain::NVMain( )
 
 NVMain::~NVMain( )
 {
+    /* Flushes any buffered trace output. */
+    if( preTracer )
+        delete preTracer;
+
     if( config ) 
         delete config;
     
@@ -99,6 +107,10 @@ NVMain::~NVMain( )
     if( translator )
         delete translator;
 
+    std::list<NVMainRequest *>::iterator it;
+    for( it = prefetchBuffer.begin( ); it != prefetchBuffer.end( ); it++ )
+        delete (*it);
+
     if( channelConfig )
     {
         for( unsigned int i = 0; i < numChannels; i++ )
@@ -249,10 +261,18 @@ void NVMain::SetConfig( Config *conf, std::string memoryName, bool createChildre
 
         std::cout << "Using trace file " << pretraceFile << std::endl;
 
-        if( config->GetString( "PreTraceWriter" ) == "" )
+        /* 
+         *  Traces are written in the compact binary format by default. The
+         *  text format is used when the trace is echoed to the console.
+         */
+        if( config->GetString( "PreTraceWriter" ) != "" )
+            preTracer = TraceWriterFactory::CreateNewTraceWriter( config->GetString( "PreTraceWriter" ) );
+        else if( p->EchoPreTrace )
             preTracer = TraceWriterFactory::CreateNewTraceWriter( "NVMainTrace" );
         else
-            preTracer = TraceWriterFactory::CreateNewTraceWriter( config->GetString( "PreTraceWriter" ) );
+            preTracer = TraceWriterFactory::CreateNewTraceWriter( "BinaryTrace" );
+
+        preTracer->Init( config );
 
         if( p->PrintPreTrace )
             preTracer->SetTraceFile( pretraceFile );
@@ -271,14 +291,16 @@ bool NVMain::IsIssuable( NVMainRequest *request, FailReason *reason )
     assert( request != NULL );
 
     GetDecoder( )->Translate( request->address.GetPhysicalAddress( ), 
-                           &row, &col, &rank, &bank, &channel, &subarray );
+                           &row, &col, &bank, &rank, &channel, &subarray );
 
-    rv = memoryControllers[channel]->IsIssuable( request, reason );
+    /* Go through the hooks so they can hold requests back as well. */
+    rv = GetChild( channel )->IsIssuable( request, reason );
 
     return rv;
 }
 
-void NVMain::GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>& prefetchList )
+void NVMain::GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>& prefetchList,
+                                 bool atomic )
 {
     std::vector<NVMAddress>::iterator iter;
     ncounter_t channel, rank, bank, row, col, subarray;
@@ -292,21 +314,36 @@ void NVMain::GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>
         pfRequest->isPrefetch = true;
         pfRequest->owner = this;
         
-        /* Translate the address, then copy to the address struct, and copy to request. */
-        GetDecoder( )->Translate( request->address.GetPhysicalAddress( ), 
+        /* Translate the prefetch address, then copy to the address struct. */
+        GetDecoder( )->Translate( pfRequest->address.GetPhysicalAddress( ), 
                                &row, &col, &bank, &rank, &channel, &subarray );
-        request->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
-        request->bulkCmd = CMD_NOP;
+        pfRequest->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+        pfRequest->bulkCmd = CMD_NOP;
 
         //std::cout << "Prefetching 0x" << std::hex << (*iter).GetPhysicalAddress() << " (trigger 0x"
         //          << request->address.GetPhysicalAddress( ) << std::dec << std::endl;
 
-        /* Just type to issue; If the queue is full it simply won't be enqueued. */
-        GetChild( pfRequest )->IssueCommand( pfRequest );
+        if( atomic )
+        {
+            /* Functional prefetch: The data arrives in the buffer immediately. */
+            GetChild( pfRequest )->IssueAtomic( pfRequest );
+            BufferPrefetch( pfRequest );
+            issuedPrefetches++;
+        }
+        /* Just try to issue; If the queue is full it simply won't be enqueued. */
+        else if( GetChild( pfRequest )->IssueCommand( pfRequest ) )
+        {
+            issuedPrefetches++;
+        }
+        else
+        {
+            droppedPrefetches++;
+            delete pfRequest;
+        }
     }
 }
 
-void NVMain::IssuePrefetch( NVMainRequest *request )
+void NVMain::IssuePrefetch( NVMainRequest *request, bool atomic )
 {
     /* 
      *  Generate prefetches here. It makes the most sense to prefetch in this class
@@ -319,43 +356,33 @@ void NVMain::IssuePrefetch( NVMainRequest *request )
     if( prefetcher && request->type == READ && request->isPrefetch == false 
         && prefetcher->DoPrefetch(request, prefetchList) )
     {
-        GeneratePrefetches( request, prefetchList );
+        GeneratePrefetches( request, prefetchList, atomic );
     }
 }
 
-bool NVMain::CheckPrefetch( NVMainRequest *request )
+bool NVMain::CheckPrefetch( NVMainRequest *request, bool atomic )
 {
-    bool rv = false;
-    NVMainRequest *pfRequest = NULL;
-    std::list<NVMainRequest *>::const_iterator iter;
+    std::unordered_map<uint64_t, std::list<NVMainRequest *>::iterator>::iterator it;
     std::vector<NVMAddress> prefetchList;
 
-    for( iter = prefetchBuffer.begin(); iter!= prefetchBuffer.end(); iter++ )
-    {
-        if( (*iter)->address.GetPhysicalAddress() == request->address.GetPhysicalAddress() )
-        {
-            if( prefetcher->NotifyAccess(request, prefetchList) )
-            {
-                GeneratePrefetches( request, prefetchList );
-            }
+    it = prefetchIndex.find( request->address.GetPhysicalAddress() );
 
-            successfulPrefetches++;
-            rv = true;
-            pfRequest = (*iter);
-            delete pfRequest;
-            break;
-        }
-    }
+    if( it == prefetchIndex.end( ) )
+        return false;
+
+    /* A prefetch is used once, so remove it before prefetching further. */
+    delete *(it->second);
+    prefetchBuffer.erase( it->second );
+    prefetchIndex.erase( it );
+
+    successfulPrefetches++;
 
-    if( pfRequest != NULL )
+    if( prefetcher->NotifyAccess(request, prefetchList) )
     {
-        //std::cout << "Prefetched 0x" << std::hex << request->address.GetPhysicalAddress( )
-        //          << std::dec << " (list size " << prefetchBuffer.size() << " -> ";
-        prefetchBuffer.remove( pfRequest );
-        //std::cout << prefetchBuffer.size() << ")" << std::endl;
+        GeneratePrefetches( request, prefetchList, atomic );
     }
 
-    return rv;
+    return true;
 }
 
 void NVMain::PrintPreTrace( NVMainRequest *request )
@@ -379,6 +406,12 @@ void NVMain::PrintPreTrace( NVMainRequest *request )
     }
 }
 
+void NVMain::FlushPreTrace( )
+{
+    if( preTracer )
+        preTracer->Flush( );
+}
+
 bool NVMain::IssueCommand( NVMainRequest *request )
 {
     ncounter_t channel, rank, bank, row, col, subarray;
@@ -1158,15 +1191,16 @@ bool NVMain::IssueAtomic( NVMainRequest *request )
     request->bulkCmd = CMD_NOP;
 
     /* Check for any successful prefetches. */
-    if( CheckPrefetch( request ) )
+    if( CheckPrefetch( request, true ) )
     {
         return true;
     }
 
-    mc_rv = memoryControllers[channel]->IssueAtomic( request );
+    /* Go through the hooks so migration and other hook state is warmed up too. */
+    mc_rv = GetChild( request )->IssueAtomic( request );
     if( mc_rv == true )
     {
-        IssuePrefetch( request );
+        IssuePrefetch( request, true );
 
         if( request->type == READ ) 
         {
@@ -1191,23 +1225,7 @@ bool NVMain::RequestComplete( NVMainRequest *request )
     {
         if( request->isPrefetch )
         {
-            //std::cout << "Placing 0x" << std::hex << request->address.GetPhysicalAddress( )
-            //          << std::dec << " into prefetch buffer (cur size: " << prefetchBuffer.size( )
-            //          << ")." << std::endl;
-
-            /* Place in prefetch buffer. */
-            if( prefetchBuffer.size() >= p->PrefetchBufferSize )
-            {
-                unsuccessfulPrefetches++;
-                //std::cout << "Prefetch buffer is full. Removing oldest prefetch: 0x" << std::hex
-                //          << prefetchBuffer.front()->address.GetPhysicalAddress() << std::dec
-                //          << std::endl;
-
-                delete prefetchBuffer.front();
-                prefetchBuffer.pop_front();
-            }
-
-            prefetchBuffer.push_back( request );
+            BufferPrefetch( request );
             rv = true;
         }
         else
@@ -1235,6 +1253,48 @@ bool NVMain::RequestComplete( NVMainRequest *request )
     return rv;
 }
 
+void NVMain::BufferPrefetch( NVMainRequest *request )
+{
+    std::unordered_map<uint64_t, std::list<NVMainRequest *>::iterator>::iterator it;
+    uint64_t address = request->address.GetPhysicalAddress( );
+
+    //std::cout << "Placing 0x" << std::hex << request->address.GetPhysicalAddress( )
+    //          << std::dec << " into prefetch buffer (cur size: " << prefetchBuffer.size( )
+    //          << ")." << std::endl;
+
+    /* Already buffered, so just make the existing entry the most recently used. */
+    it = prefetchIndex.find( address );
+    if( it != prefetchIndex.end( ) )
+    {
+        prefetchBuffer.splice( prefetchBuffer.end( ), prefetchBuffer, it->second );
+        duplicatePrefetches++;
+        delete request;
+        return;
+    }
+
+    if( p->PrefetchBufferSize == 0 )
+    {
+        unsuccessfulPrefetches++;
+        delete request;
+        return;
+    }
+
+    /* Place in prefetch buffer, evicting the least recently used prefetch. */
+    if( prefetchBuffer.size() >= p->PrefetchBufferSize )
+    {
+        unsuccessfulPrefetches++;
+        //std::cout << "Prefetch buffer is full. Removing oldest prefetch: 0x" << std::hex
+        //          << prefetchBuffer.front()->address.GetPhysicalAddress() << std::dec
+        //          << std::endl;
+
+        prefetchIndex.erase( prefetchBuffer.front()->address.GetPhysicalAddress() );
+        delete prefetchBuffer.front();
+        prefetchBuffer.pop_front();
+    }
+
+    prefetchIndex[address] = prefetchBuffer.insert( prefetchBuffer.end( ), request );
+}
+
 void NVMain::Cycle( ncycle_t /*steps*/ )
 {
 }
@@ -1245,6 +1305,10 @@ void NVMain::RegisterStats( )
     AddStat(totalWriteRequests);
     AddStat(successfulPrefetches);
     AddStat(unsuccessfulPrefetches);
+    AddStat(issuedPrefetches);
+    AddStat(droppedPrefetches);
+    AddStat(duplicatePrefetches);
+    AddStat(prefetchAccuracy);
     for(int i= 0 ; i<9 ; i++){
         AddNameStat(updateColumns[i], "updateColumns", std::to_string(i));
     }
@@ -1261,6 +1325,12 @@ void NVMain::RegisterStats( )
 
 void NVMain::CalculateStats( )
 {
+    /* Fraction of issued prefetches that were used before being evicted. */
+    prefetchAccuracy = 0.0;
+    if( issuedPrefetches > 0 )
+        prefetchAccuracy = static_cast<double>(successfulPrefetches)
+                         / static_cast<double>(issuedPrefetches);
+
     for( unsigned int i = 0; i < numChannels; i++ )
         memoryControllers[i]->CalculateStats( );
 }
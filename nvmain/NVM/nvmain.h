@@ -43,6 +43,8 @@
 #include "include/NVMainRequest.h"
 #include "traceWriter/GenericTraceWriter.h"
 #include <queue>
+#include <list>
+#include <unordered_map>
 
 namespace NVM {
 
@@ -64,7 +66,7 @@ class NVMain : public NVMObject
 
     Config *GetConfig( );
 
-    void IssuePrefetch( NVMainRequest *request );
+    void IssuePrefetch( NVMainRequest *request, bool atomic = false );
     bool IssueCommand( NVMainRequest *request );
     uint32_t BDI(uint8_t *cacheline, uint32_t data_size);
     uint32_t getDataSize(uint64_t data);
@@ -75,11 +77,13 @@ class NVMain : public NVMObject
 
     bool RequestComplete( NVMainRequest *request );
 
-    bool CheckPrefetch( NVMainRequest *request );
+    bool CheckPrefetch( NVMainRequest *request, bool atomic = false );
 
     void RegisterStats( );
     void CalculateStats( );
 
+    void FlushPreTrace( );
+
     void Cycle( ncycle_t steps );
 
     void EnqueuePendingMemoryRequests( NVMainRequest *request );
@@ -94,6 +98,10 @@ class NVMain : public NVMObject
     ncounter_t totalWriteRequests;
     ncounter_t successfulPrefetches;
     ncounter_t unsuccessfulPrefetches;
+    ncounter_t issuedPrefetches;
+    ncounter_t droppedPrefetches;
+    ncounter_t duplicatePrefetches;
+    double prefetchAccuracy;
     ncounter_t updateColumns[9];
     ncounter_t updateBit[64];
     ncounter_t compressByte[7];
@@ -105,14 +113,18 @@ class NVMain : public NVMObject
     double syncValue;
 
     Prefetcher *prefetcher;
+    /* Buffered prefetches from least to most recently used, indexed by address. */
     std::list<NVMainRequest *> prefetchBuffer;
+    std::unordered_map<uint64_t, std::list<NVMainRequest *>::iterator> prefetchIndex;
     std::queue<NVMainRequest *> pendingMemoryRequests;
 
     std::ofstream pretraceOutput;
     GenericTraceWriter *preTracer;
 
     void PrintPreTrace( NVMainRequest *request );
-    void GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>& prefetchList );
+    void GeneratePrefetches( NVMainRequest *request, std::vector<NVMAddress>& prefetchList,
+                             bool atomic = false );
+    void BufferPrefetch( NVMainRequest *request );
 
     bool do_verify = true;
 };
@@ -0,0 +1,215 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Ranks/BankGroupRank/BankGroupRank.h"
+#include "src/EventQueue.h"
+
+#include <iostream>
+
+using namespace NVM;
+
+BankGroupRank::BankGroupRank( )
+{
+    bankGroups = 1;
+    banksPerGroup = 0;
+
+    groupNextRead = NULL;
+    groupNextWrite = NULL;
+    groupNextActivate = NULL;
+
+    sameGroupWaits = 0;
+}
+
+BankGroupRank::~BankGroupRank( )
+{
+    delete [] groupNextRead;
+    delete [] groupNextWrite;
+    delete [] groupNextActivate;
+}
+
+void BankGroupRank::SetConfig( Config *c, bool createChildren )
+{
+    StandardRank::SetConfig( c, createChildren );
+
+    /* Params already fell back to one group if BANKS is not a multiple. */
+    bankGroups = p->BankGroups;
+    banksPerGroup = bankCount / bankGroups;
+
+    groupNextRead = new ncycle_t[bankGroups];
+    groupNextWrite = new ncycle_t[bankGroups];
+    groupNextActivate = new ncycle_t[bankGroups];
+
+    for( ncounter_t i = 0; i < bankGroups; i++ )
+    {
+        groupNextRead[i] = p->tCMD;
+        groupNextWrite[i] = p->tCMD;
+        groupNextActivate[i] = p->tCMD;
+    }
+}
+
+void BankGroupRank::RegisterStats( )
+{
+    StandardRank::RegisterStats( );
+
+    AddStat(sameGroupWaits);
+}
+
+ncounter_t BankGroupRank::GetBankGroup( ncounter_t bank )
+{
+    return bank / banksPerGroup;
+}
+
+bool BankGroupRank::Activate( NVMainRequest *request )
+{
+    bool rv = StandardRank::Activate( request );
+    ncounter_t group = GetBankGroup( request->address.GetBank( ) );
+
+    groupNextActivate[group] = MAX( groupNextActivate[group], 
+                                    GetEventQueue()->GetCurrentCycle() + p->tRRD_L );
+
+    return rv;
+}
+
+bool BankGroupRank::Read( NVMainRequest *request )
+{
+    bool rv = StandardRank::Read( request );
+    ncounter_t group = GetBankGroup( request->address.GetBank( ) );
+
+    groupNextRead[group] = MAX( groupNextRead[group], 
+                                GetEventQueue()->GetCurrentCycle() 
+                                + MAX( p->tBURST, p->tCCD_L ) * request->burstCount );
+
+    return rv;
+}
+
+bool BankGroupRank::Write( NVMainRequest *request )
+{
+    bool rv = StandardRank::Write( request );
+    ncounter_t group = GetBankGroup( request->address.GetBank( ) );
+
+    groupNextRead[group] = MAX( groupNextRead[group], 
+                                GetEventQueue()->GetCurrentCycle() 
+                                + MAX( p->tBURST, p->tCCD_L ) * (request->burstCount - 1)
+                                + p->tCWD + p->tBURST + p->tWTR_L );
+
+    groupNextWrite[group] = MAX( groupNextWrite[group], 
+                                 GetEventQueue()->GetCurrentCycle() 
+                                 + MAX( p->tBURST, p->tCCD_L ) * request->burstCount );
+
+    return rv;
+}
+
+bool BankGroupRank::Refresh( NVMainRequest *request )
+{
+    ncounter_t bankHead = request->address.GetBank( );
+
+    bool rv = StandardRank::Refresh( request );
+
+    /* As in StandardRank, a refresh counts as an activation in each bank. */
+    for( ncounter_t i = 0; i < banksPerRefresh; i++ )
+    {
+        ncounter_t group = GetBankGroup( GetRefreshBank( bankHead, i ) );
+
+        groupNextActivate[group] = MAX( groupNextActivate[group], 
+                                        GetEventQueue()->GetCurrentCycle() + p->tRRD_L );
+    }
+
+    return rv;
+}
+
+/*
+ *  Returns the earliest cycle the bank group(s) of the request allow it,
+ *  or 0 for commands without bank group timing.
+ */
+ncycle_t BankGroupRank::GroupNextIssuable( NVMainRequest *request )
+{
+    ncycle_t nextCompare = 0;
+    ncounter_t bank = request->address.GetBank( );
+
+    if( request->type == ACTIVATE ) 
+    {
+        nextCompare = groupNextActivate[GetBankGroup( bank )];
+    }
+    else if( request->type == READ || request->type == READ_PRECHARGE ) 
+    {
+        nextCompare = groupNextRead[GetBankGroup( bank )];
+    }
+    else if( request->type == WRITE || request->type == WRITE_PRECHARGE ) 
+    {
+        nextCompare = groupNextWrite[GetBankGroup( bank )];
+    }
+    else if( request->type == REFRESH )
+    {
+        for( ncounter_t i = 0; i < banksPerRefresh; i++ )
+        {
+            ncounter_t group = GetBankGroup( GetRefreshBank( bank, i ) );
+
+            nextCompare = MAX( nextCompare, groupNextActivate[group] );
+        }
+    }
+
+    return nextCompare;
+}
+
+ncycle_t BankGroupRank::NextIssuable( NVMainRequest *request )
+{
+    return MAX( StandardRank::NextIssuable( request ), 
+                GroupNextIssuable( request ) );
+}
+
+bool BankGroupRank::IsIssuable( NVMainRequest *request, FailReason *reason )
+{
+    /* Let the rank and its banks check (and count) their own timings first. */
+    if( !StandardRank::IsIssuable( request, reason ) )
+        return false;
+
+    if( GroupNextIssuable( request ) > GetEventQueue( )->GetCurrentCycle( ) )
+    {
+        /* 
+         *  Only the bank group holds this command. Count each command once,
+         *  since the scheduler asks again every cycle.
+         */
+        if( (request->flags & NVMainRequest::FLAG_GROUP_WAIT) == 0 )
+        {
+            request->flags |= NVMainRequest::FLAG_GROUP_WAIT;
+            sameGroupWaits++;
+        }
+
+        if( reason ) 
+            reason->reason = RANK_TIMING;
+
+        return false;
+    }
+
+    return true;
+}
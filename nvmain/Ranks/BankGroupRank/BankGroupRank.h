@@ -0,0 +1,83 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __BANKGROUPRANK_H__
+#define __BANKGROUPRANK_H__
+
+#include "Ranks/StandardRank/StandardRank.h"
+
+namespace NVM {
+
+/*
+ *  A DDR4/DDR5 rank whose banks are split into BankGroups bank groups of
+ *  consecutive banks. Back-to-back commands to the same bank group must
+ *  meet the long timings (tCCD_L, tRRD_L, tWTR_L), while the rank-wide
+ *  timings of StandardRank (tCCD, tRRDR, tWTR) are the short ones. Banks
+ *  need no changes, since the same bank is always in the same group.
+ */
+class BankGroupRank : public StandardRank
+{
+  public:
+    BankGroupRank( );
+    ~BankGroupRank( );
+
+    void SetConfig( Config *c, bool createChildren = true );
+
+    bool IsIssuable( NVMainRequest *request, FailReason *reason = NULL );
+    ncycle_t NextIssuable( NVMainRequest *request );
+
+    void RegisterStats( );
+
+  protected:
+    ncounter_t bankGroups;
+    ncounter_t banksPerGroup;
+
+    ncycle_t *groupNextRead;
+    ncycle_t *groupNextWrite;
+    ncycle_t *groupNextActivate;
+
+    /* Commands held back only by the same group timings. */
+    ncounter_t sameGroupWaits;
+
+    bool Activate( NVMainRequest *request );
+    bool Read( NVMainRequest *request );
+    bool Write( NVMainRequest *request );
+    bool Refresh( NVMainRequest *request );
+
+    ncounter_t GetBankGroup( ncounter_t bank );
+    ncycle_t GroupNextIssuable( NVMainRequest *request );
+};
+
+};
+
+#endif
@@ -36,6 +36,7 @@
 
 /* Add your decoder's include file below. */
 #include "Ranks/StandardRank/StandardRank.h"
+#include "Ranks/BankGroupRank/BankGroupRank.h"
 
 using namespace NVM;
 
@@ -44,6 +45,7 @@ Rank *RankFactory::CreateRank( std::string rankName )
     Rank *rank = NULL;
 
     if( rankName == "StandardRank" ) rank = new StandardRank( );
+    else if( rankName == "BankGroupRank" ) rank = new BankGroupRank( );
     //else if( rankName == "CachedRank" ) rank = new CachedRank( );
 
     return rank;
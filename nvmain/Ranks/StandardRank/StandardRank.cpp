@@ -36,6 +36,7 @@
 #include "Ranks/StandardRank/StandardRank.h"
 #include "src/EventQueue.h"
 #include "Banks/BankFactory.h"
+#include "src/ConfigSchema.h"
 
 #include <iostream>
 #include <sstream>
@@ -99,6 +100,11 @@ StandardRank::~StandardRank( )
 
 void StandardRank::SetConfig( Config *c, bool createChildren )
 {
+    /* Resolved once, since every rank reads these. */
+    static const ConfigKey rawKey( "RAW" );
+    static const ConfigKey decoderKey( "Decoder" );
+    static const ConfigKey bankTypeKey( "BankType" );
+
     conf = c;
 
     Params *params = new Params( );
@@ -110,7 +116,7 @@ void StandardRank::SetConfig( Config *c, bool createChildren )
 
     banksPerRefresh = p->BanksPerRefresh;
 
-    if( conf->GetValue( "RAW" ) == -1 )
+    if( !conf->KeyExists( rawKey ) )
     {
         std::cout << "NVMain Warning: RAW (Row Activation Window) is not "
             << "specified. Has set it to 4 (FAW)" << std::endl;
@@ -134,7 +140,7 @@ void StandardRank::SetConfig( Config *c, bool createChildren )
     if( createChildren )
     {
         /* When selecting a child, use the bank field from the decoder. */
-        AddressTranslator *rankAT = DecoderFactory::CreateDecoderNoWarn( conf->GetString( "Decoder" ) );
+        AddressTranslator *rankAT = DecoderFactory::CreateDecoderNoWarn( conf->GetString( decoderKey ) );
         rankAT->SetTranslationMethod( GetParent( )->GetTrampoline( )->GetDecoder( )->GetTranslationMethod( ) );
         rankAT->SetDefaultField( BANK_FIELD );
         rankAT->SetConfig( c, createChildren );
@@ -147,7 +153,7 @@ void StandardRank::SetConfig( Config *c, bool createChildren )
         {
             std::stringstream formatter;
 
-            Bank *nextBank = BankFactory::CreateBankNoWarn( conf->GetString( "BankType" ) );
+            Bank *nextBank = BankFactory::CreateBankNoWarn( conf->GetString( bankTypeKey ) );
 
             formatter << i;
             nextBank->SetId( i );
@@ -579,13 +585,13 @@ bool StandardRank::Refresh( NVMainRequest *request )
     request->address.GetTranslatedAddress( 
             NULL, NULL, &refreshBankGroupHead, NULL, NULL, NULL );
 
-    assert( (refreshBankGroupHead + banksPerRefresh) <= bankCount );
+    assert( GetRefreshBank( refreshBankGroupHead, banksPerRefresh - 1 ) < bankCount );
 
     for( ncounter_t i = 0; i < banksPerRefresh; i++ )
     {
         NVMainRequest* refReq = new NVMainRequest;
         *refReq = *request;
-        GetChild( refreshBankGroupHead+i )->IssueCommand( refReq );
+        GetChild( GetRefreshBank( refreshBankGroupHead, i ) )->IssueCommand( refReq );
     }
 
     state = STANDARDRANK_REFRESHING;
@@ -606,6 +612,18 @@ bool StandardRank::Refresh( NVMainRequest *request )
     return true;
 }
 
+/*
+ *  Returns the index-th bank refreshed along with bankHead. These are
+ *  consecutive banks, or with SameBankRefresh the same bank in each bank group.
+ */
+ncounter_t StandardRank::GetRefreshBank( ncounter_t bankHead, ncounter_t index )
+{
+    if( p->SameBankRefresh )
+        return bankHead + index * ( bankCount / p->BankGroups );
+
+    return bankHead + index;
+}
+
 ncycle_t StandardRank::NextIssuable( NVMainRequest *request )
 {
     ncycle_t nextCompare = 0;
@@ -744,11 +762,11 @@ bool StandardRank::IsIssuable( NVMainRequest *req, FailReason *reason )
         }
 
         /* REFRESH can only be issued when all banks in the group are issuable */ 
-        assert( (opBank + banksPerRefresh) <= bankCount );
+        assert( GetRefreshBank( opBank, banksPerRefresh - 1 ) < bankCount );
 
         for( ncounter_t i = 0; i < banksPerRefresh; i++ )
         {
-            rv = GetChild( opBank + i )->IsIssuable( req, reason );
+            rv = GetChild( GetRefreshBank( opBank, i ) )->IsIssuable( req, reason );
             if( rv == false )
                 return rv;
         }
@@ -1028,5 +1046,7 @@ void StandardRank::CalculateStats( )
 void StandardRank::ResetStats( )
 {
     lastReset = GetEventQueue()->GetCurrentCycle();
+
+    NVMObject::ResetStats( );
 }
 
@@ -135,15 +135,17 @@ class StandardRank : public Rank
     double totalEnergy, backgroundEnergy, activateEnergy, burstEnergy, refreshEnergy;
     double totalPower, backgroundPower, activatePower, burstPower, refreshPower;
 
-    bool Activate( NVMainRequest *request );
-    bool Read( NVMainRequest *request );
-    bool Write( NVMainRequest *request );
+    virtual bool Activate( NVMainRequest *request );
+    virtual bool Read( NVMainRequest *request );
+    virtual bool Write( NVMainRequest *request );
     bool Precharge( NVMainRequest *request );
-    bool Refresh( NVMainRequest *request );
+    virtual bool Refresh( NVMainRequest *request );
     bool PowerDown( NVMainRequest *request );
     bool PowerUp( NVMainRequest *request );
     bool CanPowerDown( NVMainRequest *request );
     bool CanPowerUp( NVMainRequest *request );
+
+    ncounter_t GetRefreshBank( ncounter_t bankHead, ncounter_t index );
 };
 
 };
@@ -45,7 +45,8 @@ class NVMainMemory(AbstractMemory):
     config = Param.String("", "")
     configparams = Param.String("", "")
     configvalues = Param.String("", "")
-    NVMainWarmUp = Param.Bool(False, "Enable to warm up the internal cache in NVMain")
+    NVMainWarmUp = Param.Bool(False, "Enable to functionally warm up NVMain caches, migration, prefetch and endurance state in atomic mode")
+    independent = Param.Bool(False, "Enable to give this memory its own NVMain channels and event queue instead of sharing the first instance's")
 
 
     def __init__(self, *args, **kwargs):
@@ -72,6 +73,8 @@ class NVMainMemory(AbstractMemory):
                     self.atomic_variance = param_value
                 elif param_name == "warmup":
                     self.NVMainWarmUp = True
+                elif param_name == "independent":
+                    self.independent = True
                 elif param_name == "config":
                     self.config = param_value
                 else:
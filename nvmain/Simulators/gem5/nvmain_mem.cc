@@ -42,6 +42,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "SimInterface/Gem5Interface/Gem5Interface.h"
 #include "Simulators/gem5/nvmain_mem.hh"
 #include "Utils/HookFactory.h"
@@ -50,7 +52,6 @@
 #include "base/statistics.hh"
 #include "debug/NVMain.hh"
 #include "debug/NVMainMin.hh"
-#include "config/the_isa.hh"
 
 using namespace NVM;
 
@@ -62,11 +63,17 @@ using namespace NVM;
 // contiguous region.
 NVMainMemory *NVMainMemory::masterInstance = NULL;
 
+/* Packets in flight between event queues in each direction. */
+static const size_t bridgeDepth = 256;
+
 NVMainMemory::NVMainMemory(const Params *p)
-    : AbstractMemory(p), clockEvent(this), respondEvent(this),
+    : AbstractMemory(p), clockEvent(this),
+      wakeCheckEvent(this, false, Event::CPU_Tick_Pri + 1), respondEvent(this),
+      bridgeEvent(this), deliverEvent(this),
       drainManager(NULL), lat(p->atomic_latency),
       lat_var(p->atomic_variance), nvmain_atomic(p->atomic_mode),
-      NVMainWarmUp(p->NVMainWarmUp), port(name() + ".port", *this)
+      NVMainWarmUp(p->NVMainWarmUp), m_inbound(bridgeDepth),
+      m_outbound(bridgeDepth), port(name() + ".port", *this)
 {
     char *cfgparams;
     char *cfgvalues;
@@ -77,6 +84,18 @@ NVMainMemory::NVMainMemory(const Params *p)
     nextEventCycle = 0;
 
     m_nvmainPtr = NULL;
+    m_requesterQueue.store( NULL );
+    m_bridgePending.store( false );
+    m_deliveryPending.store( false );
+    m_inboundFull.store( false );
+    m_outboundRetry.store( false );
+    m_bridgeHead = NULL;
+    m_deliveryHead = NULL;
+    m_deliveryBlocked = false;
+    m_shared = this;
+    m_addressBase = 0;
+    m_atomicModel = NULL;
+    m_memoryCycleTicks = 0.0;
     m_nacked_requests = false;
 
     m_nvmainConfigPath = p->config;
@@ -118,6 +137,13 @@ NVMainMemory::NVMainMemory(const Params *p)
    tBURST = m_nvmainConfig->GetValue( "tBURST" );
    RATE = m_nvmainConfig->GetValue( "RATE" );
 
+   /*
+    * Old data is captured along with the data. The controller's flip-bit
+    * statistics and pre-traces use it even when no data-dependent model is
+    * configured, and it is only one more copy.
+    */
+   captureData = !m_nvmainConfig->GetBool( "IgnoreData" );
+
    lastWakeup = curTick();
 }
 
@@ -125,6 +151,11 @@ NVMainMemory::NVMainMemory(const Params *p)
 NVMainMemory::~NVMainMemory()
 {
     std::cout << "NVMain dtor called" << std::endl;
+
+    delete m_atomicModel;
+
+    for( auto it = m_request_pool.begin(); it != m_request_pool.end(); it++ )
+        delete (*it);
 }
 
 
@@ -137,9 +168,16 @@ NVMainMemory::init()
         port.sendRangeChange();
     }
 
-    if( masterInstance == NULL )
+    /*
+     *  Independent instances own their own NVMain channels and event queue.
+     *  All other instances share the NVMain of the first one.
+     */
+    if( params()->independent || masterInstance == NULL )
     {
-        masterInstance = this;
+        if( !params()->independent )
+            masterInstance = this;
+
+        m_shared = this;
 
         m_nvmainPtr = new NVM::NVMain( );
         m_statsPtr = new NVM::Stats( );
@@ -153,9 +191,18 @@ NVMainMemory::init()
         statPrinter.nvmainPtr = m_nvmainPtr;
         statReseter.nvmainPtr = m_nvmainPtr;
 
+        /*
+         *  Independent instances print their own statistics, so each gets
+         *  its own stats file, <StatsFile>.<instance name>.
+         */
         if( m_nvmainConfig->KeyExists( "StatsFile" ) )
         {
-            statPrinter.statStream.open( m_nvmainConfig->GetString( "StatsFile" ).c_str(),
+            std::string statsFile = m_nvmainConfig->GetString( "StatsFile" );
+
+            if( params()->independent )
+                statsFile += "." + name();
+
+            statPrinter.statStream.open( statsFile.c_str(),
                                          std::ofstream::out | std::ofstream::app );
         }
 
@@ -201,14 +248,32 @@ NVMainMemory::init()
         AddChild( m_nvmainPtr );
         m_nvmainPtr->SetParent( this );
         m_nvmainGlobalEventQueue->AddSystem( m_nvmainPtr, m_nvmainConfig );
-        m_nvmainPtr->SetConfig( m_nvmainConfig );
+        /* Name independent instances after themselves so their stats differ. */
+        if( params()->independent )
+            m_nvmainPtr->SetConfig( m_nvmainConfig, name() );
+        else
+            m_nvmainPtr->SetConfig( m_nvmainConfig );
+
+        /* Analytical latencies for atomic mode, calibrated by timing mode. */
+        if( m_nvmainConfig->KeyExists( "AtomicLatencyModel" )
+            && m_nvmainConfig->GetBool( "AtomicLatencyModel" ) )
+        {
+            NVM::Params *modelParams = new NVM::Params( );
+
+            modelParams->SetParams( m_nvmainConfig );
+            m_atomicModel = new NVM::AtomicLatencyModel( modelParams, m_nvmainPtr->GetDecoder( ) );
+            m_memoryCycleTicks = static_cast<double>( SimClock::Frequency )
+                               / ( m_nvmainConfig->GetEnergy( "CLK" ) * 1000000.0 );
 
-        masterInstance->allInstances.push_back(this);
+            delete modelParams;
+        }
+
+        allInstances.push_back(this);
     }
     else
     {
-        masterInstance->allInstances.push_back(this);
-        masterInstance->otherInstance = this;
+        m_shared = masterInstance;
+        m_shared->allInstances.push_back(this);
     }
 }
 
@@ -223,19 +288,60 @@ void NVMainMemory::startup()
      *  If we are in atomic/fast-forward, wakeup will be disabled upon
      *  the first atomic request receieved in recvAtomic().
      */
-    if (!masterInstance->clockEvent.scheduled())
-        schedule(masterInstance->clockEvent, curTick() + clock);
+    if (m_shared == this)
+    {
+        if (!clockEvent.scheduled())
+            schedule(clockEvent, curTick() + clock);
+
+        AssignAddressBases( );
+    }
 
     lastWakeup = curTick();
 }
 
 
+/*
+ *  NVMain expects linear addresses, so the address ranges of the instances
+ *  sharing an NVMain are packed back to back in order of their start
+ *  address, skipping any holes (e.g., 3GB-4GB on x86). Interleaved ranges
+ *  with the same start share one base, since NVMain decodes the channel.
+ */
+void NVMainMemory::AssignAddressBases( )
+{
+    std::vector<NVMainMemory *> sorted( allInstances );
+    Addr nextBase = 0;
+
+    std::sort( sorted.begin(), sorted.end(),
+               []( NVMainMemory *a, NVMainMemory *b )
+               { return a->range.start() < b->range.start(); } );
+
+    for( size_t i = 0; i < sorted.size(); i++ )
+    {
+        if( i > 0 && sorted[i]->range.start() == sorted[i-1]->range.start() )
+        {
+            sorted[i]->m_addressBase = sorted[i-1]->m_addressBase;
+            continue;
+        }
+
+        sorted[i]->m_addressBase = nextBase;
+        nextBase += sorted[i]->range.end() - sorted[i]->range.start() + 1;
+    }
+}
+
+
+uint64_t NVMainMemory::NVMainAddress( PacketPtr pkt )
+{
+    return pkt->getAddr() - range.start() + m_addressBase;
+}
+
+
 void NVMainMemory::wakeup()
 {
     DPRINTF(NVMain, "NVMainMemory: wakeup() called.\n");
     DPRINTF(NVMainMin, "NVMainMemory: wakeup() called.\n");
 
-    schedule(masterInstance->clockEvent, clockEdge());
+    if (m_shared == this)
+        schedule(clockEvent, clockEdge());
 
     lastWakeup = curTick();
 }
@@ -260,10 +366,14 @@ void NVMainMemory::NVMainStatPrinter::process()
     Tick stepCycles = (curTick() - memory->lastWakeup) / memory->clock;
 
     memory->m_nvmainGlobalEventQueue->Cycle( stepCycles );
+    memory->lastWakeup += memory->clock * stepCycles;
 
     nvmainPtr->CalculateStats();
     std::ostream& refStream = (statStream.is_open()) ? statStream : std::cout;
     nvmainPtr->GetStats()->PrintAll( refStream );
+
+    /* Stats are dumped at exit, so the pre-trace is complete afterwards. */
+    nvmainPtr->FlushPreTrace();
 }
 
 
@@ -296,81 +406,25 @@ NVMainMemory::SetRequestData(NVMainRequest *request, PacketPtr pkt)
 {
     uint8_t *hostAddr;
 
-    request->data.SetSize( pkt->getSize() );
-    request->oldData.SetSize( pkt->getSize() );
-
-    if (pkt->isRead())
-    {
-        Request *dataReq = new Request(pkt->getAddr(), pkt->getSize(), 0, Request::funcMasterId);
-        Packet *dataPkt = new Packet(dataReq, MemCmd::ReadReq);
-        dataPkt->allocate();
-        doFunctionalAccess(dataPkt);
+    /* Nothing to capture without a backing store or when data is ignored. */
+    if( !captureData || pmemAddr == NULL || !(pkt->isRead() || pkt->isWrite()) )
+        return;
 
-        hostAddr = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddr, dataPkt->getPtr<uint8_t>(), pkt->getSize() );
+    /*
+     * The backing store is only updated when the packet is accessed after
+     * NVMain has seen the request, so it still holds the old data here.
+     */
+    hostAddr = pmemAddr + pkt->getAddr() - range.start();
 
-        for(int i = 0; i < pkt->getSize(); i++ )
-        {
-            request->oldData.SetByte(i, *(hostAddr + i));
-            request->data.SetByte(i, *(hostAddr + i));
-        }
+    request->data.SetSize( pkt->getSize() );
 
-        delete dataPkt;
-        delete dataReq;
-        delete [] hostAddr;
-    }
+    if( pkt->isWrite() && pkt->hasData() )
+        memcpy( request->data.rawData, pkt->getConstPtr<uint8_t>(), pkt->getSize() );
     else
-    {
-        Request *dataReq = new Request(pkt->getAddr(), pkt->getSize(), 0, Request::funcMasterId);
-        Packet *dataPkt = new Packet(dataReq, MemCmd::ReadReq);
-        dataPkt->allocate();
-        doFunctionalAccess(dataPkt);
-
-        uint8_t *hostAddrT = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddrT, dataPkt->getPtr<uint8_t>(), pkt->getSize() );
-
-        hostAddr = new uint8_t[ pkt->getSize() ];
-        memcpy( hostAddr, pkt->getPtr<uint8_t>(), pkt->getSize() );
-
-        for(int i = 0; i < pkt->getSize(); i++ )
-        {
-            request->oldData.SetByte(i, *(hostAddrT + i));
-            request->data.SetByte(i, *(hostAddr + i));
-        }
+        memcpy( request->data.rawData, hostAddr, pkt->getSize() );
 
-        //Adding Part Start
-        /*
-    
-        uint8_t *bitCountData = new uint8_t[request->data.GetSize()];
-        int8_t check_upate = 0;
-
-        for( uint64_t bitCountByte = 0; bitCountByte < request->data.GetSize(); bitCountByte++ )
-        {
-            bitCountData[bitCountByte] = request->data.GetByte( bitCountByte )
-                                        ^ request->oldData.GetByte( bitCountByte );
-            if(bitCountData[bitCountByte] >= 1){
-                check_upate++;
-            }
-        }
-
-        if (pkt->cmd == MemCmd::CleanEvict || pkt->cmd == MemCmd::WritebackClean) {
-            std::cout << "CleanEvict! OR WritebackClean" << std::endl;
-        }
-
-        if (check_upate >= 1 ){
-            std::cout<< "Change in NVMain" <<std::endl;
-        }else{
-            std::cout<< "#########No Change in NVMain" <<std::endl;
-        }
-        //std::cout<< "ChangeBitNumber : " << numChangedBits <<std::endl;
-        */
-        //Adding Part End
-
-        delete dataPkt;
-        delete dataReq;
-        delete [] hostAddrT;
-        delete [] hostAddr;
-    }
+    request->oldData.SetSize( pkt->getSize() );
+    memcpy( request->oldData.rawData, hostAddr, pkt->getSize() );
 }
 
 
@@ -386,18 +440,24 @@ NVMainMemory::MemoryPort::recvAtomic(PacketPtr pkt)
      */
     Tick latency = memory.lat;
 
-    if (memory.lat_var != 0)
+    if( memory.m_shared->m_atomicModel != NULL && (pkt->isRead() || pkt->isWrite()) )
+    {
+        NVMainMemory *shared = memory.m_shared;
+        ncycle_t cycles = shared->PredictLatency( memory.NVMainAddress( pkt ), pkt->isWrite() );
+
+        latency = static_cast<Tick>( shared->m_atomicModel->CalibratedLatency( cycles )
+                                     * shared->m_memoryCycleTicks );
+    }
+    else if (memory.lat_var != 0)
+    {
         latency += random_mt.random<Tick>(0, memory.lat_var);
+    }
 
     /*
      *  if NVMain also needs the packet to warm up the inline cache, create the request
      */
     if( memory.NVMainWarmUp )
     {
-        NVMainRequest *request = new NVMainRequest( );
-
-        memory.SetRequestData( request, pkt );
-
         if( !pkt->isRead() && !pkt->isWrite() )
         {
             // if it is neither read nor write, just return
@@ -405,9 +465,13 @@ NVMainMemory::MemoryPort::recvAtomic(PacketPtr pkt)
             return latency;
         }
 
+        NVMainRequest *request = new NVMainRequest( );
+
+        memory.SetRequestData( request, pkt );
+
         /* initialize the request so that NVMain can correctly serve it */
         request->access = UNKNOWN_ACCESS;
-        request->address.SetPhysicalAddress(pkt->req->getPaddr());
+        request->address.SetPhysicalAddress(memory.NVMainAddress(pkt));
         request->status = MEM_REQUEST_INCOMPLETE;
         request->type = (pkt->isRead()) ? READ : WRITE;
         request->owner = (NVMObject *)&memory;
@@ -415,9 +479,10 @@ NVMainMemory::MemoryPort::recvAtomic(PacketPtr pkt)
         if(pkt->req->hasContextId()) request->threadId = pkt->req->contextId();
 
         /*
-         * Issue the request to NVMain as an atomic request
+         * Issue the request to NVMain as an atomic request. Go through the
+         * child hook so any hooks (e.g., migrators) are warmed up as well.
          */
-        memory.masterInstance->m_nvmainPtr->IssueAtomic(request);
+        memory.m_shared->GetChild( )->IssueAtomic(request);
 
         delete request;
     }
@@ -449,6 +514,10 @@ NVMainMemory::MemoryPort::recvFunctional(PacketPtr pkt)
 bool
 NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
 {
+    /* Requesters on another event queue must not touch NVMain directly. */
+    if (memory.IsCrossDomain())
+        return memory.BridgeRequest(pkt);
+
     /* added by Tao @ 01/24/2013, just copy the code from SimpleMemory */
     /// @todo temporary hack to deal with memory corruption issues until
     /// 4-phase transactions are complete
@@ -500,30 +569,8 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
 
     memory.SetRequestData( request, pkt );
 
-    /*
-     *  NVMain expects linear addresses, so hack: If we are not the master
-     *  instance, assume there are two channels because 3GB-4GB is skipped
-     *  in X86 and subtract 1GB.
-     *
-     *  TODO: Have each channel communicate it's address range to determine
-     *  this fix up value.
-     */
-    uint64_t addressFixUp = 0;
-#if THE_ISA == X86_ISA
-    if( masterInstance != &memory )
-    {
-        addressFixUp = 0x40000000;
-    }
-#elif THE_ISA == ARM_ISA
-    /* 
-     *  ARM regions are 2GB - 4GB followed by 34 GB - 64 GB. Work for up to
-     *  34 GB of memory. Further regions from 512 GB - 992 GB.
-     */
-    addressFixUp = (masterInstance == &memory) ? 0x80000000 : 0x800000000;
-#endif
-
     request->access = UNKNOWN_ACCESS;
-    request->address.SetPhysicalAddress(pkt->req->getPaddr() - addressFixUp);
+    request->address.SetPhysicalAddress(memory.NVMainAddress(pkt));
     request->status = MEM_REQUEST_INCOMPLETE;
     request->type = (pkt->isRead()) ? READ : WRITE;
     request->owner = (NVMObject *)&memory;
@@ -532,93 +579,59 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
     if(pkt->req->hasContextId()) request->threadId = pkt->req->contextId();
 
     /* Call hooks here manually, since there is no one else to do it. */
-    std::vector<NVMObject *>& preHooks  = memory.masterInstance->GetHooks( NVMHOOK_PREISSUE );
-    std::vector<NVMObject *>& postHooks = memory.masterInstance->GetHooks( NVMHOOK_POSTISSUE );
+    std::vector<NVMObject *>& preHooks  = memory.m_shared->GetHooks( NVMHOOK_PREISSUE );
+    std::vector<NVMObject *>& postHooks = memory.m_shared->GetHooks( NVMHOOK_POSTISSUE );
     std::vector<NVMObject *>::iterator it;
 
-    canQueue = memory.masterInstance->GetChild( )->IsIssuable( request );
+    canQueue = memory.m_shared->GetChild( )->IsIssuable( request );
 
     if( canQueue )
     {
         /* Call pre-issue hooks */
         for( it = preHooks.begin(); it != preHooks.end(); it++ )
         {
-            (*it)->SetParent( memory.masterInstance );
+            (*it)->SetParent( memory.m_shared );
             (*it)->IssueCommand( request );
         }
 
-        enqueued = memory.masterInstance->GetChild( )->IssueCommand(request);
+        enqueued = memory.m_shared->GetChild( )->IssueCommand(request);
         assert( enqueued == true );
 
-        NVMainMemoryRequest *memRequest = new NVMainMemoryRequest;
+        NVMainMemoryRequest *memRequest = memory.m_shared->AllocateMemoryRequest( );
 
         memRequest->request = request;
         memRequest->packet = pkt;
         memRequest->issueTick = curTick();
         memRequest->atomic = false;
+        memRequest->predictedCycles = 0;
 
-        DPRINTF(NVMain, "nvmain_mem.cc: Enqueued Mem request for 0x%x of type %s\n", request->address.GetPhysicalAddress( ), ((pkt->isRead()) ? "READ" : "WRITE") );
-
-        /* See if we need to reschedule the wakeup event sooner. */
-        ncycle_t nextEvent = memory.masterInstance->m_nvmainGlobalEventQueue->GetNextEvent(NULL);
-        DPRINTF(NVMain, "NVMainMemory: Next event after issue is %d\n", nextEvent);
-        if( nextEvent < memory.nextEventCycle && masterInstance->clockEvent.scheduled() )
+        /* Keep the analytical model warm and note its prediction for calibration. */
+        if( memory.m_shared->m_atomicModel != NULL )
         {
-            ncycle_t currentCycle = memory.masterInstance->m_nvmainGlobalEventQueue->GetCurrentCycle();
-
-            //assert(nextEvent >= currentCycle);
-            ncycle_t stepCycles;
-            if( nextEvent > currentCycle )
-                stepCycles = nextEvent - currentCycle;
-            else
-                stepCycles = 1;
-
-            Tick nextWake = curTick() + memory.clock * static_cast<Tick>(stepCycles);
-
-            DPRINTF(NVMain, "NVMainMemory: Next event: %d CurrentCycle: %d\n", nextEvent, currentCycle);
-            DPRINTF(NVMain, "NVMainMemory: Rescheduled wake at %d after %d cycles\n", nextWake, stepCycles);
-
-            memory.nextEventCycle = nextEvent;
-            memory.ScheduleClockEvent( nextWake );
+            memRequest->predictedCycles = memory.m_shared->PredictLatency(
+                request->address.GetPhysicalAddress( ), request->type == WRITE );
         }
-        else if( !masterInstance->clockEvent.scheduled() )
-        {
-            ncycle_t currentCycle = memory.masterInstance->m_nvmainGlobalEventQueue->GetCurrentCycle();
-
-            //assert(nextEvent >= currentCycle);
-            ncycle_t stepCycles = nextEvent - currentCycle;
-            if( stepCycles == 0 || nextEvent < currentCycle )
-                stepCycles = 1;
 
-            Tick nextWake = curTick() + memory.clock * static_cast<Tick>(stepCycles);
+        DPRINTF(NVMain, "nvmain_mem.cc: Enqueued Mem request for 0x%x of type %s\n", request->address.GetPhysicalAddress( ), ((pkt->isRead()) ? "READ" : "WRITE") );
 
-            memory.nextEventCycle = nextEvent;
-            memory.ScheduleClockEvent( nextWake );
-        }
+        /*
+         *  See if we need to reschedule the wakeup event sooner. This is
+         *  done once after all requests arriving this tick are enqueued.
+         */
+        memory.m_shared->ScheduleWakeCheck( );
 
-        memory.masterInstance->m_request_map.insert( std::pair<NVMainRequest *, NVMainMemoryRequest *>( request, memRequest ) );
+        memory.m_shared->m_request_map.insert( std::make_pair( request, memRequest ) );
         memory.m_requests_outstanding++;
 
         /*
-         *  It seems gem5 will block until the packet gets a response, so create a copy of the request, so
-         *  the memory controller has it, then delete the original copy to respond to the packet.
+         *  It seems gem5 will block until the packet gets a response, so
+         *  respond to writes now and let the memory controller finish the
+         *  request without a packet attached.
          */
         if( request->type == WRITE )
         {
-            NVMainMemoryRequest *requestCopy = new NVMainMemoryRequest( );
-
-            requestCopy->request = new NVMainRequest( );
-            *(requestCopy->request) = *request;
-            requestCopy->packet = pkt;
-            requestCopy->issueTick = curTick();
-            requestCopy->atomic = false;
-
             memRequest->packet = NULL;
-
-            memory.masterInstance->m_request_map.insert( std::pair<NVMainRequest *, NVMainMemoryRequest *>( requestCopy->request, requestCopy ) );
-            memory.m_requests_outstanding++;
-
-            memory.RequestComplete( requestCopy->request );
+            memory.RespondToPacket( pkt );
         }
 
         /* Call post-issue hooks. */
@@ -645,6 +658,8 @@ NVMainMemory::MemoryPort::recvTimingReq(PacketPtr pkt)
             memory.retryWrite = true;
         }
 
+        memory.m_shared->m_blockedInstances.push_back( &memory );
+
         delete request;
         request = NULL;
     }
@@ -670,7 +685,8 @@ void NVMainMemory::doFunctionalAccess(PacketPtr pkt)
 
 DrainState NVMainMemory::drain()
 {
-    if( !masterInstance->m_request_map.empty() )
+    if( !m_shared->m_request_map.empty() || !m_inbound.Empty() || m_bridgeHead != NULL
+        || !m_outbound.Empty() || m_deliveryHead != NULL )
     {
         return DrainState::Draining;
     }
@@ -683,6 +699,14 @@ DrainState NVMainMemory::drain()
 
 void NVMainMemory::MemoryPort::recvRespRetry( )
 {
+    /* Bridged responses are sent from the requester's event queue. */
+    if( memory.m_requesterQueue.load( ) != NULL )
+    {
+        memory.m_deliveryBlocked = false;
+        memory.DrainDelivery( );
+        return;
+    }
+
     memory.recvRetry( );
 }
 
@@ -716,109 +740,258 @@ bool NVMainMemory::RequestComplete(NVM::NVMainRequest *req)
     }
 
     NVMainMemoryRequest *memRequest;
-    std::map<NVMainRequest *, NVMainMemoryRequest *>::iterator iter;
+    std::unordered_map<NVMainRequest *, NVMainMemoryRequest *>::iterator iter;
 
     // Find the mem request pointer in the map.
-    assert(masterInstance->m_request_map.count(req) != 0);
-    iter = masterInstance->m_request_map.find(req);
+    iter = m_shared->m_request_map.find(req);
+    assert(iter != m_shared->m_request_map.end());
     memRequest = iter->second;
+    m_shared->m_request_map.erase(iter);
 
-    if(!memRequest->atomic)
+    if( !memRequest->atomic && memRequest->predictedCycles != 0 )
     {
-        bool respond = false;
+        double measured = static_cast<double>( curTick() - memRequest->issueTick )
+                        / m_shared->m_memoryCycleTicks;
+
+        m_shared->m_atomicModel->Calibrate(
+            static_cast<double>( memRequest->predictedCycles ), measured );
+    }
 
+    if(!memRequest->atomic)
+    {
         NVMainMemory *ownerInstance = dynamic_cast<NVMainMemory *>( req->owner );
         assert( ownerInstance != NULL );
 
         if( memRequest->packet )
-        {
-            respond = memRequest->packet->needsResponse();
-            ownerInstance->access(memRequest->packet);
-        }
+            ownerInstance->RespondToPacket( memRequest->packet );
+        else
+            CheckDrainState( );
 
-        for( auto retryIter = masterInstance->allInstances.begin(); 
-             retryIter != masterInstance->allInstances.end(); retryIter++ )
+        /* Only the ports refused by this NVMain are waiting on it. */
+        if( (isRead || isWrite) && !m_blockedInstances.empty() )
         {
-            if( (*retryIter)->retryRead && (isRead || isWrite) )
-            {
-                (*retryIter)->retryRead = false;
-                (*retryIter)->port.sendRetryReq();
-            }
-            if( (*retryIter)->retryWrite && (isRead || isWrite) )
-            {
-                (*retryIter)->retryWrite = false;
-                (*retryIter)->port.sendRetryReq();
-            }
+            std::deque<NVMainMemory *> blocked;
+
+            blocked.swap( m_blockedInstances );
+
+            for( auto retryIter = blocked.begin(); retryIter != blocked.end(); retryIter++ )
+                (*retryIter)->RetryRequest( );
         }
 
         DPRINTF(NVMain, "Completed Mem request for 0x%x of type %s\n", req->address.GetPhysicalAddress( ), (isRead ? "READ" : "WRITE"));
+    }
+
+    delete req;
+    m_shared->ReleaseMemoryRequest( memRequest );
+
+    //assert(m_requests_outstanding > 0);
+    m_requests_outstanding--;
+
+    return true;
+}
+
+
+void NVMainMemory::SendResponses( )
+{
+    /* Bridged responses go back to the requester's event queue. */
+    if( m_requesterQueue.load( ) != NULL )
+    {
+        while( !responseQueue.empty() && m_outbound.Push( responseQueue.front() ) )
+            responseQueue.pop_front( );
 
-        if(respond)
+        ScheduleDelivery( );
+
+        /* The ring is full; try again next cycle. */
+        if( !responseQueue.empty() )
+            ScheduleResponse( );
+
+        CheckDrainState( );
+        return;
+    }
+
+    /* Send as many responses as the port accepts, not just one per event. */
+    while( !responseQueue.empty() && retryResp == false )
+    {
+        if( !port.sendTimingResp( responseQueue.front() ) )
         {
-            ownerInstance->responseQueue.push_back(memRequest->packet);
-            ownerInstance->ScheduleResponse( );
+            DPRINTF(NVMain, "NVMainMemory: Retrying response.\n");
+            DPRINTF(NVMainMin, "NVMainMemory: Retrying response.\n");
 
-            delete req;
-            delete memRequest;
+            retryResp = true;
+            return;
         }
-        else
-        {
-            if( memRequest->packet )
-                ownerInstance->pendingDelete.push_back(memRequest->packet);
 
-            CheckDrainState( );
+        DPRINTF(NVMain, "NVMainMemory: Sending response.\n");
 
-            delete req;
-            delete memRequest;
-        }
+        responseQueue.pop_front( );
     }
+
+    CheckDrainState( );
+}
+
+
+void NVMainMemory::RetryRequest( )
+{
+    retryRead = false;
+    retryWrite = false;
+
+    if( m_requesterQueue.load( ) != NULL )
+        DrainBridge( );
     else
+        port.sendRetryReq( );
+}
+
+
+/*
+ *  Parallel mode: requests from a requester on another event queue cross
+ *  into this memory's queue, and responses cross back, through SPSC rings.
+ *  Each crossing is scheduled one simQuantum ahead of the sender. That is
+ *  the lookahead that keeps it in the future of the receiving queue. NVMain
+ *  itself only runs on this memory's queue. Instances sharing an NVMain
+ *  must therefore be on the same event queue; use independent otherwise.
+ */
+bool NVMainMemory::IsCrossDomain( )
+{
+    return inParallelMode && curEventQueue() != eventQueue();
+}
+
+
+/* Runs on the requester's event queue. */
+bool NVMainMemory::BridgeRequest( PacketPtr pkt )
+{
+    m_requesterQueue.store( curEventQueue() );
+
+    bool accepted = m_inbound.Push( pkt );
+
+    /* A refused requester is retried once the ring drains. */
+    if( !accepted )
+        m_inboundFull.store( true );
+
+    if( !m_bridgePending.exchange( true ) )
+        eventQueue()->schedule( &bridgeEvent, curTick() + simQuantum );
+
+    return accepted;
+}
+
+
+void NVMainMemory::BridgeRequests( )
+{
+    m_bridgePending.store( false );
+
+    DrainBridge( );
+}
+
+
+void NVMainMemory::DrainBridge( )
+{
+    /* Hold the refused packet until NVMain asks for a retry. */
+    while( !retryRead && !retryWrite )
     {
-        delete req;
-        delete memRequest;
+        if( m_bridgeHead == NULL && !m_inbound.Pop( m_bridgeHead ) )
+            break;
+
+        if( !port.recvTimingReq( m_bridgeHead ) )
+            return;
+
+        m_bridgeHead = NULL;
     }
 
+    if( !retryRead && !retryWrite && m_inboundFull.exchange( false ) )
+    {
+        m_outboundRetry.store( true );
+        ScheduleDelivery( );
+    }
+}
 
-    masterInstance->m_request_map.erase(iter);
-    //assert(m_requests_outstanding > 0);
-    m_requests_outstanding--;
 
-    return true;
+void NVMainMemory::ScheduleDelivery( )
+{
+    if( !m_deliveryPending.exchange( true ) )
+        m_requesterQueue.load( )->schedule( &deliverEvent, curTick() + simQuantum );
 }
 
 
-void NVMainMemory::SendResponses( )
+/* Runs on the requester's event queue. */
+void NVMainMemory::DeliverResponses( )
 {
-    if( responseQueue.empty() || retryResp == true )
-        return;
+    m_deliveryPending.store( false );
+
+    if( m_outboundRetry.exchange( false ) )
+        port.sendRetryReq( );
 
+    DrainDelivery( );
+}
 
-    bool success = port.sendTimingResp( responseQueue.front() );
 
-    if( success )
+void NVMainMemory::DrainDelivery( )
+{
+    while( !m_deliveryBlocked )
     {
-        DPRINTF(NVMain, "NVMainMemory: Sending response.\n");
+        if( m_deliveryHead == NULL && !m_outbound.Pop( m_deliveryHead ) )
+            break;
 
-        responseQueue.pop_front( );
+        if( !port.sendTimingResp( m_deliveryHead ) )
+        {
+            m_deliveryBlocked = true;
+            break;
+        }
 
-        if( !responseQueue.empty( ) )
-            ScheduleResponse( );
+        m_deliveryHead = NULL;
+    }
+}
 
-        CheckDrainState( );
+
+NVM::ncycle_t NVMainMemory::PredictLatency( uint64_t address, bool isWrite )
+{
+    NVM::ncycle_t now = static_cast<NVM::ncycle_t>( static_cast<double>( curTick() )
+                                                    / m_memoryCycleTicks );
+
+    return m_atomicModel->Access( address, isWrite, now );
+}
+
+
+void NVMainMemory::RespondToPacket( PacketPtr pkt )
+{
+    bool respond = pkt->needsResponse();
+
+    access(pkt);
+
+    if( respond )
+    {
+        responseQueue.push_back(pkt);
+        ScheduleResponse( );
     }
     else
     {
-        DPRINTF(NVMain, "NVMainMemory: Retrying response.\n");
-        DPRINTF(NVMainMin, "NVMainMemory: Retrying response.\n");
-
-        retryResp = true;
+        pendingDelete.push_back(pkt);
+        CheckDrainState( );
     }
 }
 
 
+NVMainMemory::NVMainMemoryRequest *NVMainMemory::AllocateMemoryRequest( )
+{
+    NVMainMemoryRequest *memRequest;
+
+    if( m_request_pool.empty() )
+        return new NVMainMemoryRequest;
+
+    memRequest = m_request_pool.back();
+    m_request_pool.pop_back();
+
+    return memRequest;
+}
+
+
+void NVMainMemory::ReleaseMemoryRequest( NVMainMemoryRequest *memRequest )
+{
+    m_request_pool.push_back( memRequest );
+}
+
+
 void NVMainMemory::CheckDrainState( )
 {
-    if( drainManager != NULL && masterInstance->m_request_map.empty() )
+    if( drainManager != NULL && m_shared->m_request_map.empty() )
     {
         DPRINTF(NVMain, "NVMainMemory: Drain completed.\n");
         DPRINTF(NVMainMin, "NVMainMemory: Drain completed.\n");
@@ -836,18 +1009,53 @@ void NVMainMemory::ScheduleResponse( )
 }
 
 
+void NVMainMemory::ScheduleWakeCheck( )
+{
+    if( !wakeCheckEvent.scheduled( ) )
+        schedule(wakeCheckEvent, curTick());
+}
+
+
+/* Wake NVMain sooner if the requests that just arrived need it. */
+void NVMainMemory::WakeCheck( )
+{
+    ncycle_t nextEvent = m_nvmainGlobalEventQueue->GetNextEvent(NULL);
+    DPRINTF(NVMain, "NVMainMemory: Next event after issue is %d\n", nextEvent);
+
+    if( nextEvent == std::numeric_limits<ncycle_t>::max() )
+        return;
+
+    if( clockEvent.scheduled() && nextEvent >= nextEventCycle )
+        return;
+
+    ncycle_t currentCycle = m_nvmainGlobalEventQueue->GetCurrentCycle();
+    ncycle_t stepCycles = 1;
+
+    if( nextEvent > currentCycle )
+        stepCycles = nextEvent - currentCycle;
+
+    Tick nextWake = curTick() + clock * static_cast<Tick>(stepCycles);
+
+    DPRINTF(NVMain, "NVMainMemory: Next event: %d CurrentCycle: %d\n", nextEvent, currentCycle);
+    DPRINTF(NVMain, "NVMainMemory: Rescheduled wake at %d after %d cycles\n", nextWake, stepCycles);
+
+    nextEventCycle = nextEvent;
+    ScheduleClockEvent( nextWake );
+}
+
+
 void NVMainMemory::ScheduleClockEvent( Tick nextWake )
 {
-    if( !masterInstance->clockEvent.scheduled() )
-        schedule(masterInstance->clockEvent, nextWake);
+    if( !clockEvent.scheduled() )
+        schedule(clockEvent, nextWake);
     else
-        reschedule(masterInstance->clockEvent, nextWake);
+        reschedule(clockEvent, nextWake);
 }
 
 
 void NVMainMemory::serialize(CheckpointOut &cp) const
 {
-    if (masterInstance != this)
+    if (m_shared != this)
         return;
 
     std::string nvmain_chkpt_dir = "";
@@ -866,7 +1074,7 @@ void NVMainMemory::serialize(CheckpointOut &cp) const
 
 void NVMainMemory::unserialize(CheckpointIn &cp)
 {
-    if (masterInstance != this)
+    if (m_shared != this)
         return;
 
     std::string nvmain_chkpt_dir = "";
@@ -886,7 +1094,7 @@ void NVMainMemory::unserialize(CheckpointIn &cp)
 void NVMainMemory::tick( )
 {
     // Cycle memory controller
-    if (masterInstance == this)
+    if (m_shared == this)
     {
         /* Keep NVMain in sync with gem5. */
         assert(curTick() >= lastWakeup);
@@ -895,7 +1103,8 @@ void NVMainMemory::tick( )
         DPRINTF(NVMain, "NVMainMemory: Stepping %d cycles\n", stepCycles);
         m_nvmainGlobalEventQueue->Cycle( stepCycles );
 
-        lastWakeup = curTick();
+        /* Carry any partial cycle over rather than dropping it. */
+        lastWakeup += clock * static_cast<Tick>(stepCycles);
 
         ncycle_t nextEvent;
 
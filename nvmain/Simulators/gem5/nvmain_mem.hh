@@ -46,13 +46,19 @@
 #define __MEM_NVMAIN_MEM_HH__
 
 
+#include <atomic>
+#include <deque>
 #include <fstream>
 #include <ostream>
+#include <unordered_map>
+#include <vector>
 
 #include "NVM/nvmain.h"
+#include "Utils/AtomicLatencyModel/AtomicLatencyModel.h"
 #include "base/callback.hh"
 #include "include/NVMTypes.h"
 #include "include/NVMainRequest.h"
+#include "include/SPSCQueue.h"
 #include "mem/abstract_mem.hh"
 #include "mem/tport.hh"
 #include "params/NVMainMemory.hh"
@@ -96,13 +102,32 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
 
     void tick();
     void SendResponses( );
+    void WakeCheck( );
     EventWrapper<NVMainMemory, &NVMainMemory::tick> clockEvent;
+    EventWrapper<NVMainMemory, &NVMainMemory::WakeCheck> wakeCheckEvent;
     EventWrapper<NVMainMemory, &NVMainMemory::SendResponses> respondEvent;
 
+    /* Crossing to and from a requester on another event queue. */
+    bool IsCrossDomain( );
+    bool BridgeRequest( PacketPtr pkt );
+    void BridgeRequests( );
+    void DrainBridge( );
+    void DeliverResponses( );
+    void DrainDelivery( );
+    void ScheduleDelivery( );
+    void RetryRequest( );
+    EventWrapper<NVMainMemory, &NVMainMemory::BridgeRequests> bridgeEvent;
+    EventWrapper<NVMainMemory, &NVMainMemory::DeliverResponses> deliverEvent;
+
     void CheckDrainState( );
     void ScheduleResponse( );
     void ScheduleClockEvent( Tick );
+    void ScheduleWakeCheck( );
     void SetRequestData(NVM::NVMainRequest *request, PacketPtr pkt);
+    void AssignAddressBases( );
+    uint64_t NVMainAddress(PacketPtr pkt);
+    void RespondToPacket(PacketPtr pkt);
+    NVM::ncycle_t PredictLatency(uint64_t address, bool isWrite);
 
     class NVMainStatPrinter : public Callback
     {
@@ -132,6 +157,7 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
         NVM::NVMainRequest *request;
         Tick issueTick;
         bool atomic;
+        NVM::ncycle_t predictedCycles;
     };
 
     DrainManager *drainManager;
@@ -143,6 +169,8 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
     NVM::Config *m_nvmainConfig;
     NVM::SimInterface *m_nvmainSimInterface;
     NVM::TagGenerator *m_tagGenerator;
+    NVM::AtomicLatencyModel *m_atomicModel;
+    double m_memoryCycleTicks;
     std::string m_nvmainConfigPath;
 
     bool m_nacked_requests;
@@ -160,6 +188,19 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
     uint64_t RATE;
 
     bool NVMainWarmUp;
+    bool captureData;
+
+    /* Requests in from and responses out to the requester's event queue. */
+    NVM::SPSCQueue<PacketPtr> m_inbound;
+    NVM::SPSCQueue<PacketPtr> m_outbound;
+    std::atomic<EventQueue *> m_requesterQueue;
+    std::atomic<bool> m_bridgePending;
+    std::atomic<bool> m_deliveryPending;
+    std::atomic<bool> m_inboundFull;
+    std::atomic<bool> m_outboundRetry;
+    PacketPtr m_bridgeHead;
+    PacketPtr m_deliveryHead;
+    bool m_deliveryBlocked;
 
     NVMainStatPrinter statPrinter;
     NVMainStatReseter statReseter;
@@ -197,12 +238,21 @@ class NVMainMemory : public AbstractMemory, public NVM::NVMObject
 
     MemoryPort port;
     static NVMainMemory *masterInstance;
-    NVMainMemory *otherInstance;
+    /* Instance whose NVMain serves this port; itself when independent. */
+    NVMainMemory *m_shared;
+    /* NVMain address of the start of this instance's range. */
+    Addr m_addressBase;
+    /* Instances served by this NVMain, and those refused and awaiting a retry. */
     std::vector<NVMainMemory *> allInstances;
+    std::deque<NVMainMemory *> m_blockedInstances;
     bool retryRead, retryWrite, retryResp;
     std::deque<PacketPtr> responseQueue;
     std::vector<PacketPtr> pendingDelete;
-    std::map<NVM::NVMainRequest *, NVMainMemoryRequest *> m_request_map;
+    std::unordered_map<NVM::NVMainRequest *, NVMainMemoryRequest *> m_request_map;
+    std::vector<NVMainMemoryRequest *> m_request_pool;
+
+    NVMainMemoryRequest *AllocateMemoryRequest( );
+    void ReleaseMemoryRequest( NVMainMemoryRequest *memRequest );
 
   protected:
 
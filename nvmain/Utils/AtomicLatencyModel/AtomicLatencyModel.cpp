@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Utils/AtomicLatencyModel/AtomicLatencyModel.h"
+
+#include <cassert>
+
+using namespace NVM;
+
+/* Recent measurements dominate; older ones are halved at this many samples. */
+static const ncounter_t calibrationWindow = 4096;
+static const uint64_t noOpenRow = ~0ULL;
+
+AtomicLatencyModel::AtomicLatencyModel( Params *p, AddressTranslator *translator )
+{
+    uint64_t rows, cols, banks, ranks, channels, subarrays;
+
+    assert( translator != NULL );
+
+    this->translator = translator;
+
+    tBURST = p->tBURST;
+    tCAS = p->tCAS;
+    tCWD = p->tCWD;
+    tRCD = p->tRCD;
+    tRP = p->tRP;
+    tWP = p->tWP;
+    tWR = p->tWR;
+    closePage = (p->ClosePage != 0);
+
+    translator->GetTranslationMethod( )->GetCount( &rows, &cols, &banks, 
+                                                   &ranks, &channels, &subarrays );
+    numBanks = banks;
+    numRanks = ranks;
+    numChannels = channels;
+
+    openRow = new uint64_t[numChannels * numRanks * numBanks];
+    bankBusyUntil = new ncycle_t[numChannels * numRanks * numBanks];
+    busBusyUntil = new ncycle_t[numChannels];
+
+    for( ncounter_t i = 0; i < numChannels * numRanks * numBanks; i++ )
+    {
+        openRow[i] = noOpenRow;
+        bankBusyUntil[i] = 0;
+    }
+
+    for( ncounter_t i = 0; i < numChannels; i++ )
+        busBusyUntil[i] = 0;
+
+    predictedSum = 0.0;
+    measuredSum = 0.0;
+    calibrationSamples = 0;
+    scale = 1.0;
+}
+
+AtomicLatencyModel::~AtomicLatencyModel( )
+{
+    delete [] openRow;
+    delete [] bankBusyUntil;
+    delete [] busBusyUntil;
+}
+
+ncycle_t AtomicLatencyModel::Access( uint64_t address, bool isWrite, ncycle_t now )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+    ncycle_t start, dataStart, done;
+    ncycle_t rowLatency = 0;
+
+    translator->Translate( address, &row, &col, &bank, &rank, &channel, &subarray );
+
+    channel %= numChannels;
+    uint64_t idx = (channel * numRanks + (rank % numRanks)) * numBanks + (bank % numBanks);
+
+    start = (bankBusyUntil[idx] > now) ? bankBusyUntil[idx] : now;
+
+    /* Row buffer conflict needs a precharge, any row buffer miss an activate. */
+    if( openRow[idx] != row )
+    {
+        if( openRow[idx] != noOpenRow )
+            rowLatency += tRP;
+        rowLatency += tRCD;
+    }
+
+    dataStart = start + rowLatency + (isWrite ? tCWD : tCAS);
+    if( busBusyUntil[channel] > dataStart )
+        dataStart = busBusyUntil[channel];
+
+    done = dataStart + tBURST;
+    busBusyUntil[channel] = done;
+
+    /* Writes hold the bank for the write pulse and recovery time. */
+    bankBusyUntil[idx] = isWrite ? done + tWP + tWR : done;
+
+    if( closePage )
+    {
+        bankBusyUntil[idx] += tRP;
+        openRow[idx] = noOpenRow;
+    }
+    else
+    {
+        openRow[idx] = row;
+    }
+
+    return done - now;
+}
+
+double AtomicLatencyModel::CalibratedLatency( ncycle_t latency )
+{
+    return static_cast<double>(latency) * scale;
+}
+
+void AtomicLatencyModel::Calibrate( double predicted, double measured )
+{
+    predictedSum += predicted;
+    measuredSum += measured;
+    calibrationSamples++;
+
+    if( calibrationSamples >= calibrationWindow )
+    {
+        predictedSum /= 2.0;
+        measuredSum /= 2.0;
+        calibrationSamples /= 2;
+    }
+
+    if( predictedSum > 0.0 )
+        scale = measuredSum / predictedSum;
+}
+
+double AtomicLatencyModel::GetScale( )
+{
+    return scale;
+}
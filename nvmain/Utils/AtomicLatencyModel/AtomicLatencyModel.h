@@ -0,0 +1,86 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_UTILS_ATOMICLATENCYMODEL_H__
+#define __NVMAIN_UTILS_ATOMICLATENCYMODEL_H__
+
+#include "include/NVMTypes.h"
+#include "src/AddressTranslator.h"
+#include "src/Params.h"
+
+namespace NVM {
+
+/*
+ *  Analytical latency model for atomic (fast-forward) accesses. It tracks
+ *  the open row and busy-until cycle of each bank and the data bus of each
+ *  channel, and charges tRP/tRCD/tCAS/tCWD/tWP from the timing parameters.
+ *  No events or queues are used, so each access costs a translation and a
+ *  few comparisons.
+ *
+ *  Calibrate feeds back latencies measured in detailed mode. The ratio of
+ *  measured to predicted latency over a recent window scales the result
+ *  of CalibratedLatency, which covers queueing the model does not see.
+ */
+class AtomicLatencyModel
+{
+  public:
+    AtomicLatencyModel( Params *p, AddressTranslator *translator );
+    ~AtomicLatencyModel( );
+
+    /* Latency in memory cycles of an access issued at cycle now. */
+    ncycle_t Access( uint64_t address, bool isWrite, ncycle_t now );
+
+    double CalibratedLatency( ncycle_t latency );
+    void Calibrate( double predicted, double measured );
+    double GetScale( );
+
+  private:
+    AddressTranslator *translator;
+
+    ncycle_t tBURST, tCAS, tCWD, tRCD, tRP, tWP, tWR;
+    bool closePage;
+
+    ncounter_t numBanks, numRanks, numChannels;
+    uint64_t *openRow;
+    ncycle_t *bankBusyUntil;
+    ncycle_t *busBusyUntil;
+
+    double predictedSum;
+    double measuredSum;
+    ncounter_t calibrationSamples;
+    double scale;
+};
+
+};
+
+#endif
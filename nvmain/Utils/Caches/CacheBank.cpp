@@ -37,26 +37,35 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace NVM;
 
-CacheBank::CacheBank( uint64_t rows, uint64_t sets, uint64_t assoc, uint64_t lineSize )
+CacheBank::CacheBank( uint64_t rows, uint64_t sets, uint64_t assoc, uint64_t lineSize,
+                      bool tagOnly )
 {
-    uint64_t r, i, j;
+    uint64_t lines = rows * sets * assoc;
+
+    /* The LRU order stores way numbers in a byte. */
+    assert( assoc <= 256 );
+
+    tags = new uint64_t[ lines ];
+    lineFlags = new uint8_t[ lines ];
+    lruOrder = new uint8_t[ lines ];
+    lineData = (tagOnly) ? NULL : new NVMDataBlock[ lines ];
 
-    cacheEntry = new CacheEntry** [ rows ];
-    for( r = 0; r < rows; r++ )
+    for( uint64_t i = 0; i < lines; i++ )
     {
-        cacheEntry[r] = new CacheEntry* [ sets ];
-        for( i = 0; i < sets; i++ )
-        {
-            cacheEntry[r][i] = new CacheEntry[ assoc ];
-            for( j = 0; j < assoc; j++ )
-            {
-                /* Clear valid bit, dirty bit, etc. */
-                cacheEntry[r][i][j].flags = CACHE_ENTRY_NONE;
-            }
-        }
+        /* Clear valid bit, dirty bit, etc. */
+        tags[i] = invalidTag;
+        lineFlags[i] = CACHE_ENTRY_NONE;
+        lruOrder[i] = static_cast<uint8_t>( i % assoc );
     }
 
     numRows = rows;
@@ -80,18 +89,10 @@ CacheBank::CacheBank( uint64_t rows, uint64_t sets, uint64_t assoc, uint64_t lin
 
 CacheBank::~CacheBank( )
 {
-    uint64_t i, r;
-
-    for( r = 0; r < numRows; r++ )
-    {
-        for( i = 0; i < numSets; i++ )
-        {
-            delete [] cacheEntry[r][i];
-        }
-        delete [] cacheEntry[r];
-    }
-
-    delete [] cacheEntry;
+    delete [] tags;
+    delete [] lineFlags;
+    delete [] lruOrder;
+    delete [] lineData;
 }
 
 void CacheBank::SetDecodeFunction( NVMObject *dcClass, CacheSetDecoder dcFunc )
@@ -122,68 +123,122 @@ uint64_t CacheBank::SetID( NVMAddress& addr )
     return setID;
 }
 
-CacheEntry *CacheBank::FindSet( NVMAddress& addr )
+uint64_t CacheBank::SetIndex( NVMAddress& addr )
 {
-    /*
-     *  By default we'll just chop off the bits for the cacheline and use the
-     *  least significant bits as the set address, and the remaining bits are 
-     *  the tag bits.
-     */
-    uint64_t setID = SetID( addr );
+    return addr.GetRow() * numSets + SetID( addr );
+}
 
-    return cacheEntry[addr.GetRow()][setID];
+/* Returns the index of the first line of the set holding addr. */
+uint64_t CacheBank::FindSet( NVMAddress& addr )
+{
+    return SetIndex( addr ) * numAssoc;
 }
 
-bool CacheBank::Present( NVMAddress& addr )
+/* Returns the way holding tag, or numAssoc if no way does. */
+uint64_t CacheBank::FindWay( uint64_t set, uint64_t tag )
 {
-    CacheEntry *set = FindSet( addr );
-    bool found = false;
+    const uint64_t *setTags = tags + set;
+    uint64_t way = 0;
 
-    for( uint64_t i = 0; i < numAssoc; i++ )
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi64x( static_cast<long long>( tag ) );
+
+    for( ; way + 4 <= numAssoc; way += 4 )
     {
-        if( set[i].address.GetPhysicalAddress( ) == addr.GetPhysicalAddress( ) 
-            && (set[i].flags & CACHE_ENTRY_VALID ) )
-        {
-            found = true;
-            break;
-        }
+        __m256i ways = _mm256_loadu_si256( 
+                reinterpret_cast<const __m256i *>( setTags + way ) );
+        int match = _mm256_movemask_pd( 
+                _mm256_castsi256_pd( _mm256_cmpeq_epi64( ways, key ) ) );
+
+        if( match )
+            return way + __builtin_ctz( match );
     }
+#elif defined(__SSE2__)
+    __m128i key = _mm_set1_epi64x( static_cast<long long>( tag ) );
 
-    return found;
-}
+    for( ; way + 2 <= numAssoc; way += 2 )
+    {
+        __m128i ways = _mm_loadu_si128( 
+                reinterpret_cast<const __m128i *>( setTags + way ) );
 
-bool CacheBank::SetFull( NVMAddress& addr )
-{
-    CacheEntry *set = FindSet( addr );
-    bool rv = true;
+        /* SSE2 has no 64-bit compare, so both 32-bit halves must match. */
+        __m128i eq = _mm_cmpeq_epi32( ways, key );
+        eq = _mm_and_si128( eq, _mm_shuffle_epi32( eq, _MM_SHUFFLE(2, 3, 0, 1) ) );
+        int match = _mm_movemask_pd( _mm_castsi128_pd( eq ) );
 
-    for( uint64_t i = 0; i < numAssoc; i++ )
+        if( match )
+            return way + __builtin_ctz( match );
+    }
+#endif
+
+    for( ; way < numAssoc; way++ )
     {
-        /* If there is an invalid entry (e.g., not used) the set isn't full. */
-        if( !(set[i].flags & CACHE_ENTRY_VALID) )
-        {
-            rv = false;
-            break;
-        }
+        if( setTags[way] == tag )
+            return way;
     }
 
-    return rv;
+    return numAssoc;
+}
+
+/* Returns the LRU position of way, where 0 is the MRU position. */
+uint64_t CacheBank::FindPosition( uint64_t set, uint64_t way )
+{
+    const uint8_t *order = lruOrder + set;
+    uint64_t position = 0;
+
+    while( order[position] != way )
+        position++;
+
+    return position;
+}
+
+void CacheBank::MoveToMRU( uint64_t set, uint64_t position )
+{
+    uint8_t *order = lruOrder + set;
+    uint8_t way = order[position];
+
+    memmove( order + 1, order, position );
+    order[0] = way;
+}
+
+bool CacheBank::Present( NVMAddress& addr )
+{
+    assert( addr.GetPhysicalAddress( ) != invalidTag );
+
+    return (FindWay( FindSet( addr ), addr.GetPhysicalAddress( ) ) != numAssoc);
+}
+
+bool CacheBank::SetFull( NVMAddress& addr )
+{
+    /* If there is an invalid entry (e.g., not used) the set isn't full. */
+    return (FindWay( FindSet( addr ), invalidTag ) == numAssoc);
 }
 
 bool CacheBank::Install( NVMAddress& addr, NVMDataBlock& data )
 {
-    CacheEntry *set = FindSet( addr );
+    uint64_t set = FindSet( addr );
+    uint64_t way = FindWay( set, addr.GetPhysicalAddress( ) );
     bool rv = false;
 
-    //assert( !Present( addr ) );
+    /* Already cached, so just refresh the data rather than duplicating it. */
+    if( way != numAssoc )
+    {
+        if( lineData )
+            lineData[set + way] = data;
+        return true;
+    }
 
+    /* Fill the first invalid entry in LRU order, without changing the order. */
     for( uint64_t i = 0; i < numAssoc; i++ )
     {
-        if( !(set[i].flags & CACHE_ENTRY_VALID) )
+        way = lruOrder[set + i];
+
+        if( !(lineFlags[set + way] & CACHE_ENTRY_VALID) )
         {
-            set[i].address = addr;
-            set[i].data = data;
-            set[i].flags |= CACHE_ENTRY_VALID; 
+            tags[set + way] = addr.GetPhysicalAddress( );
+            if( lineData )
+                lineData[set + way] = data;
+            lineFlags[set + way] |= CACHE_ENTRY_VALID; 
             rv = true;
             break;
         }
@@ -194,79 +249,41 @@ bool CacheBank::Install( NVMAddress& addr, NVMDataBlock& data )
 
 bool CacheBank::Read( NVMAddress& addr, NVMDataBlock *data )
 {
-    CacheEntry *set = FindSet( addr );
-    bool rv = false;
+    uint64_t set = FindSet( addr );
+    uint64_t way = FindWay( set, addr.GetPhysicalAddress( ) );
 
     assert( Present( addr ) );
 
-    for( uint64_t i = 0; i < numAssoc; i++ )
-    {
-        if( set[i].address.GetPhysicalAddress( ) == addr.GetPhysicalAddress( ) 
-            && (set[i].flags & CACHE_ENTRY_VALID) )
-        {
-            *data = set[i].data;
-            rv = true;
-
-            /* Move cache entry to MRU position */
-            CacheEntry tmp;
+    if( way == numAssoc )
+        return false;
 
-            tmp.flags = set[i].flags;
-            tmp.address = set[i].address;
-            tmp.data = set[i].data;
+    if( lineData )
+        *data = lineData[set + way];
 
-            for( uint64_t j = i; j > 0; j-- )
-            {
-                set[j].flags = set[j-1].flags;
-                set[j].address = set[j-1].address;
-                set[j].data = set[j-1].data;
-            }
+    /* Move cache entry to MRU position */
+    MoveToMRU( set, FindPosition( set, way ) );
 
-            set[0].flags = tmp.flags;
-            set[0].address = tmp.address;
-            set[0].data = tmp.data;
-        }
-    }
-
-    return rv;
+    return true;
 }
 
 bool CacheBank::Write( NVMAddress& addr, NVMDataBlock& data )
 {
-    CacheEntry *set = FindSet( addr );
-    bool rv = false;
+    uint64_t set = FindSet( addr );
+    uint64_t way = FindWay( set, addr.GetPhysicalAddress( ) );
 
     assert( Present( addr ) );
 
-    for( uint64_t i = 0; i < numAssoc; i++ )
-    {
-        if( set[i].address.GetPhysicalAddress( ) == addr.GetPhysicalAddress( )
-            && (set[i].flags & CACHE_ENTRY_VALID) )
-        {
-            set[i].data = data;
-            set[i].flags |= CACHE_ENTRY_DIRTY;
-            rv = true;
-
-            /* Move cache entry to MRU position */
-            CacheEntry tmp;
+    if( way == numAssoc )
+        return false;
 
-            tmp.flags = set[i].flags;
-            tmp.address = set[i].address;
-            tmp.data = set[i].data;
+    if( lineData )
+        lineData[set + way] = data;
+    lineFlags[set + way] |= CACHE_ENTRY_DIRTY;
 
-            for( uint64_t j = i; j > 1; j-- )
-            {
-                set[j].flags = set[j-1].flags;
-                set[j].address = set[j-1].address;
-                set[j].data = set[j-1].data;
-            }
+    /* Move cache entry to MRU position */
+    MoveToMRU( set, FindPosition( set, way ) );
 
-            set[0].flags = tmp.flags;
-            set[0].address = tmp.address;
-            set[0].data = tmp.data;
-        }
-    }
-
-    return rv;
+    return true;
 }
 
 /* 
@@ -275,36 +292,38 @@ bool CacheBank::Write( NVMAddress& addr, NVMDataBlock& data )
  */
 bool CacheBank::UpdateData( NVMAddress& addr, NVMDataBlock& data )
 {
-    CacheEntry *set = FindSet( addr );
-    bool rv = false;
+    uint64_t set = FindSet( addr );
+    uint64_t way = FindWay( set, addr.GetPhysicalAddress( ) );
 
     assert( Present( addr ) );
 
-    for( uint64_t i = 0; i < numAssoc; i++ )
-    {
-        if( set[i].address.GetPhysicalAddress( ) == addr.GetPhysicalAddress( )
-            && (set[i].flags & CACHE_ENTRY_VALID) )
-        {
-            set[i].data = data;
-            rv = true;
-        }
-    }
+    if( way == numAssoc )
+        return false;
 
-    return rv;
+    if( lineData )
+        lineData[set + way] = data;
+
+    return true;
 }
 
-/* Return true if the victim data is dirty. */
+/* 
+ *  Return true if the victim data is dirty. The victim keeps the translated
+ *  address of addr, which maps to the same set, with the physical address of
+ *  the least recently used line.
+ */
 bool CacheBank::ChooseVictim( NVMAddress& addr, NVMAddress *victim )
 {
     bool rv = false;
-    CacheEntry *set = FindSet( addr );
+    uint64_t set = FindSet( addr );
+    uint64_t way = lruOrder[set + numAssoc - 1];
 
     assert( SetFull( addr ) );
-    assert( set[numAssoc-1].flags & CACHE_ENTRY_VALID );
+    assert( lineFlags[set + way] & CACHE_ENTRY_VALID );
 
-    *victim = set[numAssoc-1].address;
+    *victim = addr;
+    victim->SetPhysicalAddress( tags[set + way] );
     
-    if( set[numAssoc-1].flags & CACHE_ENTRY_DIRTY )
+    if( lineFlags[set + way] & CACHE_ENTRY_DIRTY )
         rv = true;
 
     return rv;
@@ -314,33 +333,20 @@ bool CacheBank::ChooseVictim( NVMAddress& addr, NVMAddress *victim )
 bool CacheBank::Evict( NVMAddress& addr, NVMDataBlock *data )
 {
     bool rv;
-    CacheEntry *set = FindSet( addr );
+    uint64_t set = FindSet( addr );
+    uint64_t way = FindWay( set, addr.GetPhysicalAddress( ) );
 
     assert( Present( addr ) );
 
-    rv = false; 
-
-    for( uint64_t i = 0; i < numAssoc; i++ )
-    {
-        if( set[i].address.GetPhysicalAddress( ) == addr.GetPhysicalAddress( ) 
-            && (set[i].flags & CACHE_ENTRY_VALID) )
-        {
-            if( set[i].flags & CACHE_ENTRY_DIRTY )
-            {
-                *data = set[i].data;
-                rv = true;
-            }
-            else
-            {
-                *data = set[i].data;
-                rv = false;
-            }
+    if( way == numAssoc )
+        return false;
 
-            set[i].flags = CACHE_ENTRY_NONE;
+    if( lineData )
+        *data = lineData[set + way];
+    rv = (lineFlags[set + way] & CACHE_ENTRY_DIRTY) ? true : false;
 
-            break;
-        }
-    }
+    tags[set + way] = invalidTag;
+    lineFlags[set + way] = CACHE_ENTRY_NONE;
 
     return rv;
 }
@@ -388,18 +394,10 @@ double CacheBank::GetCacheOccupancy( )
     valid = 0;
     total = numRows*numSets*numAssoc;
 
-    for( uint64_t rowIdx = 0; rowIdx < numRows; rowIdx++ )
+    for( uint64_t lineIdx = 0; lineIdx < total; lineIdx++ )
     {
-        for( uint64_t setIdx = 0; setIdx < numSets; setIdx++ )
-        {
-            CacheEntry *set = cacheEntry[rowIdx][setIdx];
-
-            for( uint64_t assocIdx = 0; assocIdx < numAssoc; assocIdx++ )
-            {
-                if( set[assocIdx].flags & CACHE_ENTRY_VALID )
-                    valid++;
-            }
-        }
+        if( lineFlags[lineIdx] & CACHE_ENTRY_VALID )
+            valid++;
     }
 
     occupancy = static_cast<double>(valid) / static_cast<double>(total);
@@ -407,6 +405,31 @@ double CacheBank::GetCacheOccupancy( )
     return occupancy;
 }
 
+uint64_t CacheBank::GetCheckpointSize( )
+{
+    uint64_t lines = numRows*numSets*numAssoc;
+
+    return lines * (sizeof(uint64_t) + 2*sizeof(uint8_t));
+}
+
+void CacheBank::WriteCheckpoint( std::ostream& out )
+{
+    uint64_t lines = numRows*numSets*numAssoc;
+
+    out.write( reinterpret_cast<const char *>(tags), lines*sizeof(uint64_t) );
+    out.write( reinterpret_cast<const char *>(lineFlags), lines*sizeof(uint8_t) );
+    out.write( reinterpret_cast<const char *>(lruOrder), lines*sizeof(uint8_t) );
+}
+
+void CacheBank::ReadCheckpoint( std::istream& in )
+{
+    uint64_t lines = numRows*numSets*numAssoc;
+
+    in.read( reinterpret_cast<char *>(tags), lines*sizeof(uint64_t) );
+    in.read( reinterpret_cast<char *>(lineFlags), lines*sizeof(uint8_t) );
+    in.read( reinterpret_cast<char *>(lruOrder), lines*sizeof(uint8_t) );
+}
+
 bool CacheBank::IsIssuable( NVMainRequest * /*req*/, FailReason * /*reason*/ )
 {
     bool rv = false;
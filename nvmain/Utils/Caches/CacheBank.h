@@ -35,6 +35,7 @@
 #define __NVMAIN_UTILS_CACHES_CACHEBANK_H__
 
 #include <utility>
+#include <iostream>
 #include "include/NVMAddress.h"
 #include "include/NVMDataBlock.h"
 #include "src/NVMObject.h"
@@ -66,17 +67,15 @@ enum { CACHE_ENTRY_NONE = 0,
        CACHE_ENTRY_EXAMPLE = 4
 };
 
-struct CacheEntry
-{
-    uint64_t flags;
-    NVMAddress address;
-    NVMDataBlock data;
-};
-
 class CacheBank : public NVMObject
 {
   public:
-    CacheBank( uint64_t rows, uint64_t sets, uint64_t assoc, uint64_t lineSize );
+    /* 
+     *  A tag-only bank keeps no line data. Read and Evict then leave *data
+     *  untouched, and data passed to Install, Write and UpdateData is ignored.
+     */
+    CacheBank( uint64_t rows, uint64_t sets, uint64_t assoc, uint64_t lineSize,
+               bool tagOnly = false );
     ~CacheBank( );
 
     /* Return true if the address is in the cache. */
@@ -118,19 +117,44 @@ class CacheBank : public NVMObject
 
     void SetDecodeFunction( NVMObject *dcClass, CacheSetDecoder dcFunc );
 
+    /* Save or restore the tags, state and LRU order. Line data is not saved. */
+    uint64_t GetCheckpointSize( );
+    void WriteCheckpoint( std::ostream& out );
+    void ReadCheckpoint( std::istream& in );
+
     uint64_t numRows, numSets, numAssoc, cachelineSize;
-    CacheEntry ***cacheEntry;
     uint64_t accessTime, stateTimer;
     uint64_t readTime, writeTime;
     CacheState state;
 
-    CacheEntry *FindSet( NVMAddress& addr );
     uint64_t SetID( NVMAddress& addr );
+    /* Index of the set holding addr among all sets of this bank. */
+    uint64_t SetIndex( NVMAddress& addr );
     bool isMissMap;
 
     CacheSetDecoder decodeFunc;
     NVMObject *decodeClass;
     uint64_t DefaultDecoder( NVMAddress& addr );
+
+  private:
+    /*
+     *  All lines of the bank are stored in flat arrays indexed by
+     *  (row * numSets + set) * numAssoc + way. Invalid lines hold invalidTag,
+     *  so a lookup is a single compare over the ways of a set. Lines never
+     *  move between ways. Instead lruOrder holds, for each set, the ways from
+     *  most to least recently used.
+     */
+    static const uint64_t invalidTag = ~0ULL;
+
+    uint64_t *tags;
+    uint8_t *lineFlags;
+    uint8_t *lruOrder;
+    NVMDataBlock *lineData; // NULL for a tag-only bank
+
+    uint64_t FindSet( NVMAddress& addr );
+    uint64_t FindWay( uint64_t set, uint64_t tag );
+    uint64_t FindPosition( uint64_t set, uint64_t way );
+    void MoveToMRU( uint64_t set, uint64_t position );
 };
 
 }; 
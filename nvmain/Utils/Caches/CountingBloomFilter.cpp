@@ -0,0 +1,98 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Utils/Caches/CountingBloomFilter.h"
+
+#include <cstring>
+#include <cassert>
+
+using namespace NVM;
+
+CountingBloomFilter::CountingBloomFilter( uint64_t numCounters, uint64_t numHashes )
+{
+    assert( numCounters > 0 && numHashes > 0 );
+
+    this->numCounters = numCounters;
+    this->numHashes = numHashes;
+
+    counters = new uint8_t[numCounters];
+    memset( counters, 0, numCounters );
+}
+
+CountingBloomFilter::~CountingBloomFilter( )
+{
+    delete [] counters;
+}
+
+/* Double hashing: the i-th index is h1 + i * h2. */
+uint64_t CountingBloomFilter::Index( uint64_t key, uint64_t hash )
+{
+    uint64_t h1 = key * 0x9E3779B97F4A7C15ULL;
+    uint64_t h2 = ((key ^ (key >> 31)) * 0xBF58476D1CE4E5B9ULL) | 1;
+
+    return ((h1 + hash * h2) >> 16) % numCounters;
+}
+
+void CountingBloomFilter::Insert( uint64_t key )
+{
+    for( uint64_t hash = 0; hash < numHashes; hash++ )
+    {
+        uint8_t& counter = counters[Index( key, hash )];
+
+        if( counter != 0xFF )
+            counter++;
+    }
+}
+
+void CountingBloomFilter::Remove( uint64_t key )
+{
+    for( uint64_t hash = 0; hash < numHashes; hash++ )
+    {
+        uint8_t& counter = counters[Index( key, hash )];
+
+        /* A saturated counter no longer knows its count. */
+        if( counter != 0xFF && counter != 0 )
+            counter--;
+    }
+}
+
+bool CountingBloomFilter::MayContain( uint64_t key )
+{
+    for( uint64_t hash = 0; hash < numHashes; hash++ )
+    {
+        if( counters[Index( key, hash )] == 0 )
+            return false;
+    }
+
+    return true;
+}
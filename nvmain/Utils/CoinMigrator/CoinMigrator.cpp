@@ -50,11 +50,6 @@ CoinMigrator::CoinMigrator( )
      */
     SetHookType( NVMHOOK_BOTHISSUE );
 
-    promoRequest = NULL;
-    demoRequest = NULL;
-    promoBuffered = false;
-    demoBuffered = false;
-
     migrationCount = 0;
     queueWaits = 0;
     bufferedReads = 0;
@@ -128,7 +123,17 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
         Migrator *migratorTranslator = dynamic_cast<Migrator *>(parent->GetTrampoline( )->GetDecoder( ));
         assert( migratorTranslator != NULL );
 
-        if( request->owner == parent->GetTrampoline( ) && request->tag == MIG_READ_TAG )
+        /* Find the migration this request belongs to, if any. */
+        std::list<MigrationSlot>::iterator slot;
+
+        for( slot = migrations.begin( ); slot != migrations.end( ); slot++ )
+        {
+            if( request == slot->promoRequest || request == slot->demoRequest )
+                break;
+        }
+
+        if( slot != migrations.end( ) && request->owner == parent->GetTrampoline( ) 
+            && request->tag == MIG_READ_TAG )
         {
             /* A migration read completed, update state. */
             migratorTranslator->SetMigrationState( request->address, MIGRATION_BUFFERED ); 
@@ -136,28 +141,24 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
             /* If both requests are buffered, we can attempt to write. */
             bool bufferComplete = false;
 
-            if( (request == promoRequest 
-                 && migratorTranslator->IsBuffered( demotee ))
-                || (request == demoRequest
-                 && migratorTranslator->IsBuffered( promotee )) )
+            if( (request == slot->promoRequest 
+                 && migratorTranslator->IsBuffered( slot->demotee ))
+                || (request == slot->demoRequest
+                 && migratorTranslator->IsBuffered( slot->promotee )) )
             {
                 bufferComplete = true;
             }
 
             /* Make a new request to issue for write. Parent will delete current pointer. */
-            if( request == promoRequest )
-            {
-                promoRequest = new NVMainRequest( );
-                *promoRequest = *request;
-            }
-            else if( request == demoRequest )
+            if( request == slot->promoRequest )
             {
-                demoRequest = new NVMainRequest( );
-                *demoRequest = *request;
+                slot->promoRequest = new NVMainRequest( );
+                *(slot->promoRequest) = *request;
             }
             else
             {
-                assert( false );
+                slot->demoRequest = new NVMainRequest( );
+                *(slot->demoRequest) = *request;
             }
 
             /* Swap the address and set type to write. */
@@ -170,6 +171,8 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
                  *  are issuing requests to.
                  */
                 NVMObject *savedParent = parent->GetTrampoline( );
+                NVMainRequest *promoRequest = slot->promoRequest;
+                NVMainRequest *demoRequest = slot->demoRequest;
 
                 NVMAddress tempAddress = promoRequest->address;
                 promoRequest->address = demoRequest->address;
@@ -196,33 +199,50 @@ bool CoinMigrator::RequestComplete( NVMainRequest *request )
                     migratorTranslator->SetMigrationState( promoRequest->address, MIGRATION_WRITING );
                 }
 
-                promoBuffered = !promoIssued;
-                demoBuffered = !demoIssued;
+                slot->promoBuffered = !promoIssued;
+                slot->demoBuffered = !demoIssued;
             }
         }
         /* A write completed. */
-        else if( request->owner == parent->GetTrampoline( ) && request->tag == MIG_WRITE_TAG )
+        else if( slot != migrations.end( ) && request->owner == parent->GetTrampoline( ) 
+                 && request->tag == MIG_WRITE_TAG )
         {
             // Note: request should be deleted by parent
             migratorTranslator->SetMigrationState( request->address, MIGRATION_DONE );
 
             migrationCount++;
+
+            /* Both pages are written, this migration is finished. */
+            if( request == slot->promoRequest )
+                slot->promoRequest = NULL;
+            else
+                slot->demoRequest = NULL;
+
+            slot->writesDone++;
+
+            if( slot->writesDone == 2 )
+                migrations.erase( slot );
         }
         /* Some other request completed, see if we can ninja issue some migration writes that did not queue. */
-        else if( promoBuffered || demoBuffered )
+        else
         {
-            bool demoIssued, promoIssued;
-
-            if( promoBuffered )
+            for( slot = migrations.begin( ); slot != migrations.end( ); slot++ )
             {
-                promoIssued = parent->GetTrampoline( )->GetChild( promoRequest )->IssueCommand( promoRequest );
-                promoBuffered = !promoIssued;
-            }
+                if( slot->promoBuffered )
+                {
+                    slot->promoBuffered = !parent->GetTrampoline( )->GetChild( slot->promoRequest )->IssueCommand( slot->promoRequest );
 
-            if( demoBuffered )
-            {
-                demoIssued = parent->GetTrampoline( )->GetChild( demoRequest )->IssueCommand( demoRequest );
-                demoBuffered = !demoIssued;
+                    if( !slot->promoBuffered )
+                        migratorTranslator->SetMigrationState( slot->promoRequest->address, MIGRATION_WRITING );
+                }
+
+                if( slot->demoBuffered )
+                {
+                    slot->demoBuffered = !parent->GetTrampoline( )->GetChild( slot->demoRequest )->IssueCommand( slot->demoRequest );
+
+                    if( !slot->demoBuffered )
+                        migratorTranslator->SetMigrationState( slot->demoRequest->address, MIGRATION_WRITING );
+                }
             }
         }
     }
@@ -252,8 +272,13 @@ bool CoinMigrator::TryMigration( NVMainRequest *request, bool atomic )
         Migrator *migratorTranslator = dynamic_cast<Migrator *>(parent->GetTrampoline( )->GetDecoder( ));
         assert( migratorTranslator != NULL );
 
-        /* Migrations in progress must be served from the buffers during migration. */
-        if( GetCurrentHookType( ) == NVMHOOK_PREISSUE && migratorTranslator->IsBuffered( request->address ) )
+        /* 
+         *  Migrations in progress must be served from the buffers during
+         *  migration. Atomic requests are owned by the caller and have no
+         *  timing, so they simply pass through.
+         */
+        if( !atomic && GetCurrentHookType( ) == NVMHOOK_PREISSUE 
+            && migratorTranslator->IsBuffered( request->address ) )
         {
             /* Short circuit this request so it is not queued. */
             rv = false;
@@ -273,82 +298,105 @@ bool CoinMigrator::TryMigration( NVMainRequest *request, bool atomic )
             return rv;
         }
 
-        /* See if any migration is possible (i.e., no migration is in progress) */
-        bool migrationPossible = false;
-
-        if( !migratorTranslator->Migrating( ) 
-            && !migratorTranslator->IsMigrated( request->address ) 
-            && request->address.GetChannel( ) != promotionChannel )
+        /* Pages already migrated or being migrated are left alone. */
+        if( request->address.GetChannel( ) == promotionChannel
+            || migratorTranslator->IsMigrated( request->address )
+            || migratorTranslator->IsMigrating( request->address ) )
         {
-                migrationPossible = true;
+            return rv;
         }
 
-        if( migrationPossible )
-        {
-            assert( !demoBuffered && !promoBuffered );
+        /* Discard the unused column address. */
+        uint64_t row, bank, rank, channel, subarray;
+        request->address.GetTranslatedAddress( &row, NULL, &bank, &rank, &channel, &subarray );
+
+        NVMAddress page;
+        page.SetPhysicalAddress( migratorTranslator->ReverseTranslate( row, 0, bank, rank, channel, subarray ) );
+        page.SetTranslatedAddress( row, 0, bank, rank, channel, subarray );
 
-            /* Flip a biased coin to determine whether to migrate. */
-            double coinToss = static_cast<double>(::rand_r(&seed)) 
-                            / static_cast<double>(RAND_MAX);
+        NoteAccess( page );
 
-            if( coinToss <= probability )
+        /* See if any migration is possible (i.e., a migration buffer is free) */
+        if( !migratorTranslator->Migrating( ) && ShouldMigrate( page ) )
+        {
+            /* 
+             *  Note: once IssueCommand is called, this hook may receive
+             *  a different parent, but fail the NVMTypeMatch check. As a
+             *  result we need to save a pointer to the NVMain class we
+             *  are issuing requests to.
+             */
+            NVMObject *savedParent = parent->GetTrampoline( );
+
+            MigrationSlot slot;
+            slot.promotee = page;
+            slot.promoRequest = NULL;
+            slot.demoRequest = NULL;
+            slot.promoBuffered = false;
+            slot.demoBuffered = false;
+            slot.writesDone = 0;
+
+            /* Pick a victim to replace. */
+            ChooseVictim( migratorTranslator, slot.promotee, slot.demotee );
+
+            assert( migratorTranslator->IsMigrated( slot.demotee ) == false );
+            assert( migratorTranslator->IsMigrated( slot.promotee ) == false );
+
+            /* With several buffers, the victim may still be on its way in. */
+            if( migratorTranslator->IsMigrating( slot.demotee ) )
             {
-                /* 
-                 *  Note: once IssueCommand is called, this hook may receive
-                 *  a different parent, but fail the NVMTypeMatch check. As a
-                 *  result we need to save a pointer to the NVMain class we
-                 *  are issuing requests to.
-                 */
-                NVMObject *savedParent = parent->GetTrampoline( );
+                queueWaits++;
+            }
+            /* 
+             *  Swap the pages instantly. This leaves the same state as a
+             *  finished timed migration: both pages are done, the buffer is
+             *  free and nothing is tracked in the migration list.
+             */
+            else if( atomic )
+            {
+                migratorTranslator->StartMigration( request->address, slot.demotee );
+                migratorTranslator->SetMigrationState( slot.promotee, MIGRATION_DONE );
+                migratorTranslator->SetMigrationState( slot.demotee, MIGRATION_DONE );
 
-                /* Discard the unused column address. */
-                uint64_t row, bank, rank, channel, subarray;
-                request->address.GetTranslatedAddress( &row, NULL, &bank, &rank, &channel, &subarray );
-                uint64_t promoteeAddress = migratorTranslator->ReverseTranslate( row, 0, bank, rank, channel, subarray ); 
+                assert( !migratorTranslator->IsMigrating( slot.promotee ) );
+                assert( !migratorTranslator->IsMigrating( slot.demotee ) );
 
-                promotee.SetPhysicalAddress( promoteeAddress );
-                promotee.SetTranslatedAddress( row, 0, bank, rank, channel, subarray );
+                migrationCount += 2;
 
-                /* Pick a victim to replace. */
-                ChooseVictim( migratorTranslator, promotee, demotee );
+                MigrationStarted( page );
+            }
+            /* Lastly, make sure we can queue the migration requests. */
+            else if( CheckIssuable( slot.promotee, READ ) &&
+                     CheckIssuable( slot.demotee, READ ) )
+            {
+                migratorTranslator->StartMigration( request->address, slot.demotee );
 
-                assert( migratorTranslator->IsMigrated( demotee ) == false );
-                assert( migratorTranslator->IsMigrated( promotee ) == false );
+                slot.promoRequest = new NVMainRequest( ); 
+                slot.demoRequest = new NVMainRequest( );
 
-                if( atomic )
-                {
-                    migratorTranslator->StartMigration( request->address, demotee );
-                    migratorTranslator->SetMigrationState( promotee, MIGRATION_DONE );
-                    migratorTranslator->SetMigrationState( demotee, MIGRATION_DONE );
-                }
-                /* Lastly, make sure we can queue the migration requests. */
-                else if( CheckIssuable( promotee, READ ) &&
-                         CheckIssuable( demotee, READ ) )
-                {
-                    migratorTranslator->StartMigration( request->address, demotee );
+                slot.promoRequest->address = slot.promotee;
+                slot.promoRequest->type = READ;
+                slot.promoRequest->tag = MIG_READ_TAG;
+                slot.promoRequest->burstCount = numCols;
 
-                    promoRequest = new NVMainRequest( ); 
-                    demoRequest = new NVMainRequest( );
+                slot.demoRequest->address = slot.demotee;
+                slot.demoRequest->type = READ;
+                slot.demoRequest->tag = MIG_READ_TAG;
+                slot.demoRequest->burstCount = numCols;
 
-                    promoRequest->address = promotee;
-                    promoRequest->type = READ;
-                    promoRequest->tag = MIG_READ_TAG;
-                    promoRequest->burstCount = numCols;
+                slot.promoRequest->owner = savedParent;
+                slot.demoRequest->owner = savedParent;
 
-                    demoRequest->address = demotee;
-                    demoRequest->type = READ;
-                    demoRequest->tag = MIG_READ_TAG;
-                    demoRequest->burstCount = numCols;
+                /* Track the slot before issuing, in case a read completes right away. */
+                migrations.push_back( slot );
 
-                    promoRequest->owner = savedParent;
-                    demoRequest->owner = savedParent;
-                    savedParent->IssueCommand( promoRequest );
-                    savedParent->IssueCommand( demoRequest );
-                }
-                else
-                {
-                    queueWaits++;
-                }
+                savedParent->IssueCommand( slot.promoRequest );
+                savedParent->IssueCommand( slot.demoRequest );
+
+                MigrationStarted( page );
+            }
+            else
+            {
+                queueWaits++;
             }
         }
     }
@@ -357,6 +405,19 @@ bool CoinMigrator::TryMigration( NVMainRequest *request, bool atomic )
 }
 
 
+/*
+ *  The default policy flips a biased coin on each access to a page that
+ *  could be promoted.
+ */
+bool CoinMigrator::ShouldMigrate( NVMAddress& /*page*/ )
+{
+    double coinToss = static_cast<double>(::rand_r(&seed)) 
+                    / static_cast<double>(RAND_MAX);
+
+    return (coinToss <= probability);
+}
+
+
 void CoinMigrator::ChooseVictim( Migrator *at, NVMAddress& /*promotee*/, NVMAddress& victim )
 {
     /*
@@ -38,10 +38,12 @@
 #include "src/Params.h"
 #include "include/NVMainRequest.h"
 
+#include <list>
+
 namespace NVM {
 
-#define MIG_READ_TAG GetTagGenerator( )->CreateTag("MIGREAD")
-#define MIG_WRITE_TAG GetTagGenerator( )->CreateTag("MIGWRITE")
+#define MIG_READ_TAG TAG_MIGREAD
+#define MIG_WRITE_TAG TAG_MIGWRITE
 
 class Migrator;
 
@@ -59,11 +61,29 @@ class CoinMigrator : public NVMObject
 
     void Cycle( ncycle_t steps );
 
+  protected:
+    /* 
+     *  Migration policy. NoteAccess sees every access to a page outside the
+     *  promotion channel that has not been migrated. ShouldMigrate is asked
+     *  about such a page only when a migration buffer is free, and
+     *  MigrationStarted is called once its migration is underway.
+     */
+    virtual void NoteAccess( NVMAddress& /*page*/ ) { }
+    virtual bool ShouldMigrate( NVMAddress& page );
+    virtual void MigrationStarted( NVMAddress& /*page*/ ) { }
+
   private:
-    bool promoBuffered, demoBuffered; 
-    NVMAddress demotee, promotee; 
-    NVMainRequest *promoRequest;
-    NVMainRequest *demoRequest;
+    /* The requests and buffers of one page swap. */
+    struct MigrationSlot
+    {
+        NVMAddress promotee, demotee;
+        NVMainRequest *promoRequest;
+        NVMainRequest *demoRequest;
+        bool promoBuffered, demoBuffered;
+        int writesDone;
+    };
+
+    std::list<MigrationSlot> migrations;
 
     unsigned int seed;
     double probability;
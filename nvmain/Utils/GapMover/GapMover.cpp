@@ -0,0 +1,312 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Utils/GapMover/GapMover.h"
+#include "Decoders/StartGap/StartGap.h"
+#include "src/MemoryController.h"
+
+using namespace NVM;
+
+GapMover::GapMover( )
+{
+    /* 
+     *  Gap moves are injected after the write that triggered them is queued
+     *  so the write is not turned away by a queue we just filled.
+     */
+    SetHookType( NVMHOOK_BOTHISSUE );
+
+    numCols = 0;
+    queueWaits = 0;
+    copyRetries = 0;
+    movedRewrites = 0;
+}
+
+
+GapMover::~GapMover( )
+{
+
+}
+
+
+void GapMover::Init( Config *config )
+{
+    /* Gap moves copy entire rows. */
+    numCols = config->GetValue( "COLS" );
+
+    AddStat(queueWaits);
+    AddStat(copyRetries);
+    AddStat(movedRewrites);
+}
+
+
+/*
+ *  Returns the StartGap decoder of the memory controller we are attached
+ *  to, or NULL if this controller does not use one.
+ */
+StartGap *GapMover::GetStartGap( )
+{
+    if( !NVMTypeMatches(MemoryController) )
+        return NULL;
+
+    return dynamic_cast<StartGap *>( parent->GetTrampoline( )->GetDecoder( ) );
+}
+
+
+/*
+ *  Once a gap move has been turned away by a full queue, the next free slot
+ *  of that controller is reserved for it.
+ */
+bool GapMover::IsIssuable( NVMainRequest * /*request*/, FailReason * /*reason*/ )
+{
+    StartGap *startGap = GetStartGap( );
+    bool rv = true;
+
+    if( startGap != NULL && GetCurrentHookType( ) == NVMHOOK_PREISSUE )
+    {
+        NVMObject *controller = parent->GetTrampoline( );
+
+        if( reservedSlots.count( controller ) != 0 
+            || bufferedMoves.count( controller ) != 0 )
+        {
+            rv = false;
+        }
+    }
+
+    return rv;
+}
+
+
+bool GapMover::IssueAtomic( NVMainRequest *request )
+{
+    StartGap *startGap = GetStartGap( );
+
+    if( startGap != NULL && GetCurrentHookType( ) == NVMHOOK_POSTISSUE 
+        && request->type == WRITE )
+    {
+        /* For atomic mode, we just move the gaps instantly. */
+        startGap->RecordWrite( request->address.GetPhysicalAddress( ) );
+
+        while( startGap->GapMovePending( ) )
+        {
+            startGap->StartGapMove( );
+            startGap->MoveGap( );
+            startGap->FinishGapMove( );
+        }
+    }
+
+    return true;
+}
+
+
+bool GapMover::IssueCommand( NVMainRequest *request )
+{
+    StartGap *startGap = GetStartGap( );
+
+    if( startGap != NULL && GetCurrentHookType( ) == NVMHOOK_POSTISSUE 
+        && request->type == WRITE )
+    {
+        startGap->RecordWrite( request->address.GetPhysicalAddress( ) );
+
+        TryGapMove( startGap );
+    }
+
+    return true;
+}
+
+
+NVMainRequest *GapMover::MakeGapRead( StartGap *startGap, uint64_t source )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+
+    NVMainRequest *readRequest = new NVMainRequest( );
+
+    startGap->Translate( source, &row, &col, &bank, &rank, &channel, &subarray );
+    readRequest->address.SetPhysicalAddress( source );
+    readRequest->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    readRequest->type = READ;
+    readRequest->tag = GAP_READ_TAG;
+    readRequest->burstCount = numCols;
+    readRequest->owner = parent->GetTrampoline( );
+
+    return readRequest;
+}
+
+
+void GapMover::TryGapMove( StartGap *startGap )
+{
+    if( !startGap->GapMovePending( ) )
+        return;
+
+    NVMObject *controller = parent->GetTrampoline( );
+    NVMainRequest *readRequest = MakeGapRead( startGap, startGap->GetGapMoveSource( ) );
+
+    if( controller->IsIssuable( readRequest ) && controller->IssueCommand( readRequest ) )
+    {
+        startGap->StartGapMove( );
+        reservedSlots.erase( controller );
+    }
+    else
+    {
+        /* The move stays pending and takes the next slot that frees up. */
+        delete readRequest;
+        reservedSlots.insert( controller );
+        queueWaits++;
+    }
+}
+
+
+/* Issues a gap move request now, or after the requests already waiting. */
+void GapMover::IssueMoveRequest( NVMainRequest *request )
+{
+    NVMObject *controller = parent->GetTrampoline( );
+
+    if( bufferedMoves.count( controller ) != 0 || !controller->IssueCommand( request ) )
+        bufferedMoves[controller].push_back( request );
+}
+
+
+void GapMover::IssueBufferedMoves( )
+{
+    NVMObject *controller = parent->GetTrampoline( );
+    std::deque<NVMainRequest *>& buffered = bufferedMoves[controller];
+
+    while( !buffered.empty( ) && controller->IsIssuable( buffered.front( ) )
+           && controller->IssueCommand( buffered.front( ) ) )
+    {
+        buffered.pop_front( );
+    }
+
+    if( buffered.empty( ) )
+        bufferedMoves.erase( controller );
+}
+
+
+/*
+ *  Requests are translated when they are queued. A write queued before its
+ *  row was remapped lands in the row's old place, which is now the gap, so
+ *  write the line again where the row lives now.
+ */
+void GapMover::RewriteMovedLine( StartGap *startGap, NVMainRequest *request )
+{
+    uint64_t row, col, bank, rank, channel, subarray;
+
+    startGap->Translate( request->address.GetPhysicalAddress( ), 
+                         &row, &col, &bank, &rank, &channel, &subarray );
+
+    if( row == request->address.GetRow( ) && subarray == request->address.GetSubArray( ) )
+        return;
+
+    NVMainRequest *rewriteRequest = new NVMainRequest( );
+    *rewriteRequest = *request;
+
+    rewriteRequest->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    rewriteRequest->tag = GAP_REWRITE_TAG;
+    rewriteRequest->owner = parent->GetTrampoline( );
+    rewriteRequest->flags = 0;
+
+    movedRewrites++;
+
+    IssueMoveRequest( rewriteRequest );
+}
+
+
+bool GapMover::RequestComplete( NVMainRequest *request )
+{
+    StartGap *startGap = GetStartGap( );
+
+    if( startGap != NULL && GetCurrentHookType( ) == NVMHOOK_PREISSUE )
+    {
+        NVMObject *controller = parent->GetTrampoline( );
+
+        /* A write landed in the row being copied, so the copy must be redone. */
+        if( request->type == WRITE && request->tag != GAP_WRITE_TAG )
+        {
+            if( startGap->IsMovingRow( request->address.GetPhysicalAddress( ) ) )
+                staleCopies.insert( controller );
+            else
+                RewriteMovedLine( startGap, request );
+        }
+
+        if( request->owner == controller && request->tag == GAP_READ_TAG )
+        {
+            /* Make a new request to issue for write. Parent will delete current pointer. */
+            NVMainRequest *writeRequest = new NVMainRequest( );
+            *writeRequest = *request;
+
+            /* The row keeps its mapping until the copy in the gap is written. */
+            uint64_t row, col, bank, rank, channel, subarray;
+            startGap->TranslateToGap( writeRequest->address.GetPhysicalAddress( ), 
+                                      &row, &col, &bank, &rank, &channel, &subarray );
+            writeRequest->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+            writeRequest->type = WRITE;
+            writeRequest->tag = GAP_WRITE_TAG;
+            writeRequest->flags |= NVMainRequest::FLAG_TRANSLATED;
+
+            IssueMoveRequest( writeRequest );
+        }
+        /* The copy is stale, read the row again. */
+        else if( request->owner == controller && request->tag == GAP_WRITE_TAG 
+                 && staleCopies.count( controller ) != 0 )
+        {
+            staleCopies.erase( controller );
+            copyRetries++;
+
+            IssueMoveRequest( MakeGapRead( startGap, request->address.GetPhysicalAddress( ) ) );
+        }
+        /* A gap move completed, so the row now lives in the old gap. */
+        else if( request->owner == controller && request->tag == GAP_WRITE_TAG )
+        {
+            startGap->MoveGap( );
+            startGap->FinishGapMove( );
+
+            TryGapMove( startGap );
+        }
+        /* Some other request completed, see if a waiting move fits now. */
+        else if( bufferedMoves.count( controller ) != 0 )
+        {
+            IssueBufferedMoves( );
+        }
+        else
+        {
+            TryGapMove( startGap );
+        }
+    }
+
+    return true;
+}
+
+
+void GapMover::Cycle( ncycle_t /*steps*/ )
+{
+
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_UTILS_GAPMOVER_H__
+#define __NVMAIN_UTILS_GAPMOVER_H__
+
+#include "src/NVMObject.h"
+#include "src/Params.h"
+#include "include/NVMainRequest.h"
+
+#include <deque>
+#include <map>
+#include <set>
+
+namespace NVM {
+
+#define GAP_READ_TAG TAG_GAPREAD
+#define GAP_WRITE_TAG TAG_GAPWRITE
+#define GAP_REWRITE_TAG TAG_GAPREWRITE
+
+class StartGap;
+
+/*
+ *  Moves the gaps of the StartGap decoder. Counts the writes each memory
+ *  controller receives and, when a region is due, reads the row next to
+ *  the gap and writes it into the gap through the same controller. The row
+ *  is remapped once the copy is written. Only one gap move is in flight per
+ *  memory controller. Demand writes are not held back, since controllers
+ *  may keep writes queued until more arrive. Writes that land in the row
+ *  during its copy cause the copy to be redone, and writes that were queued
+ *  for the row's old place are written again at its new place.
+ */
+class GapMover : public NVMObject
+{
+  public:
+    GapMover( );
+    ~GapMover( );
+
+    void Init( Config *config );
+
+    bool IsIssuable( NVMainRequest *request, FailReason *reason = NULL );
+    bool IssueAtomic( NVMainRequest *request );
+    bool IssueCommand( NVMainRequest *request );
+    bool RequestComplete( NVMainRequest *request );
+
+    void Cycle( ncycle_t steps );
+
+  private:
+    ncounter_t numCols;
+
+    /* Gap move requests that did not fit in each controller's queue. */
+    std::map<NVMObject *, std::deque<NVMainRequest *> > bufferedMoves;
+    /* Controllers whose next free queue slot is held for a gap move. */
+    std::set<NVMObject *> reservedSlots;
+    /* Controllers whose row being copied was written during the copy. */
+    std::set<NVMObject *> staleCopies;
+
+    ncounter_t queueWaits;
+    ncounter_t copyRetries;
+    ncounter_t movedRewrites;
+
+    StartGap *GetStartGap( );
+    NVMainRequest *MakeGapRead( StartGap *startGap, uint64_t source );
+    void TryGapMove( StartGap *startGap );
+    void IssueMoveRequest( NVMainRequest *request );
+    void IssueBufferedMoves( );
+    void RewriteMovedLine( StartGap *startGap, NVMainRequest *request );
+};
+
+};
+
+#endif
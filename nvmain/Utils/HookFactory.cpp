@@ -37,6 +37,8 @@
 #include "Utils/Visualizer/Visualizer.h"
 #include "Utils/PostTrace/PostTrace.h"
 #include "Utils/CoinMigrator/CoinMigrator.h"
+#include "Utils/HotPageMigrator/HotPageMigrator.h"
+#include "Utils/GapMover/GapMover.h"
 
 
 using namespace NVM;
@@ -49,6 +51,8 @@ NVMObject *HookFactory::CreateHook( std::string hookName )
     if( hookName == "Visualizer" ) hook = new Visualizer( );
     else if( hookName == "PostTrace" ) hook = new PostTrace( );
     else if( hookName == "CoinMigrator" ) hook = new CoinMigrator( );
+    else if( hookName == "HotPageMigrator" ) hook = new HotPageMigrator( );
+    else if( hookName == "GapMover" ) hook = new GapMover( );
     //else if( hookName == "MyHook" ) hook = new MyHook( );
 
     if( hook != NULL )
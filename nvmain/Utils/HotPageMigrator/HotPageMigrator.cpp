@@ -0,0 +1,127 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "Utils/HotPageMigrator/HotPageMigrator.h"
+
+using namespace NVM;
+
+HotPageMigrator::HotPageMigrator( )
+{
+    threshold = 16;
+    epochLength = 10000;
+    epochBudget = 64;
+
+    epochAccesses = 0;
+    epochMigrations = 0;
+
+    hotPromotions = 0;
+    epochs = 0;
+}
+
+
+HotPageMigrator::~HotPageMigrator( )
+{
+
+}
+
+
+void HotPageMigrator::Init( Config *config )
+{
+    CoinMigrator::Init( config );
+
+    /* Accesses in an epoch before a page counts as hot. */
+    config->GetValueUL( "HotPageThreshold", threshold );
+
+    /* Accesses per epoch. Counters are halved at the end of each epoch. */
+    config->GetValueUL( "HotPageEpoch", epochLength );
+
+    /* Promotions allowed per epoch, to bound the migration bandwidth. */
+    config->GetValueUL( "HotPageMigrationsPerEpoch", epochBudget );
+
+    AddStat(hotPromotions);
+    AddStat(epochs);
+}
+
+
+void HotPageMigrator::NoteAccess( NVMAddress& page )
+{
+    accessCounts[page.GetPhysicalAddress( )]++;
+
+    epochAccesses++;
+
+    if( epochAccesses >= epochLength )
+        EndEpoch( );
+}
+
+
+bool HotPageMigrator::ShouldMigrate( NVMAddress& page )
+{
+    if( epochMigrations >= epochBudget )
+        return false;
+
+    std::unordered_map<uint64_t, uint32_t>::iterator it;
+    it = accessCounts.find( page.GetPhysicalAddress( ) );
+
+    return (it != accessCounts.end( ) && it->second >= threshold);
+}
+
+
+void HotPageMigrator::MigrationStarted( NVMAddress& page )
+{
+    /* The page is leaving the slow memory, so stop tracking it. */
+    accessCounts.erase( page.GetPhysicalAddress( ) );
+
+    epochMigrations++;
+    hotPromotions++;
+}
+
+
+void HotPageMigrator::EndEpoch( )
+{
+    std::unordered_map<uint64_t, uint32_t>::iterator it = accessCounts.begin( );
+
+    /* Age every counter, dropping pages that have gone cold. */
+    while( it != accessCounts.end( ) )
+    {
+        it->second >>= 1;
+
+        if( it->second == 0 )
+            it = accessCounts.erase( it );
+        else
+            it++;
+    }
+
+    epochAccesses = 0;
+    epochMigrations = 0;
+    epochs++;
+}
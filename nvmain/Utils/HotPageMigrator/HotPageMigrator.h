@@ -0,0 +1,82 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_UTILS_HOTPAGEMIGRATOR_H__
+#define __NVMAIN_UTILS_HOTPAGEMIGRATOR_H__
+
+#include "Utils/CoinMigrator/CoinMigrator.h"
+
+#include <unordered_map>
+
+namespace NVM {
+
+/*
+ *  Promotes pages by access count instead of at random. Each page outside
+ *  the promotion channel has a counter that is incremented on access. A page
+ *  is promoted once its counter reaches HotPageThreshold, at most
+ *  HotPageMigrationsPerEpoch times per epoch of HotPageEpoch accesses. At the
+ *  end of each epoch all counters are halved, so pages cool down over time.
+ *  Migration itself works as in the CoinMigrator.
+ */
+class HotPageMigrator : public CoinMigrator
+{
+  public:
+    HotPageMigrator( );
+    ~HotPageMigrator( );
+
+    void Init( Config *config );
+
+  protected:
+    void NoteAccess( NVMAddress& page );
+    bool ShouldMigrate( NVMAddress& page );
+    void MigrationStarted( NVMAddress& page );
+
+  private:
+    std::unordered_map<uint64_t, uint32_t> accessCounts;
+
+    ncounter_t threshold;
+    ncounter_t epochLength;
+    ncounter_t epochBudget;
+
+    ncounter_t epochAccesses;
+    ncounter_t epochMigrations;
+
+    ncounter_t hotPromotions;
+    ncounter_t epochs;
+
+    void EndEpoch( );
+};
+
+};
+
+#endif
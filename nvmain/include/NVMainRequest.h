@@ -188,6 +188,8 @@ class NVMainRequest
         FLAG_FORCED = 32,               // This write can not be paused or cancelled
         FLAG_PRIORITY = 64,             // Request (or precursor) that takes priority over write
         FLAG_ISSUED = 128,              // Request has left the command queue
+        FLAG_GROUP_WAIT = 256,          // Command was held by bank group timing
+        FLAG_TRANSLATED = 512,          // Address is already translated for this channel
         FLAG_COUNT
     };
 
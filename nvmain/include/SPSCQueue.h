@@ -0,0 +1,115 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_SPSCQUEUE_H__
+#define __NVMAIN_SPSCQUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+
+namespace NVM {
+
+/*
+ *  Bounded lock-free queue for exactly one producer thread and one consumer
+ *  thread. Push and Pop never block; they fail when the queue is full or
+ *  empty respectively. The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SPSCQueue
+{
+  public:
+    SPSCQueue( size_t capacity )
+    {
+        size = 1;
+        while( size < capacity )
+            size <<= 1;
+
+        buffer = new T[size];
+        head.store( 0 );
+        tail.store( 0 );
+    }
+
+    ~SPSCQueue( )
+    {
+        delete [] buffer;
+    }
+
+    /* Producer only. */
+    bool Push( const T& item )
+    {
+        size_t t = tail.load( std::memory_order_relaxed );
+
+        if( t - head.load( std::memory_order_acquire ) == size )
+            return false;
+
+        buffer[t & (size - 1)] = item;
+        tail.store( t + 1, std::memory_order_release );
+
+        return true;
+    }
+
+    /* Consumer only. */
+    bool Pop( T& item )
+    {
+        size_t h = head.load( std::memory_order_relaxed );
+
+        if( h == tail.load( std::memory_order_acquire ) )
+            return false;
+
+        item = buffer[h & (size - 1)];
+        head.store( h + 1, std::memory_order_release );
+
+        return true;
+    }
+
+    bool Empty( )
+    {
+        return head.load( std::memory_order_acquire ) 
+            == tail.load( std::memory_order_acquire );
+    }
+
+  private:
+    T *buffer;
+    size_t size;
+
+    /* Keep the indices on separate cache lines to avoid false sharing. */
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+    SPSCQueue( const SPSCQueue& );
+    SPSCQueue& operator=( const SPSCQueue& );
+};
+
+};
+
+#endif
@@ -40,32 +40,54 @@
 #include <assert.h>
 #include <limits>
 #include "src/Config.h"
+#include "src/ConfigSchema.h"
+#include "src/Params.h"
 
 using namespace NVM;
 
+ConfigValue::ConfigValue( )
+{
+    intValue = -1;
+    ulValue = std::numeric_limits<uint64_t>::max( );
+    floatValue = -1.0;
+    boolValue = false;
+}
+
+ConfigValue::ConfigValue( const std::string& value )
+{
+    text = value;
+    intValue = atoi( value.c_str( ) );
+    ulValue = strtoul( value.c_str( ), NULL, 10 );
+    floatValue = (double)atof( value.c_str( ) );
+    boolValue = (value == "true");
+}
+
 Config::Config( )
 {
     simPtr = NULL;
     useDebugLog = false;
+    parsedParams = NULL;
+    configErrors = 0;
+
+    BuildSlots( );
 }
 
 
 Config::~Config( )
 {
+    delete parsedParams;
 }
 
 Config::Config(const Config& conf)
 {
-    std::map<std::string, std::string>::iterator it;
-    std::map<std::string, std::string> tmpMap (conf.values);
-
-    for( it = tmpMap.begin(); it != tmpMap.end(); it++ )
-    {
-        values.insert( std::pair<std::string, std::string>( it->first, it->second ) );
-    }
+    values = conf.values;
+    BuildSlots( );
 
     fileName = conf.fileName;
     simPtr = conf.simPtr;
+    useDebugLog = false;
+    parsedParams = NULL;
+    configErrors = 0;
 
     std::vector<std::string> tmpVec(conf.hookList);
     std::vector<std::string>::iterator vit;
@@ -88,8 +110,8 @@ void Config::Read( std::string filename )
 {
     std::string line;
     std::ifstream configFile( filename.c_str( ) );
-    std::map<std::string, std::string>::iterator i;
     std::string subline;
+    std::vector<std::string> readKeys;
 
     this->fileName = filename;
 
@@ -145,9 +167,7 @@ void Config::Read( std::string filename )
             
             tokens = strtok( NULL, " " );
             
-            i = values.find( ty );
-            if( i != values.end( ) )
-                values.erase( i );
+            EraseValue( ty );
 
             if( tokens != NULL )
             {
@@ -158,15 +178,17 @@ void Config::Read( std::string filename )
                 }
                 else
                 {
-                    values.insert( std::pair<std::string, 
-                            std::string>( ty, tokens ) );
+                    InsertValue( ty, tokens );
+                    readKeys.push_back( ty );
                 }
             }
             else
             {
                 std::cout << "Config: Missing value for key " << ty << std::endl;
-                values.insert( std::pair<std::string, std::string>( ty, "" ) );
+                InsertValue( ty, "" );
             }
+
+            delete [] cline;
         }
     }
     else
@@ -176,271 +198,348 @@ void Config::Read( std::string filename )
         exit(1);
     }
 
+    /* Check the keys after the whole file is read so StrictConfig may appear anywhere. */
+    std::vector<std::string>::iterator kit;
+    for( kit = readKeys.begin( ); kit != readKeys.end( ); kit++ )
+        Validate( *kit, filename );
+
+    CheckStrict( );
+
     SetDebugLog( );
 }
 
-bool Config::KeyExists( std::string key )
+/* Points the slot of each declared key at its value in values. */
+void Config::BuildSlots( )
 {
-    std::map<std::string, std::string>::iterator i;
+    std::map<std::string, ConfigValue>::iterator it;
 
-    if( values.empty( ) )
-        return false;
+    slots.assign( ConfigSchema::KeyCount( ), NULL );
+
+    for( it = values.begin( ); it != values.end( ); it++ )
+    {
+        int keyIdx = ConfigSchema::Index( it->first );
+
+        if( keyIdx >= 0 )
+            slots[keyIdx] = &(it->second);
+    }
+}
 
-    i = values.find( key );
+/* Returns the value of key, or NULL if it is not set. Does not warn. */
+ConfigValue *Config::LookupValue( const std::string& key )
+{
+    int keyIdx = ConfigSchema::Index( key );
 
-    if( i == values.end( ) )
-        return false;
+    if( keyIdx >= 0 )
+        return slots[keyIdx];
 
-    return true;
+    std::map<std::string, ConfigValue>::iterator i = values.find( key );
+
+    return (i == values.end( )) ? NULL : &(i->second);
 }
 
+/* As above, but the slot of a declared key is already known. */
+ConfigValue *Config::LookupValue( const ConfigKey& key )
+{
+    if( key.index >= 0 )
+        return slots[key.index];
+
+    std::map<std::string, ConfigValue>::iterator i = values.find( key.name );
 
-void Config::GetString( std::string key, std::string& value )
+    return (i == values.end( )) ? NULL : &(i->second);
+}
+
+void Config::InsertValue( const std::string& key, const std::string& value )
 {
-    if( !KeyExists( key ) && !warned.count( key ) )
-    {   
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '" << value 
-                  << "' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+    std::map<std::string, ConfigValue>::iterator i;
+    int keyIdx = ConfigSchema::Index( key );
+
+    i = values.insert( std::pair<std::string, ConfigValue>( key, ConfigValue( value ) ) ).first;
+
+    if( keyIdx >= 0 )
+        slots[keyIdx] = &(i->second);
+
+    delete parsedParams;
+    parsedParams = NULL;
+}
+
+void Config::EraseValue( const std::string& key )
+{
+    int keyIdx = ConfigSchema::Index( key );
+
+    values.erase( key );
+
+    if( keyIdx >= 0 )
+        slots[keyIdx] = NULL;
+}
+
+void Config::Validate( const std::string& key, const std::string& source )
+{
+    const ConfigKeyInfo *info = ConfigSchema::Find( key );
+
+    if( info == NULL )
+    {
+        std::string suggestion = ConfigSchema::Suggest( key );
+
+        std::cout << "Config: Warning: Unknown key " << key << " in " 
+                  << source << ".";
+        if( suggestion != "" )
+            std::cout << " Did you mean " << suggestion << "?";
+        std::cout << std::endl;
+
+        configErrors++;
+        return;
     }
-    else if( KeyExists( key ) )
+
+    std::string error = ConfigSchema::Validate( info, LookupValue( key )->text );
+
+    if( error != "" )
     {
-        value = GetString( key );
+        std::cout << "Config: Warning: Key " << key << ": " << error 
+                  << std::endl;
+        configErrors++;
     }
 }
 
+void Config::CheckStrict( )
+{
+    const ConfigValue *strict = LookupValue( "StrictConfig" );
 
-std::string Config::GetString( std::string key )
+    if( configErrors > 0 && strict != NULL && strict->boolValue )
+    {
+        std::cout << "NVMain: " << configErrors << " configuration error(s) "
+                  << "with StrictConfig set. Exiting." << std::endl;
+        exit(1);
+    }
+}
+
+bool Config::KeyExists( std::string key )
+{
+    return (LookupValue( key ) != NULL);
+}
+
+bool Config::KeyExists( const ConfigKey& key )
 {
-    std::map<std::string, std::string>::iterator i;
-    std::string value;
+    return (LookupValue( key ) != NULL);
+}
 
+/*
+ *  Returns the value of key. A missing key returns NULL, so the caller
+ *  should return missingValue, and is warned about once.
+ */
+const ConfigValue *Config::FindValue( const ConfigKey& key, 
+                                      const char *missingValue )
+{
     if( values.empty( ) )
     {
         std::cerr << "Configuration has not been read yet." << std::endl;
-        return "";
+        return NULL;
     }
 
-    i = values.find( key );
+    const ConfigValue *value = LookupValue( key );
 
-    if( !KeyExists( key ) && !warned.count( key ) )
+    if( value == NULL && !warned.count( key.name ) )
     {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" 
+                  << missingValue << "' as the default. Please configure this "
+                  << "value if this is wrong." << std::endl;
+        warned.insert( key.name );
     }
 
-
-    /*
-     *  Find returns map::end if the element is not found. We will use -1 as
-     *  the error code. Functions calling this function should check for -1
-     *  for possible configuration file problems.
-     *
-     *  If the key is found, return the second element (the key value).
-     */
-    if( i == values.end( ) )
-        value = "";
-    else
-        value = i->second;
-
     return value;
 }
 
 
-void Config::SetString( std::string key, std::string value )
+void Config::GetString( std::string key, std::string& value )
 {
-    values.insert( std::pair<std::string, std::string>( key, value ) );
+    GetString( ConfigKey( key ), value );
 }
 
-void Config::GetValueUL( std::string key, uint64_t& value )
+void Config::GetString( const ConfigKey& key, std::string& value )
 {
-    if( !KeyExists( key ) && !warned.count( key ) )
-    {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '" << value
+    const ConfigValue *found = LookupValue( key );
+
+    if( found == NULL && !warned.count( key.name ) )
+    {   
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" << value 
                   << "' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        warned.insert( key.name );
     }
-    else if( KeyExists( key ) )
+    else if( found != NULL )
     {
-        value = GetValueUL( key );
+        value = found->text;
     }
 }
 
-uint64_t Config::GetValueUL( std::string key )
+
+std::string Config::GetString( std::string key )
 {
-    std::map<std::string, std::string>::iterator i;
-    uint64_t value;
+    return GetString( ConfigKey( key ) );
+}
 
-    if( values.empty( ) )
-    {
-        std::cerr << "Configuration has not been read yet." << std::endl;
-        return std::numeric_limits<uint64_t>::max( );
-    }
+std::string Config::GetString( const ConfigKey& key )
+{
+    const ConfigValue *value = FindValue( key, "" );
 
-    i = values.find( key );
+    return (value == NULL) ? "" : value->text;
+}
 
-    if( !KeyExists( key ) && !warned.count( key ) )
-    {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '-1' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
-    }
 
-    /*
-     *  Find returns map::end if the element is not found. We will use -1 as
-     *  the error code. Functions calling this function should check for -1
-     *  for possible configuration file problems.
-     *
-     *  If the key is found, return the second element (the key value).
-     */
-    if( i == values.end( ) )
-        value = std::numeric_limits<uint64_t>::max( );
-    else
-        value = strtoul( i->second.c_str( ), NULL, 10 );
+void Config::SetString( std::string key, std::string value )
+{
+    if( !KeyExists( key ) )
+        InsertValue( key, value );
+}
 
-    return value;
+void Config::GetValueUL( std::string key, uint64_t& value )
+{
+    GetValueUL( ConfigKey( key ), value );
 }
 
-void Config::GetValue( std::string key, int& value )
+void Config::GetValueUL( const ConfigKey& key, uint64_t& value )
 {
-    if( !KeyExists( key ) && !warned.count( key ) )
+    const ConfigValue *found = LookupValue( key );
+
+    if( found == NULL && !warned.count( key.name ) )
     {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '" << value
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" << value
                   << "' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        warned.insert( key.name );
     }
-    else if( KeyExists( key ) )
+    else if( found != NULL )
     {
-        value = GetValue( key );
+        value = found->ulValue;
     }
 }
 
-int Config::GetValue( std::string key )
+uint64_t Config::GetValueUL( std::string key )
 {
-    std::map<std::string, std::string>::iterator i;
-    int value;
+    return GetValueUL( ConfigKey( key ) );
+}
 
-    if( values.empty( ) )
-    {
-        std::cerr << "Configuration has not been read yet." << std::endl;
-        return -1;
-    }
+uint64_t Config::GetValueUL( const ConfigKey& key )
+{
+    const ConfigValue *value = FindValue( key, "-1" );
+
+    if( value == NULL )
+        return std::numeric_limits<uint64_t>::max( );
 
-    i = values.find( key );
+    return value->ulValue;
+}
 
-    if( !KeyExists( key ) && !warned.count( key ) )
+void Config::GetValue( std::string key, int& value )
+{
+    GetValue( ConfigKey( key ), value );
+}
+
+void Config::GetValue( const ConfigKey& key, int& value )
+{
+    const ConfigValue *found = LookupValue( key );
+
+    if( found == NULL && !warned.count( key.name ) )
     {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '-1' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" << value
+                  << "' as the default. Please configure this value if this is wrong." << std::endl;
+        warned.insert( key.name );
     }
+    else if( found != NULL )
+    {
+        value = found->intValue;
+    }
+}
 
-    /*
-     *  Find returns map::end if the element is not found. We will use -1 as
-     *  the error code. Functions calling this function should check for -1
-     *  for possible configuration file problems.
-     *
-     *  If the key is found, return the second element (the key value).
-     */
-    if( i == values.end( ) )
-        value = -1;
-    else
-        value = atoi( i->second.c_str( ) );
+int Config::GetValue( std::string key )
+{
+    return GetValue( ConfigKey( key ) );
+}
 
-    return value;
+int Config::GetValue( const ConfigKey& key )
+{
+    const ConfigValue *value = FindValue( key, "-1" );
+
+    return (value == NULL) ? -1 : value->intValue;
 }
 
 void Config::SetValue( std::string key, std::string value )
 {
-    std::map<std::string, std::string>::iterator i;
+    EraseValue( key );
 
-    i = values.find( key );
+    InsertValue( key, value );
 
-    if( i != values.end( ) )
-        values.erase( i );
-
-    values.insert( std::pair<std::string, std::string>( key, value ) );
+    Validate( key, "configuration overrides" );
+    CheckStrict( );
 }
 
 void Config::GetEnergy( std::string key, double& value )
 {
-    if( !KeyExists( key ) && !warned.count( key ) )
+    GetEnergy( ConfigKey( key ), value );
+}
+
+void Config::GetEnergy( const ConfigKey& key, double& value )
+{
+    const ConfigValue *found = LookupValue( key );
+
+    if( found == NULL && !warned.count( key.name ) )
     {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '" << value
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" << value
                   << "' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        warned.insert( key.name );
     }
-    else if( KeyExists( key ) )
+    else if( found != NULL )
     {
-        value = GetEnergy( key );
+        value = found->floatValue;
     }
 }
 
 double Config::GetEnergy( std::string key )
 {
-    std::map<std::string, std::string>::iterator i;
-    double value;
-
-    if( values.empty( ) )
-    {
-        std::cerr << "Configuration has not been read yet." << std::endl;
-        return -1;
-    }
-
-    i = values.find( key );
-
-    if( !KeyExists( key ) && !warned.count( key ) )
-    {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '-1.0' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
-    }
+    return GetEnergy( ConfigKey( key ) );
+}
 
-    /*
-     *  Find returns map::end if the element is not found. We will use -1 as
-     *  the error code. Functions calling this function should check for -1
-     *  for possible configuration file problems.
-     *
-     *  If the key is found, return the second element (the key value).
-     */
-    if( i == values.end( ) )
-        value = -1.0;
-    else
-        value = (double)atof( i->second.c_str( ) );
+double Config::GetEnergy( const ConfigKey& key )
+{
+    const ConfigValue *value = FindValue( key, "-1.0" );
 
-    return value;
+    return (value == NULL) ? -1.0 : value->floatValue;
 }
 
 void Config::SetEnergy( std::string key, std::string energy )
 {
-    values.insert( std::pair<std::string, std::string>( key, energy ) );
+    if( !KeyExists( key ) )
+        InsertValue( key, energy );
 }
 
 void Config::GetBool( std::string key, bool& value )
 {
-    if( !KeyExists( key ) && !warned.count( key ) )
+    GetBool( ConfigKey( key ), value );
+}
+
+void Config::GetBool( const ConfigKey& key, bool& value )
+{
+    const ConfigValue *found = LookupValue( key );
+
+    if( found == NULL && !warned.count( key.name ) )
     {
         std::string defaultValue = (value ? "true" : "false");
-        std::cout << "Config: Warning: Key " << key << " is not set. Using '" << defaultValue
+        std::cout << "Config: Warning: Key " << key.name << " is not set. Using '" << defaultValue
                   << "' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
+        warned.insert( key.name );
     }
-    else if( KeyExists( key ) )
+    else if( found != NULL )
     {
-        value = GetBool( key );
+        value = found->boolValue;
     }
 }
 
 bool Config::GetBool( std::string key )
 {
-    bool rv = false;
-
-    if( !KeyExists( key ) && !warned.count( key ) )
-    {
-        std::cout << "Config: Warning: Key " << key << " is not set. Using 'false' as the default. Please configure this value if this is wrong." << std::endl;
-        warned.insert( key );
-    }
+    return GetBool( ConfigKey( key ) );
+}
 
-    if( KeyExists( key ) && GetString( key ) == "true" )
-        rv = true;
+bool Config::GetBool( const ConfigKey& key )
+{
+    const ConfigValue *value = FindValue( key, "false" );
 
-    return rv;
+    return (value == NULL) ? false : value->boolValue;
 }
 
 void Config::SetBool( std::string key, bool value )
@@ -459,14 +558,25 @@ std::vector<std::string>& Config::GetHooks( )
 
 void Config::Print( )
 {
-    std::map<std::string, std::string>::iterator i;
+    std::map<std::string, ConfigValue>::iterator i;
 
     for( i = values.begin( ); i != values.end( ); ++i) 
     {
-        std::cout << (i->first) << " = " << (i->second) << std::endl;
+        std::cout << (i->first) << " = " << (i->second.text) << std::endl;
     }
 }
 
+Params *Config::GetParsedParams( )
+{
+    return parsedParams;
+}
+
+void Config::SetParsedParams( Params *params )
+{
+    delete parsedParams;
+    parsedParams = params;
+}
+
 void Config::SetSimInterface( SimInterface *ptr )
 {
     simPtr = ptr;
@@ -44,6 +44,25 @@
 
 namespace NVM {
 
+class Params;
+class ConfigKey;
+
+/*
+ *  Values are converted to each type once when they are read or set, so the
+ *  getters below do not parse strings on every call.
+ */
+struct ConfigValue
+{
+    ConfigValue( );
+    ConfigValue( const std::string& value );
+
+    std::string text;
+    int intValue;
+    uint64_t ulValue;
+    double floatValue;
+    bool boolValue;
+};
+
 class Config 
 {
   public:
@@ -55,25 +74,42 @@ class Config
     void Read( std::string filename );
     std::string GetFileName( );
 
+    /*
+     *  Getters without a default return -1, -1.0, "" or false for a missing
+     *  key. Getters given a default leave it unchanged. Either way a missing
+     *  key is warned about once. The ConfigKey overloads skip hashing the
+     *  key name.
+     */
     uint64_t GetValueUL( std::string key );
+    uint64_t GetValueUL( const ConfigKey& key );
     void     GetValueUL( std::string Key, uint64_t& value );
+    void     GetValueUL( const ConfigKey& key, uint64_t& value );
     int  GetValue( std::string key );
+    int  GetValue( const ConfigKey& key );
     void GetValue( std::string key, int& value );
+    void GetValue( const ConfigKey& key, int& value );
     void SetValue( std::string key, std::string value );
 
     double GetEnergy( std::string key );
+    double GetEnergy( const ConfigKey& key );
     void   GetEnergy( std::string key, double &energy );
+    void   GetEnergy( const ConfigKey& key, double &energy );
     void   SetEnergy( std::string key, std::string energy );
 
     std::string GetString( std::string key );
+    std::string GetString( const ConfigKey& key );
     void  GetString( std::string key, std::string& value );
+    void  GetString( const ConfigKey& key, std::string& value );
     void  SetString( std::string key, std::string );
 
     bool  GetBool( std::string key );
+    bool  GetBool( const ConfigKey& key );
     void  GetBool( std::string key, bool& value );
+    void  GetBool( const ConfigKey& key, bool& value );
     void  SetBool( std::string key, bool value );
 
     bool KeyExists( std::string key );
+    bool KeyExists( const ConfigKey& key );
 
     std::vector<std::string>& GetHooks( );
 
@@ -89,15 +125,36 @@ class Config
     void SetDebugLog( );
     std::ostream *GetDebugLog( );
 
+    /*
+     *  Params parsed from this configuration. Modules sharing a
+     *  configuration copy these rather than looking up each key again.
+     *  The cache is dropped whenever a value changes.
+     */
+    Params *GetParsedParams( );
+    void SetParsedParams( Params *params );
+
   private:
     std::string fileName;
-    std::map<std::string, std::string> values;
+    std::map<std::string, ConfigValue> values;
+    /* Values of the keys declared in the schema, by ConfigSchema::Index. */
+    std::vector<ConfigValue *> slots;
     std::set<std::string> warned;
     std::vector<std::string> hookList;
     SimInterface *simPtr;
     std::ofstream debugLogFile;
     bool useDebugLog;
-
+    Params *parsedParams;
+    unsigned int configErrors;
+
+    const ConfigValue *FindValue( const ConfigKey& key, 
+                                  const char *missingValue );
+    ConfigValue *LookupValue( const std::string& key );
+    ConfigValue *LookupValue( const ConfigKey& key );
+    void InsertValue( const std::string& key, const std::string& value );
+    void EraseValue( const std::string& key );
+    void BuildSlots( );
+    void Validate( const std::string& key, const std::string& source );
+    void CheckStrict( );
 };
 
 };
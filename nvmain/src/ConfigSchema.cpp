@@ -0,0 +1,447 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "src/ConfigSchema.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace NVM;
+
+static const double noLimit = std::numeric_limits<double>::max( );
+
+/*
+ *  Every key read by the simulator. Defaults match the Params constructor;
+ *  keys whose default depends on other keys (e.g., MATHeight defaults to
+ *  ROWS) or that are handled by the reader have no default here.
+ */
+static const ConfigKeyInfo configKeys[] =
+{
+    /* Organization */
+    { "CHANNELS", ConfigKey_Int, "2", 1, noLimit },
+    { "RANKS", ConfigKey_Int, "2", 1, noLimit },
+    { "BANKS", ConfigKey_Int, "8", 1, noLimit },
+    { "ROWS", ConfigKey_Int, "65536", 1, noLimit },
+    { "COLS", ConfigKey_Int, "32", 1, noLimit },
+    { "MATHeight", ConfigKey_Int, NULL, 1, noLimit },
+    { "MATWidth", ConfigKey_Int, NULL, 1, noLimit },
+    { "RBSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "BusWidth", ConfigKey_Int, "64", 1, noLimit },
+    { "DeviceWidth", ConfigKey_Int, "8", 1, noLimit },
+    { "RanksPerDIMM", ConfigKey_Int, "1", 1, noLimit },
+    { "CLK", ConfigKey_Int, "666", 1, noLimit },
+    { "RATE", ConfigKey_Int, "2", 1, noLimit },
+    { "CPUFreq", ConfigKey_Int, "2000", 1, noLimit },
+    { "RAW", ConfigKey_Int, "4", 1, noLimit },
+    { "BankGroups", ConfigKey_Int, NULL, 1, noLimit },
+
+    /* Timing */
+    { "tAL", ConfigKey_Timing, "0", 0, noLimit },
+    { "tBURST", ConfigKey_Timing, "4", 0, noLimit },
+    { "tCAS", ConfigKey_Timing, "10", 0, noLimit },
+    { "tCCD", ConfigKey_Timing, "4", 0, noLimit },
+    { "tCMD", ConfigKey_Timing, "1", 0, noLimit },
+    { "tCWD", ConfigKey_Timing, "7", 0, noLimit },
+    { "tRAW", ConfigKey_Timing, "20", 0, noLimit },
+    { "tOST", ConfigKey_Timing, "1", 0, noLimit },
+    { "tPD", ConfigKey_Timing, "6", 0, noLimit },
+    { "tRAS", ConfigKey_Timing, "24", 0, noLimit },
+    { "tRCD", ConfigKey_Timing, "9", 0, noLimit },
+    { "tPRCD", ConfigKey_Timing, "3", 0, noLimit },
+    { "tRDB", ConfigKey_Timing, "2", 0, noLimit },
+    { "tREFW", ConfigKey_Timing, "42666667", 0, noLimit },
+    { "tRFC", ConfigKey_Timing, "107", 0, noLimit },
+    { "tRP", ConfigKey_Timing, "9", 0, noLimit },
+    { "tRRDR", ConfigKey_Timing, "5", 0, noLimit },
+    { "tRRDW", ConfigKey_Timing, "5", 0, noLimit },
+    { "tPPD", ConfigKey_Timing, "0", 0, noLimit },
+    { "tRTP", ConfigKey_Timing, "5", 0, noLimit },
+    { "tRTRS", ConfigKey_Timing, "1", 0, noLimit },
+    { "tWP", ConfigKey_Timing, "0", 0, noLimit },
+    { "tWR", ConfigKey_Timing, "10", 0, noLimit },
+    { "tWTR", ConfigKey_Timing, "5", 0, noLimit },
+    { "tXP", ConfigKey_Timing, "6", 0, noLimit },
+    { "tXPDLL", ConfigKey_Timing, "17", 0, noLimit },
+    { "tXS", ConfigKey_Timing, "5", 0, noLimit },
+    { "tXSDLL", ConfigKey_Timing, "512", 0, noLimit },
+    { "tCCD_L", ConfigKey_Timing, NULL, 0, noLimit },
+    { "tRRD_L", ConfigKey_Timing, NULL, 0, noLimit },
+    { "tWTR_L", ConfigKey_Timing, NULL, 0, noLimit },
+    { "tWP0", ConfigKey_Timing, "40", 0, noLimit },
+    { "tWP1", ConfigKey_Timing, "60", 0, noLimit },
+    { "tRDPDEN", ConfigKey_Int, "24", 0, noLimit },
+    { "tWRPDEN", ConfigKey_Int, "19", 0, noLimit },
+    { "tWRAPDEN", ConfigKey_Int, "22", 0, noLimit },
+
+    /* Energy and power */
+    { "EnergyModel", ConfigKey_String, "current", 0, 0 },
+    { "EIDD0", ConfigKey_Float, "85", 0, noLimit },
+    { "EIDD1", ConfigKey_Float, "54", 0, noLimit },
+    { "EIDD2P0", ConfigKey_Float, "30", 0, noLimit },
+    { "EIDD2P1", ConfigKey_Float, "30", 0, noLimit },
+    { "EIDD2N", ConfigKey_Float, "37", 0, noLimit },
+    { "EIDD3P", ConfigKey_Float, "35", 0, noLimit },
+    { "EIDD3N", ConfigKey_Float, "40", 0, noLimit },
+    { "EIDD4R", ConfigKey_Float, "160", 0, noLimit },
+    { "EIDD4W", ConfigKey_Float, "165", 0, noLimit },
+    { "EIDD5B", ConfigKey_Float, "200", 0, noLimit },
+    { "EIDD6", ConfigKey_Float, "12", 0, noLimit },
+    { "Erd", ConfigKey_Float, "3.405401", 0, noLimit },
+    { "Eopenrd", ConfigKey_Float, "1.081080", 0, noLimit },
+    { "Ewr", ConfigKey_Float, "1.023750", 0, noLimit },
+    { "Ewrpb", ConfigKey_Float, NULL, 0, noLimit },
+    { "Eref", ConfigKey_Float, "38.558533", 0, noLimit },
+    { "Eactstdby", ConfigKey_Float, "0.090090", 0, noLimit },
+    { "Eprestdby", ConfigKey_Float, "0.083333", 0, noLimit },
+    { "Epda", ConfigKey_Float, "0", 0, noLimit },
+    { "Epdpf", ConfigKey_Float, "0", 0, noLimit },
+    { "Epdps", ConfigKey_Float, "0", 0, noLimit },
+    { "Ereset", ConfigKey_Float, "0.054331", 0, noLimit },
+    { "Eset", ConfigKey_Float, "0.101581", 0, noLimit },
+    { "Voltage", ConfigKey_Float, "1.5", 0, noLimit },
+    { "VDDQ", ConfigKey_Float, "1.5", -noLimit, noLimit },
+    { "VSSQ", ConfigKey_Float, "0", -noLimit, noLimit },
+    { "Rtt_nom", ConfigKey_Int, "30", 0, noLimit },
+    { "Rtt_wr", ConfigKey_Int, "60", 0, noLimit },
+    { "Rtt_cont", ConfigKey_Int, "75", 0, noLimit },
+    { "UseLowPower", ConfigKey_Bool, "true", 0, 0 },
+    { "PowerDownMode", ConfigKey_String, "FASTEXIT", 0, 0 },
+    { "InitPD", ConfigKey_Bool, "false", 0, 0 },
+
+    /* Refresh */
+    { "UseRefresh", ConfigKey_Bool, "true", 0, 0 },
+    { "RefreshRows", ConfigKey_Int, "4", 1, noLimit },
+    { "StaggerRefresh", ConfigKey_Bool, "false", 0, 0 },
+    { "BanksPerRefresh", ConfigKey_Int, NULL, 1, noLimit },
+    { "SameBankRefresh", ConfigKey_Bool, NULL, 0, 0 },
+    { "DelayedRefreshThreshold", ConfigKey_Int, "1", 0, noLimit },
+
+    /* Memory controller */
+    { "MEM_CTL", ConfigKey_String, NULL, 0, 0 },
+    { "AddressMappingScheme", ConfigKey_String, "R:SA:RK:BK:CH:C", 0, 0 },
+    { "Decoder", ConfigKey_String, NULL, 0, 0 },
+    { "INTERCONNECT", ConfigKey_String, NULL, 0, 0 },
+    { "RankType", ConfigKey_String, NULL, 0, 0 },
+    { "BankType", ConfigKey_String, NULL, 0, 0 },
+    { "QueueModel", ConfigKey_String, NULL, 0, 0 },
+    { "QueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "ReadQueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "WriteQueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "ClosePage", ConfigKey_Int, "1", 0, 2 },
+    { "ScheduleScheme", ConfigKey_Int, "1", 0, noLimit },
+    { "HighWaterMark", ConfigKey_Int, "32", 0, noLimit },
+    { "LowWaterMark", ConfigKey_Int, "16", 0, noLimit },
+    { "StarvationThreshold", ConfigKey_Int, NULL, 0, noLimit },
+    { "UsePrecharge", ConfigKey_Bool, "true", 0, 0 },
+    { "UseWriteBuffer", ConfigKey_Bool, "false", 0, 0 },
+    { "OffChipLatency", ConfigKey_Int, "10", 0, noLimit },
+    { "DeadlockTimer", ConfigKey_Int, "10000000", 0, noLimit },
+    { "MemoryPrefetcher", ConfigKey_String, "none", 0, 0 },
+    { "PrefetchBufferSize", ConfigKey_Int, "32", 0, noLimit },
+    { "CachedRowCount", ConfigKey_Int, NULL, 0, noLimit },
+    { "CachedRowSize", ConfigKey_Int, NULL, 0, noLimit },
+    { "CachedRowsReadOnly", ConfigKey_Bool, NULL, 0, 0 },
+
+    /* DRAM caches and migration */
+    { "DRCVariant", ConfigKey_String, NULL, 0, 0 },
+    { "DRC_CHANNELS", ConfigKey_Int, NULL, 1, noLimit },
+    { "DRCQueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "DRCPredictor", ConfigKey_String, NULL, 0, 0 },
+    { "DRCTagOnly", ConfigKey_Bool, NULL, 0, 0 },
+    { "DRCSetSampling", ConfigKey_Int, "1", 1, noLimit },
+    { "FillQueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "MM_CONFIG", ConfigKey_String, NULL, 0, 0 },
+    { "MissMapSets", ConfigKey_Int, NULL, 1, noLimit },
+    { "MissMapAssoc", ConfigKey_Int, NULL, 1, noLimit },
+    { "MissMapLatency", ConfigKey_Int, NULL, 0, noLimit },
+    { "MissMapQueueSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "MissMapFilter", ConfigKey_Bool, NULL, 0, 0 },
+    { "MissMapFilterCounters", ConfigKey_Int, NULL, 1, noLimit },
+    { "MissMapFilterHashes", ConfigKey_Int, NULL, 1, noLimit },
+    { "PerfectFills", ConfigKey_Bool, "false", 0, 0 },
+    { "VariablePredictorAccuracy", ConfigKey_Float, NULL, 0, 1 },
+    { "CoinMigratorProbability", ConfigKey_Float, NULL, 0, 1 },
+    { "CoinMigratorPromotionChannel", ConfigKey_Int, NULL, 0, noLimit },
+    { "StartGapInterval", ConfigKey_Int, "100", 1, noLimit },
+    { "StartGapRegionRows", ConfigKey_Int, NULL, 2, noLimit },
+    { "StartGapRandomize", ConfigKey_Bool, "false", 0, 0 },
+    { "StartGapSeed", ConfigKey_Int, "1", 0, noLimit },
+    { "MigrationBufferReadLatency", ConfigKey_Int, NULL, 0, noLimit },
+    { "MigrationBuffers", ConfigKey_Int, "1", 1, noLimit },
+    { "HotPageThreshold", ConfigKey_Int, "16", 1, noLimit },
+    { "HotPageEpoch", ConfigKey_Int, "10000", 1, noLimit },
+    { "HotPageMigrationsPerEpoch", ConfigKey_Int, "64", 0, noLimit },
+
+    /* Non-volatile memory */
+    { "EnduranceModel", ConfigKey_String, "NullModel", 0, 0 },
+    { "EnduranceDist", ConfigKey_String, NULL, 0, 0 },
+    { "EnduranceDistMean", ConfigKey_Int, NULL, 0, noLimit },
+    { "EnduranceDistVariance", ConfigKey_Int, NULL, 0, noLimit },
+    { "EnduranceDistSeed", ConfigKey_Int, NULL, 0, noLimit },
+    { "EnduranceProjection", ConfigKey_Bool, "false", 0, 0 },
+    { "DataEncoder", ConfigKey_String, "default", 0, 0 },
+    { "FlipNWriteGranularity", ConfigKey_Int, NULL, 1, noLimit },
+    { "ProgramMode", ConfigKey_String, "SRMS", 0, 0 },
+    { "WriteMode", ConfigKey_String, NULL, 0, 0 },
+    { "MLCLevels", ConfigKey_Int, "1", 1, noLimit },
+    { "WPVariance", ConfigKey_Int, "1", 0, noLimit },
+    { "WPMaxVariance", ConfigKey_Int, "2", 0, noLimit },
+    { "UniformWrites", ConfigKey_Bool, "true", 0, 0 },
+    { "WriteAllBits", ConfigKey_Bool, "true", 0, 0 },
+    { "nWP00", ConfigKey_Int, "0", 0, noLimit },
+    { "nWP01", ConfigKey_Int, "7", 0, noLimit },
+    { "nWP10", ConfigKey_Int, "5", 0, noLimit },
+    { "nWP11", ConfigKey_Int, "1", 0, noLimit },
+    { "WritePausing", ConfigKey_Bool, "false", 0, 0 },
+    { "PauseThreshold", ConfigKey_Float, "0.4", 0, 1 },
+    { "PauseMode", ConfigKey_String, "Normal", 0, 0 },
+    { "MaxCancellations", ConfigKey_Int, "4", 0, noLimit },
+    { "DirectWrite", ConfigKey_Bool, NULL, 0, 0 },
+    { "RealWriteBack", ConfigKey_Bool, NULL, 0, 0 },
+    { "IgnoreBits", ConfigKey_Int, NULL, 0, noLimit },
+
+    /* Simulation, traces, and statistics */
+    { "TraceReader", ConfigKey_String, NULL, 0, 0 },
+    { "IgnoreData", ConfigKey_Bool, "false", 0, 0 },
+    { "IgnoreTraceCycle", ConfigKey_Bool, "false", 0, 0 },
+    { "WarmUpRequests", ConfigKey_Int, "0", 0, noLimit },
+    { "SamplingUnit", ConfigKey_Int, NULL, 0, noLimit },
+    { "SamplingWarmUp", ConfigKey_Int, NULL, 0, noLimit },
+    { "SamplingInterval", ConfigKey_Int, NULL, 1, noLimit },
+    { "MaxOutstandingPerCore", ConfigKey_Int, "0", 0, noLimit },
+    { "AtomicLatencyModel", ConfigKey_Bool, "false", 0, 0 },
+    { "StatsFile", ConfigKey_String, NULL, 0, 0 },
+    { "SweepFile", ConfigKey_String, NULL, 0, 0 },
+    { "SweepThreads", ConfigKey_Int, NULL, 1, noLimit },
+    { "PeriodicStatsInterval", ConfigKey_Int, "0", 0, noLimit },
+    { "PrintGraphs", ConfigKey_Bool, "false", 0, 0 },
+    { "PrintAllDevices", ConfigKey_Bool, "false", 0, 0 },
+    { "PrintConfig", ConfigKey_Bool, "false", 0, 0 },
+    { "PrintPreTrace", ConfigKey_Bool, "false", 0, 0 },
+    { "EchoPreTrace", ConfigKey_Bool, "false", 0, 0 },
+    { "PreTraceFile", ConfigKey_String, NULL, 0, 0 },
+    { "PreTraceWriter", ConfigKey_String, NULL, 0, 0 },
+    { "PreTraceBufferSize", ConfigKey_Int, NULL, 1, noLimit },
+    { "PreTraceCompression", ConfigKey_Int, NULL, 0, 9 },
+    { "PostTraceFile", ConfigKey_String, NULL, 0, 0 },
+    { "PostTraceWriter", ConfigKey_String, NULL, 0, 0 },
+    { "PostTracePerChannel", ConfigKey_Bool, NULL, 0, 0 },
+    { "PostTracePerRank", ConfigKey_Bool, NULL, 0, 0 },
+    { "EchoPostTrace", ConfigKey_Bool, NULL, 0, 0 },
+    { "DRAMPower2XML", ConfigKey_String, NULL, 0, 0 },
+    { "VisLineLength", ConfigKey_Int, NULL, 1, noLimit },
+    { "CheckpointDirectory", ConfigKey_String, NULL, 0, 0 },
+    { "EnableDebug", ConfigKey_Bool, "false", 0, 0 },
+    { "DebugClasses", ConfigKey_String, NULL, 0, 0 },
+    { "DebugLog", ConfigKey_String, NULL, 0, 0 },
+    { "StrictConfig", ConfigKey_Bool, "false", 0, 0 },
+
+    /* Keys found in older configuration files that are no longer read. */
+    { "CTL_DUMP", ConfigKey_Ignored, NULL, 0, 0 },
+    { "DeviceConfig", ConfigKey_Ignored, NULL, 0, 0 },
+    { "EIDD2NT", ConfigKey_Ignored, NULL, 0, 0 },
+    { "Eclosed", ConfigKey_Ignored, NULL, 0, 0 },
+    { "Eleak", ConfigKey_Ignored, NULL, 0, 0 },
+    { "Eopen", ConfigKey_Ignored, NULL, 0, 0 },
+    { "SALP", ConfigKey_Ignored, NULL, 0, 0 },
+    { "UseFillCache", ConfigKey_Ignored, NULL, 0, 0 },
+    { "tFAW", ConfigKey_Ignored, NULL, 0, 0 }
+};
+
+static const size_t configKeyCount = sizeof(configKeys) / sizeof(configKeys[0]);
+
+/* Per-channel configuration files are given as CONFIG_CHANNEL0, 1, ... */
+static const ConfigKeyInfo channelConfigKey = 
+    { "CONFIG_CHANNEL", ConfigKey_String, NULL, 0, 0 };
+
+typedef std::unordered_map<std::string, int> ConfigKeyIndex;
+
+/* Position of each key in configKeys. The first declaration of a key wins. */
+static ConfigKeyIndex BuildKeyIndex( )
+{
+    ConfigKeyIndex keyIndex;
+
+    for( size_t keyIdx = 0; keyIdx < configKeyCount; keyIdx++ )
+    {
+        keyIndex.insert( std::pair<std::string, int>( configKeys[keyIdx].name, 
+                                                      static_cast<int>( keyIdx ) ) );
+    }
+
+    return keyIndex;
+}
+
+int ConfigSchema::Index( const std::string& key )
+{
+    /* Built on first use; static initialization is thread-safe. */
+    static const ConfigKeyIndex keyIndex = BuildKeyIndex( );
+
+    ConfigKeyIndex::const_iterator it = keyIndex.find( key );
+
+    return (it == keyIndex.end( )) ? -1 : it->second;
+}
+
+ConfigKey::ConfigKey( const std::string& keyName )
+    : name( keyName ), index( ConfigSchema::Index( keyName ) )
+{
+}
+
+size_t ConfigSchema::KeyCount( )
+{
+    return configKeyCount;
+}
+
+const ConfigKeyInfo *ConfigSchema::Find( const std::string& key )
+{
+    int keyIdx = Index( key );
+
+    if( keyIdx >= 0 )
+        return &configKeys[keyIdx];
+
+    std::string prefix( channelConfigKey.name );
+    if( key.size( ) > prefix.size( ) && key.compare( 0, prefix.size( ), prefix ) == 0
+        && key.find_first_not_of( "0123456789", prefix.size( ) ) == std::string::npos )
+    {
+        return &channelConfigKey;
+    }
+
+    return NULL;
+}
+
+std::string ConfigSchema::Validate( const ConfigKeyInfo *info, 
+                                    const std::string& value )
+{
+    std::stringstream error;
+
+    if( info == NULL || info->type == ConfigKey_String 
+        || info->type == ConfigKey_Ignored )
+    {
+        return "";
+    }
+
+    if( info->type == ConfigKey_Bool )
+    {
+        if( value != "true" && value != "false" )
+            error << "expected 'true' or 'false' but found '" << value << "'";
+
+        return error.str( );
+    }
+
+    const char *start = value.c_str( );
+    char *end = NULL;
+    double number = strtod( start, &end );
+    std::string suffix( end );
+
+    if( end == start )
+    {
+        error << "expected a number but found '" << value << "'";
+    }
+    else if( info->type == ConfigKey_Int 
+             && (suffix != "" || strchr( start, '.' ) != NULL) )
+    {
+        error << "expected an integer but found '" << value << "'";
+    }
+    else if( info->type == ConfigKey_Timing && suffix != "" 
+             && suffix != "ns" && suffix != "us" && suffix != "ms" )
+    {
+        error << "unknown time unit '" << suffix << "' in '" << value << "'";
+    }
+    else if( info->type == ConfigKey_Float && suffix != "" )
+    {
+        error << "expected a number but found '" << value << "'";
+    }
+    else if( number < info->minValue || number > info->maxValue )
+    {
+        error << "value " << value << " is out of range [" << info->minValue;
+        if( info->maxValue == noLimit )
+            error << ", inf)";
+        else
+            error << ", " << info->maxValue << "]";
+    }
+
+    return error.str( );
+}
+
+/* Levenshtein distance, used to suggest a key for a misspelled one. */
+static size_t EditDistance( const std::string& a, const std::string& b )
+{
+    std::vector<size_t> row( b.size( ) + 1 );
+
+    for( size_t j = 0; j <= b.size( ); j++ )
+        row[j] = j;
+
+    for( size_t i = 1; i <= a.size( ); i++ )
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+
+        for( size_t j = 1; j <= b.size( ); j++ )
+        {
+            size_t above = row[j];
+            size_t cost = (tolower( a[i-1] ) == tolower( b[j-1] )) ? 0 : 1;
+
+            row[j] = std::min( std::min( row[j] + 1, row[j-1] + 1 ), 
+                               diagonal + cost );
+            diagonal = above;
+        }
+    }
+
+    return row[b.size( )];
+}
+
+std::string ConfigSchema::Suggest( const std::string& key )
+{
+    std::string bestKey = "";
+    size_t bestDistance = 3;
+
+    for( size_t keyIdx = 0; keyIdx < configKeyCount; keyIdx++ )
+    {
+        if( configKeys[keyIdx].type == ConfigKey_Ignored )
+            continue;
+
+        size_t distance = EditDistance( key, configKeys[keyIdx].name );
+
+        if( distance < bestDistance )
+        {
+            bestDistance = distance;
+            bestKey = configKeys[keyIdx].name;
+        }
+    }
+
+    return bestKey;
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_CONFIGSCHEMA_H__
+#define __NVMAIN_CONFIGSCHEMA_H__
+
+#include <cstddef>
+#include <string>
+
+namespace NVM {
+
+enum ConfigKeyType
+{
+    ConfigKey_String,   ///< Free-form string, e.g., a module name
+    ConfigKey_Int,      ///< Integer count or size
+    ConfigKey_Float,    ///< Floating point value, e.g., energy or voltage
+    ConfigKey_Bool,     ///< "true" or "false"
+    ConfigKey_Timing,   ///< Cycles, or a value suffixed with ns, us, or ms
+    ConfigKey_Ignored   ///< Accepted for old configuration files, not used
+};
+
+/*
+ *  Declaration of a configuration key. The default documents the value the
+ *  simulator assumes when the key is not set, e.g., in the Params
+ *  constructor (NULL if the reader must handle the missing key). Config
+ *  getters do not apply it. Numeric values are range checked against
+ *  [minValue, maxValue] at load.
+ */
+struct ConfigKeyInfo
+{
+    const char *name;
+    ConfigKeyType type;
+    const char *defaultValue;
+    double minValue;
+    double maxValue;
+};
+
+/*
+ *  A key name resolved to its schema position once. Modules that read a key
+ *  for every instance (e.g., each subarray) keep one in a static local, and
+ *  Config getters taking a ConfigKey index the key's slot directly rather
+ *  than hashing the name on each call.
+ */
+class ConfigKey
+{
+  public:
+    explicit ConfigKey( const std::string& keyName );
+
+    const std::string name;
+    const int index;
+};
+
+class ConfigSchema
+{
+  public:
+    /* Returns the declaration for key, or NULL if the key is unknown. */
+    static const ConfigKeyInfo *Find( const std::string& key );
+
+    /* 
+     *  Returns the position of key in the schema, in [0, KeyCount( )), or -1
+     *  if the key is not declared (including CONFIG_CHANNELn keys).
+     */
+    static int Index( const std::string& key );
+    static size_t KeyCount( );
+
+    /* Returns an error message if value is not valid for key, else "". */
+    static std::string Validate( const ConfigKeyInfo *info, 
+                                 const std::string& value );
+
+    /* Returns the closest known key name, or "" if nothing is close. */
+    static std::string Suggest( const std::string& key );
+};
+
+};
+
+#endif
@@ -50,7 +50,11 @@ nullstream& operator<<( nullstream& s, T const& ) { return s; }
 
 //nullstream& operator<<( nullstream& s, std::ostream &(std::ostream&));
 
-static nullstream nvmainDebugInhibitor;
+/* 
+ *  Stream manipulators (e.g., std::hex) still set format flags on this, so
+ *  each thread gets its own copy for simulations running in parallel.
+ */
+static thread_local nullstream nvmainDebugInhibitor;
 
 };
 
@@ -46,6 +46,9 @@ class EnduranceDistribution
 
      virtual uint64_t GetEndurance( ) = 0;
 
+     /* Seeds the distribution's own random stream, if it has one. */
+     virtual void SetSeed( unsigned int /*seed*/ ) { }
+
 };
 
 };
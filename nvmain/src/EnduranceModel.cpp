@@ -34,6 +34,7 @@
 #include "src/EnduranceModel.h"
 #include "Endurance/EnduranceDistributionFactory.h"
 #include "src/FaultModel.h"
+#include "src/ConfigSchema.h"
 #include <iostream>
 #include <limits>
 
@@ -41,95 +42,106 @@ using namespace NVM;
 
 EnduranceModel::EnduranceModel( )
 {
-    life.clear( );
+    life.Clear( );
 
     granularity = 0;
+    projectLifetime = false;
 }
 
 void EnduranceModel::SetConfig( Config *config, bool /*createChildren*/ )
 {
+    /* Resolved once, since every subarray has a model. */
+    static const ConfigKey distKey( "EnduranceDist" );
+    static const ConfigKey seedKey( "EnduranceDistSeed" );
+    static const ConfigKey projectionKey( "EnduranceProjection" );
+
     enduranceDist = EnduranceDistributionFactory::CreateEnduranceDistribution( 
-            config->GetString( "EnduranceDist" ), config );
+            config->GetString( distKey ), config );
+
+    life.SetDistribution( enduranceDist );
+
+    /*
+     *  Every model draws from its own stream. Seeding it from the model's
+     *  name keeps results reproducible and different across sub-arrays.
+     */
+    if( enduranceDist != NULL )
+    {
+        unsigned int seed = 1;
+        std::string name = StatName( );
+
+        if( config->KeyExists( seedKey ) )
+            seed = static_cast<unsigned int>( config->GetValue( seedKey ) );
+
+        for( size_t i = 0; i < name.length( ); i++ )
+            seed = seed * 31 + static_cast<unsigned char>( name[i] );
+
+        enduranceDist->SetSeed( seed );
+    }
+
+    if( config->KeyExists( projectionKey ) )
+        projectLifetime = config->GetBool( projectionKey );
+
+    life.SetTrackEndurance( projectLifetime );
 }
 
 /*
- *  Finds the worst life in the life map. If you do not use the life
- *  map, you will need to overload this function to return the worst
+ *  Finds the worst life in the life store. If you do not use the life
+ *  store, you will need to overload this function to return the worst
  *  case life for statistics reporting.
  */
 uint64_t EnduranceModel::GetWorstLife( )
 {
-    std::map<uint64_t, uint64_t>::iterator i;
-    uint64_t min = std::numeric_limits< uint64_t >::max( );
-
-    for( i = life.begin( ); i != life.end( ); i++ )
-    {
-        if( i->second < min )
-            min = i->second;
-    }
-
-    return min;
+    return life.GetWorstLife( );
 }
 
 /*
- *  Finds the worst life in the life map. If you do not use the life
- *  map, you will need to overload this function to return the worst
- *  case life for statistics reporting.
+ *  Finds the average life in the life store. If you do not use the life
+ *  store, you will need to overload this function to return the average
+ *  life for statistics reporting.
  */
 uint64_t EnduranceModel::GetAverageLife( )
 {
-    std::map<uint64_t, uint64_t>::iterator i;
-    uint64_t total = 0;
-    uint64_t average = 0;
-
-    for( i = life.begin( ); i != life.end( ); i++ )
-        total += i->second;
+    return life.GetAverageLife( );
+}
 
-    if( life.size( ) != 0 )
-        average = total / life.size( );
-    else
-        average = 0;
+/*
+ *  Counts the partitions in the life store per power-of-two range of
+ *  remaining life. Models that do not use the life store report nothing.
+ */
+void EnduranceModel::GetLifeHistogram( std::map<uint64_t, uint64_t>& histogram )
+{
+    life.GetLifeHistogram( histogram );
+}
 
-    return average;
+bool EnduranceModel::ProjectsLifetime( )
+{
+    return projectLifetime && UsesLifeStore( );
 }
 
-bool EnduranceModel::DecrementLife( uint64_t addr )
+void EnduranceModel::StartProjectionWindow( )
 {
-    std::map<uint64_t, uint64_t>::iterator i = life.find( addr );
-    bool rv = true;
+    life.StartWindow( );
+}
 
-    if( i == life.end( ) )
-    {
-          /* Generate a random number using the specified distribution */
-          life.insert( std::pair<uint64_t, uint64_t>( addr, enduranceDist->GetEndurance( ) ) );
-    }
-    else
-    {
-        /* If the life is 0, leave it at that.  */
-        if( i->second != 0 )
-        {
-            i->second = i->second - 1;
-        }
-        else
-        {
-            rv = false;
-        }
-    }
+/*
+ *  Extrapolates the wear seen so far to the time each written partition
+ *  reaches its drawn endurance, assuming the write rate over the window
+ *  stays the same. Partitions not written in the window never fail.
+ */
+double EnduranceModel::ProjectLifetime( double window, 
+                                        std::map<double, uint64_t>& histogram )
+{
+    return life.ProjectFailures( window, histogram );
+}
 
-    return rv;
+bool EnduranceModel::DecrementLife( uint64_t addr )
+{
+    return life.Decrement( addr );
 }
 
 bool EnduranceModel::IsDead( uint64_t addr )
 {
-    std::map<uint64_t, uint64_t>::iterator i = life.find( addr );
-    bool rv = false;
-
-    if( i != life.end( ) && i->second == 0 )
-    {
-        rv = true;
-    }
-
-    return rv;
+    return life.IsDead( addr );
 }
 
 void EnduranceModel::SetGranularity( uint64_t bits )
@@ -41,6 +41,7 @@
 #include "src/Params.h"
 #include "src/NVMObject.h"
 #include "src/EnduranceDistribution.h"
+#include "src/LifeStore.h"
 #include "include/NVMDataBlock.h"
 #include "include/NVMAddress.h"
 #include "src/FaultModel.h"
@@ -64,6 +65,16 @@ class EnduranceModel : public NVMObject
 
     uint64_t GetWorstLife( );
     uint64_t GetAverageLife( );
+    void GetLifeHistogram( std::map<uint64_t, uint64_t>& histogram );
+
+    /* False for models that do not track life in the life store. */
+    virtual bool UsesLifeStore( ) { return true; }
+    /* True if EnduranceProjection is set and the model uses the life store. */
+    bool ProjectsLifetime( );
+    /* Starts the write-rate window used by ProjectLifetime, see LifeStore. */
+    void StartProjectionWindow( );
+    /* Returns the projected first failure in seconds, see LifeStore. */
+    double ProjectLifetime( double window, std::map<double, uint64_t>& histogram );
 
     virtual void PrintStats( ) { }
 
@@ -71,7 +82,7 @@ class EnduranceModel : public NVMObject
 
   protected:
     EnduranceDistribution *enduranceDist;
-    std::map<uint64_t, uint64_t> life;
+    LifeStore life;
     
     bool DecrementLife( uint64_t addr );
     bool IsDead( uint64_t addr );
@@ -81,6 +92,7 @@ class EnduranceModel : public NVMObject
 
   private:
     uint64_t granularity;
+    bool projectLifetime;
 
 };
 
@@ -67,6 +67,8 @@ EventQueue::EventQueue( )
     lastEventCycle = 0;
     nextEventCycle = std::numeric_limits<ncycle_t>::max();
     currentCycle = 0;
+    globalEventQueue = NULL;
+    globalIndex = 0;
 }
 
 EventQueue::~EventQueue( )
@@ -142,6 +144,9 @@ void EventQueue::InsertEvent( Event *event, ncycle_t when, int priority )
     if( when < nextEventCycle )
     {
         nextEventCycle = when;
+
+        if( globalEventQueue != NULL )
+            globalEventQueue->NotifyNextEvent( globalIndex );
     }
 
     /* If there are no events at this time, create a new mapping. */ 
@@ -360,15 +365,25 @@ void EventQueue::Process( )
     /* Process all the events at the next cycle, and figure out the next next cycle. */
     assert( eventMap.count( nextEventCycle ) );
 
-    EventList& eventList = eventMap[nextEventCycle];
-    EventList::iterator it;
+    ncycle_t processCycle = nextEventCycle;
+    std::map<ncycle_t, EventList>::iterator entry;
 
-    for( it = eventList.begin( ); it != eventList.end( ); it++ )
+    /*
+     *  Take events off the list before handling them. Handlers may look up,
+     *  insert, or remove events at this cycle, which must not see events
+     *  that were already handled and freed.
+     */
+    while( (entry = eventMap.find( processCycle )) != eventMap.end( )
+           && !entry->second.empty( ) )
     {
-        switch( (*it)->GetType( ) )
+        Event *event = entry->second.front( );
+
+        entry->second.pop_front( );
+
+        switch( event->GetType( ) )
         {
             case EventCycle:
-                (*it)->GetRecipient( )->Cycle( nextEventCycle - lastEventCycle );
+                event->GetRecipient( )->Cycle( processCycle - lastEventCycle );
                 break;
 
             case EventIdle:
@@ -380,14 +395,14 @@ void EventQueue::Process( )
                 break;
 
             case EventResponse:
-                (*it)->GetRecipient( )->RequestComplete( (*it)->GetRequest( ) );
+                event->GetRecipient( )->RequestComplete( event->GetRequest( ) );
                 break;
 
             case EventCallback:
             {
-                CallbackPtr cb = (*it)->GetCallback( );
-                NVMObject *thisPtr = (*it)->GetRecipient( )->GetTrampoline( );
-                (*thisPtr.*cb)( (*it)->GetData() );
+                CallbackPtr cb = event->GetCallback( );
+                NVMObject *thisPtr = event->GetRecipient( )->GetTrampoline( );
+                (*thisPtr.*cb)( event->GetData() );
                 break;
             }
 
@@ -398,20 +413,20 @@ void EventQueue::Process( )
         }
 
         /* Free event data */
-        delete (*it);
+        delete event;
     }
 
-    eventMap.erase( nextEventCycle );
+    eventMap.erase( processCycle );
 
     /* Figure out the next cycle. */
     if( eventMap.empty( ) )
     {
-        lastEventCycle = nextEventCycle;
+        lastEventCycle = processCycle;
         nextEventCycle = std::numeric_limits<ncycle_t>::max();
     }
     else
     {
-        lastEventCycle = nextEventCycle;
+        lastEventCycle = processCycle;
         /* map is sorted by keys, so this works out. */
         nextEventCycle = eventMap.begin()->first; 
     }
@@ -437,6 +452,12 @@ ncycle_t EventQueue::GetCurrentCycle( )
     return currentCycle;
 }
 
+void EventQueue::SetGlobalEventQueue( GlobalEventQueue *queue, size_t index )
+{
+    globalEventQueue = queue;
+    globalIndex = index;
+}
+
 void EventQueue::SetCurrentCycle( ncycle_t curCycle )
 {
     currentCycle = curCycle;
@@ -453,6 +474,18 @@ GlobalEventQueue::~GlobalEventQueue( )
 
 }
 
+static uint64_t GreatestCommonDivisor( uint64_t a, uint64_t b )
+{
+    while( b != 0 )
+    {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
 void GlobalEventQueue::AddSystem( NVMain *subSystem, Config *config )
 {
     double subSystemFrequency = config->GetEnergy( "CLK" ) * 1000000.0;
@@ -465,14 +498,40 @@ void GlobalEventQueue::AddSystem( NVMain *subSystem, Config *config )
      *  We aren't doing and checks here to make sure the input side (i.e. CPUFreq) is
      *  corrent since we don't know what it should be.
      */
-    eventQueues.insert( std::pair<EventQueue*, double>(queue, subSystemFrequency) );
+    uint64_t globalHz = static_cast<uint64_t>( frequency + 0.5 );
+    uint64_t subSystemHz = static_cast<uint64_t>( subSystemFrequency + 0.5 );
+    uint64_t gcd = GreatestCommonDivisor( globalHz, subSystemHz );
+
+    SubQueue sub;
+
+    assert( gcd != 0 );
+
+    sub.queue = queue;
+    sub.ratioNum = globalHz / gcd;
+    sub.ratioDen = subSystemHz / gcd;
+    sub.heapCycle = std::numeric_limits<ncycle_t>::max( );
+
+    /* Keep the address order the sub-queues have always been stepped in. */
+    std::vector<SubQueue>::iterator pos = eventQueues.begin( );
+    while( pos != eventQueues.end( ) && pos->queue < queue )
+        pos++;
+    eventQueues.insert( pos, sub );
+
+    /* Indices shifted, so rebuild the heap. */
+    nextEvents = std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> >( );
+    for( size_t i = 0; i < eventQueues.size( ); i++ )
+    {
+        eventQueues[i].queue->SetGlobalEventQueue( this, i );
+        eventQueues[i].heapCycle = std::numeric_limits<ncycle_t>::max( );
+        NotifyNextEvent( i );
+    }
+
     queue->SetFrequency( subSystemFrequency );
 
     std::cout << "NVMain: GlobalEventQueue: Added a memory subsystem running at "
               << config->GetEnergy( "CLK" ) << "MHz. My frequency is "
               << (frequency / 1000000.0) << "MHz." << std::endl;
 }
-
 void GlobalEventQueue::Cycle( ncycle_t steps )
 {
     EventQueue *nextEventQueue;
@@ -517,35 +576,83 @@ double GlobalEventQueue::GetFrequency( )
     return frequency;
 }
 
-ncycle_t GlobalEventQueue::GetNextEvent( EventQueue **eq )
+ncycle_t GlobalEventQueue::ToGlobalCycle( const SubQueue& sub, ncycle_t cycle )
 {
-    std::map<EventQueue *, double>::const_iterator iter;
-    ncycle_t nextEventCycle = std::numeric_limits<ncycle_t>::max( );
+    unsigned __int128 scaled = static_cast<unsigned __int128>( cycle ) * sub.ratioNum;
+
+    return static_cast<ncycle_t>( scaled / sub.ratioDen );
+}
 
+ncycle_t GlobalEventQueue::ToLocalCycle( const SubQueue& sub, ncycle_t cycle )
+{
+    unsigned __int128 scaled = static_cast<unsigned __int128>( cycle ) * sub.ratioDen;
+
+    return static_cast<ncycle_t>( scaled / sub.ratioNum );
+}
+
+ncycle_t GlobalEventQueue::NextGlobalEvent( const SubQueue& sub )
+{
+    ncycle_t nextEvent = sub.queue->GetNextEvent( );
+
+    /* 
+     *  If there is no event, we must skip frequency alignment to prevent
+     *  overflow causing an invalid nextEventCycle.
+     */
+    if( nextEvent == std::numeric_limits<ncycle_t>::max( ) )
+        return nextEvent;
+
+    return ToGlobalCycle( sub, nextEvent );
+}
+
+/* A sub-queue's next event moved earlier; push it on the heap. */
+void GlobalEventQueue::NotifyNextEvent( size_t index )
+{
+    SubQueue& sub = eventQueues[index];
+    ncycle_t nextEvent = NextGlobalEvent( sub );
+
+    if( nextEvent < sub.heapCycle )
+    {
+        sub.heapCycle = nextEvent;
+        nextEvents.push( HeapEntry( nextEvent, index ) );
+    }
+}
+
+/*
+ *  Heap entries go stale when a sub-queue processes or removes its next
+ *  event. Those are only noticed here, when they reach the top, and are
+ *  replaced by the sub-queue's current next event.
+ */
+ncycle_t GlobalEventQueue::GetNextEvent( EventQueue **eq )
+{
     if( eq != NULL )
         *eq = NULL;
 
-    for( iter = eventQueues.begin( ); iter != eventQueues.end( ); iter++ )
+    while( !nextEvents.empty( ) )
     {
-        /* 
-         *  If there is no event, we must skip frequency alignment to prevent
-         *  underflow causing an invalid nextEventCycle.
-         */
-        if( iter->first->GetNextEvent( ) == std::numeric_limits<ncycle_t>::max( ) )
-            continue;
+        HeapEntry top = nextEvents.top( );
+        SubQueue& sub = eventQueues[top.second];
+        ncycle_t nextEvent = NextGlobalEvent( sub );
 
-        double frequencyMultiplier = frequency / iter->second;
-        double globalEventCycle = iter->first->GetNextEvent( ) * frequencyMultiplier;
-
-        if( static_cast<ncycle_t>(globalEventCycle) < nextEventCycle )
+        if( top.first == sub.heapCycle && top.first == nextEvent )
         {
-            nextEventCycle = static_cast<ncycle_t>(globalEventCycle);
             if( eq != NULL )
-                *eq = iter->first;
+                *eq = sub.queue;
+
+            return nextEvent;
         }
+
+        nextEvents.pop( );
+
+        /* Superseded by an earlier push for the same sub-queue. */
+        if( top.first != sub.heapCycle )
+            continue;
+
+        sub.heapCycle = nextEvent;
+        if( nextEvent != std::numeric_limits<ncycle_t>::max( ) )
+            nextEvents.push( HeapEntry( nextEvent, top.second ) );
     }
 
-    return nextEventCycle;
+    return std::numeric_limits<ncycle_t>::max( );
 }
 
 ncycle_t GlobalEventQueue::GetCurrentCycle( )
@@ -555,18 +662,14 @@ ncycle_t GlobalEventQueue::GetCurrentCycle( )
 
 void GlobalEventQueue::Sync( )
 {
-    std::map<EventQueue *, double>::const_iterator iter;
+    std::vector<SubQueue>::iterator iter;
     for( iter = eventQueues.begin( ); iter != eventQueues.end( ); iter++ )
     {
-        double frequencyMultiplier = frequency / iter->second;
-        double setCycle = static_cast<double>(currentCycle) / frequencyMultiplier;
-        ncycle_t stepCount = static_cast<ncycle_t>(setCycle) - iter->first->GetCurrentCycle( );
+        ncycle_t setCycle = ToLocalCycle( *iter, currentCycle );
 
-        if( static_cast<ncycle_t>(setCycle) > iter->first->GetCurrentCycle( ) )
+        if( setCycle > iter->queue->GetCurrentCycle( ) )
         {
-            iter->first->Loop( stepCount );
+            iter->queue->Loop( setCycle - iter->queue->GetCurrentCycle( ) );
         }
     }
 }
-
-
@@ -36,6 +36,8 @@
 
 #include <map>
 #include <list>
+#include <queue>
+#include <vector>
 #include "include/NVMTypes.h"
 #include "include/NVMainRequest.h"
 
@@ -45,6 +47,7 @@ class Event;
 class NVMObject_hook;
 class Config;
 class NVMain;
+class GlobalEventQueue;
 
 typedef std::list<Event *> EventList;
 typedef void (NVMObject::*CallbackPtr)(void*);
@@ -123,12 +126,18 @@ class EventQueue
     ncycle_t GetCurrentCycle( );
     void SetCurrentCycle( ncycle_t curCycle );
 
+    void SetGlobalEventQueue( GlobalEventQueue *queue, size_t index );
+
   private:
     ncycle_t nextEventCycle;
     ncycle_t lastEventCycle;
     ncycle_t currentCycle; 
     double frequency;
 
+    /* Told when our next event moves earlier. */
+    GlobalEventQueue *globalEventQueue;
+    size_t globalIndex;
+
     std::map< ncycle_t, EventList> eventMap; 
 };
 
@@ -148,12 +157,34 @@ class GlobalEventQueue
     ncycle_t GetNextEvent( EventQueue **eq = NULL );
     ncycle_t GetCurrentCycle( );
 
+    void NotifyNextEvent( size_t index );
+
   private:
+    /*
+     *  A sub-queue's cycles convert to global cycles by the exact ratio
+     *  ratioNum / ratioDen, i.e., global frequency over sub-queue frequency
+     *  reduced by their GCD, so no rounding drift accumulates.
+     */
+    struct SubQueue
+    {
+        EventQueue *queue;
+        uint64_t ratioNum;
+        uint64_t ratioDen;
+        ncycle_t heapCycle;   /* Latest global next event pushed on the heap. */
+    };
+
+    typedef std::pair<ncycle_t, size_t> HeapEntry;
+
     ncycle_t currentCycle;
     double frequency;
 
-    std::map<EventQueue *, double> eventQueues;
+    /* Sub-queues in address order, and a min-heap of their next events. */
+    std::vector<SubQueue> eventQueues;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > nextEvents;
 
+    ncycle_t ToGlobalCycle( const SubQueue& sub, ncycle_t cycle );
+    ncycle_t ToLocalCycle( const SubQueue& sub, ncycle_t cycle );
+    ncycle_t NextGlobalEvent( const SubQueue& sub );
     void Sync( );
 
 };
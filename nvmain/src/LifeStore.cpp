@@ -0,0 +1,389 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "src/LifeStore.h"
+#include "src/EnduranceDistribution.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace NVM;
+
+LifeStore::LifeStore( )
+{
+    enduranceDist = NULL;
+    pageSize = 1024;
+    partitionCount = 0;
+    trackEndurance = false;
+    lastPageId = 0;
+    lastPage = NULL;
+    warnedClamp = false;
+
+    Clear( );
+}
+
+LifeStore::~LifeStore( )
+{
+    Clear( );
+}
+
+void LifeStore::SetDistribution( EnduranceDistribution *dist )
+{
+    enduranceDist = dist;
+}
+
+void LifeStore::SetPageSize( uint64_t counters )
+{
+    assert( pages.empty( ) && counters > 0 );
+
+    pageSize = counters;
+}
+
+void LifeStore::SetTrackEndurance( bool track )
+{
+    assert( pages.empty( ) );
+
+    trackEndurance = track;
+}
+
+void LifeStore::SetPartitionCount( uint64_t count )
+{
+    partitionCount = count;
+}
+
+void LifeStore::Clear( )
+{
+    std::map<uint64_t, uint32_t *>::iterator it;
+
+    for( it = pages.begin( ); it != pages.end( ); it++ )
+        delete [] it->second;
+
+    pages.clear( );
+    lastPage = NULL;
+    writtenCount = 0;
+    worstLife = std::numeric_limits< uint64_t >::max( );
+    lifeSum = 0;
+
+    for( int bucket = 0; bucket < lifeBuckets; bucket++ )
+        lifeHisto[bucket] = 0;
+}
+
+/* Bucket 0 holds dead partitions, bucket b holds lives in [2^(b-1), 2^b). */
+int LifeStore::LifeBucket( uint32_t lifeValue )
+{
+    return (lifeValue == 0) ? 0 : (32 - __builtin_clz( lifeValue ));
+}
+
+uint32_t *LifeStore::FindPage( uint64_t pageId, bool allocate )
+{
+    if( lastPage != NULL && lastPageId == pageId )
+        return lastPage;
+
+    std::map<uint64_t, uint32_t *>::iterator it = pages.find( pageId );
+    uint32_t *page = NULL;
+
+    if( it != pages.end( ) )
+    {
+        page = it->second;
+    }
+    else if( allocate )
+    {
+        /* 
+         *  Drawn endurance and life at the window start, if tracked, follow
+         *  the life counters.
+         */
+        uint64_t pageLength = trackEndurance ? 3 * pageSize : pageSize;
+
+        page = new uint32_t[pageLength];
+
+        for( uint64_t idx = 0; idx < pageLength; idx++ )
+            page[idx] = unwritten;
+
+        pages.insert( std::pair<uint64_t, uint32_t *>( pageId, page ) );
+    }
+
+    if( page != NULL )
+    {
+        lastPageId = pageId;
+        lastPage = page;
+    }
+
+    return page;
+}
+
+bool LifeStore::DecrementCounter( uint32_t *page, uint64_t idx )
+{
+    uint32_t& counter = page[idx];
+    bool rv = true;
+
+    if( counter == unwritten )
+    {
+        /* Generate a random number using the specified distribution */
+        uint64_t endurance = enduranceDist->GetEndurance( );
+
+        if( endurance > maxLife )
+        {
+            if( !warnedClamp )
+            {
+                std::cout << "LifeStore: Endurance " << endurance << " does not "
+                          << "fit the 32-bit life counters. Using " << maxLife 
+                          << "." << std::endl;
+                warnedClamp = true;
+            }
+
+            endurance = maxLife;
+        }
+
+        counter = static_cast<uint32_t>( endurance );
+        writtenCount++;
+
+        if( trackEndurance )
+            page[pageSize + idx] = counter;
+        lifeSum += counter;
+        lifeHisto[LifeBucket( counter )]++;
+
+        if( counter < worstLife )
+            worstLife = counter;
+    }
+    /* If the life is 0, leave it at that.  */
+    else if( counter != 0 )
+    {
+        /* Only powers of two move down a histogram bucket. */
+        if( (counter & (counter - 1)) == 0 )
+        {
+            lifeHisto[LifeBucket( counter )]--;
+            lifeHisto[LifeBucket( counter - 1 )]++;
+        }
+
+        counter--;
+        lifeSum--;
+
+        /* Lives only decrease, so the worst life is a running minimum. */
+        if( counter < worstLife )
+            worstLife = counter;
+    }
+    else
+    {
+        rv = false;
+    }
+
+    return rv;
+}
+
+bool LifeStore::Decrement( uint64_t key )
+{
+    uint32_t *page = FindPage( key / pageSize, true );
+
+    return DecrementCounter( page, key % pageSize );
+}
+
+bool LifeStore::DecrementMask( uint64_t baseKey, const uint64_t *mask, 
+                               uint64_t maskBits )
+{
+    bool rv = true;
+
+    for( uint64_t wordIdx = 0; wordIdx * 64 < maskBits; wordIdx++ )
+    {
+        uint64_t bits = mask[wordIdx];
+
+        /* Visit only the set bits, lowest first. */
+        while( bits != 0 )
+        {
+            uint64_t bit = static_cast<uint64_t>( __builtin_ctzll( bits ) );
+            uint64_t key = baseKey + wordIdx * 64 + bit;
+
+            bits &= bits - 1;
+
+            if( wordIdx * 64 + bit >= maskBits )
+                break;
+
+            uint32_t *page = FindPage( key / pageSize, true );
+
+            if( !DecrementCounter( page, key % pageSize ) )
+                rv = false;
+        }
+    }
+
+    return rv;
+}
+
+bool LifeStore::IsDead( uint64_t key )
+{
+    uint32_t *page = FindPage( key / pageSize, false );
+
+    return (page != NULL && page[key % pageSize] == 0);
+}
+
+bool LifeStore::AnyDead( uint64_t baseKey, uint64_t count )
+{
+    uint64_t key = baseKey;
+    uint64_t endKey = baseKey + count;
+
+    while( key < endKey )
+    {
+        uint64_t pageEnd = (key / pageSize + 1) * pageSize;
+        uint32_t *page = FindPage( key / pageSize, false );
+
+        if( pageEnd > endKey )
+            pageEnd = endKey;
+
+        if( page != NULL )
+        {
+            for( uint64_t idx = key; idx < pageEnd; idx++ )
+            {
+                if( page[idx % pageSize] == 0 )
+                    return true;
+            }
+        }
+
+        key = pageEnd;
+    }
+
+    return false;
+}
+
+uint64_t LifeStore::GetWorstLife( )
+{
+    return worstLife;
+}
+
+uint64_t LifeStore::GetAverageLife( )
+{
+    if( writtenCount == 0 )
+        return 0;
+
+    return lifeSum / writtenCount;
+}
+
+uint64_t LifeStore::GetSize( )
+{
+    return writtenCount;
+}
+
+void LifeStore::GetLifeHistogram( std::map<uint64_t, uint64_t>& histogram )
+{
+    histogram.clear( );
+
+    for( int bucket = 0; bucket < lifeBuckets; bucket++ )
+    {
+        if( lifeHisto[bucket] == 0 )
+            continue;
+
+        uint64_t lowerBound = (bucket == 0) ? 0 : (1ULL << (bucket - 1));
+
+        histogram[lowerBound] = lifeHisto[bucket];
+    }
+}
+
+void LifeStore::StartWindow( )
+{
+    std::map<uint64_t, uint32_t *>::iterator it;
+
+    if( !trackEndurance )
+        return;
+
+    for( it = pages.begin( ); it != pages.end( ); it++ )
+    {
+        uint32_t *page = it->second;
+
+        for( uint64_t idx = 0; idx < pageSize; idx++ )
+            page[2 * pageSize + idx] = page[idx];
+    }
+}
+
+double LifeStore::ProjectFailures( double window, 
+                                   std::map<double, uint64_t>& histogram )
+{
+    std::map<uint64_t, uint32_t *>::iterator it;
+    double firstFailure = -1.0;
+    uint64_t counted = 0;
+
+    assert( trackEndurance );
+
+    histogram.clear( );
+
+    for( it = pages.begin( ); it != pages.end( ); it++ )
+    {
+        uint32_t *page = it->second;
+
+        for( uint64_t idx = 0; idx < pageSize; idx++ )
+        {
+            if( page[idx] == unwritten )
+                continue;
+
+            counted++;
+
+            /* Already worn out, so there is no failure left to project. */
+            if( page[idx] == 0 )
+            {
+                histogram[0.0]++;
+                continue;
+            }
+
+            double endurance = static_cast<double>( page[pageSize + idx] );
+            double windowStart = static_cast<double>( page[2 * pageSize + idx] );
+            double writes;
+
+            /* The first write sets the counter without decrementing it. */
+            if( page[2 * pageSize + idx] == unwritten )
+                writes = endurance - static_cast<double>( page[idx] ) + 1.0;
+            else
+                writes = windowStart - static_cast<double>( page[idx] );
+
+            if( writes == 0.0 )
+            {
+                histogram[-1.0]++;
+                continue;
+            }
+
+            double failure = endurance * window / writes;
+
+            if( firstFailure < 0.0 || failure < firstFailure )
+                firstFailure = failure;
+
+            double decade = (failure > 0.0) 
+                          ? std::pow( 10.0, std::floor( std::log10( failure ) ) )
+                          : 0.0;
+
+            histogram[decade]++;
+        }
+    }
+
+    /* Partitions never written have no endurance drawn and never fail. */
+    if( partitionCount > counted )
+        histogram[-1.0] += partitionCount - counted;
+
+    return firstFailure;
+}
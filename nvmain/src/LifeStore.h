@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __NVMAIN_LIFESTORE_H__
+#define __NVMAIN_LIFESTORE_H__
+
+#include <map>
+#include <stdint.h>
+
+namespace NVM {
+
+class EnduranceDistribution;
+
+/*
+ *  Remaining life of each endurance partition (bit, byte, word, row, ...),
+ *  indexed by a key chosen by the endurance model. Keys are grouped into
+ *  pages of consecutive 32-bit counters that are allocated on first use, so
+ *  neighboring partitions written together share one page lookup. Models
+ *  should size pages to the partitions one write touches (e.g., a word).
+ *
+ *  A partition's endurance is drawn from the distribution the first time it
+ *  is written, which is also when it starts counting toward the statistics.
+ */
+class LifeStore
+{
+  public:
+    LifeStore( );
+    ~LifeStore( );
+
+    void SetDistribution( EnduranceDistribution *dist );
+    /* Number of counters per page. Must be set before the first write. */
+    void SetPageSize( uint64_t counters );
+    /* 
+     *  Keep each partition's drawn endurance and its life at the start of
+     *  the projection window next to its remaining life, so writes per
+     *  partition can be recovered. Must be set before the first write.
+     *  Triples the memory used per page.
+     */
+    void SetTrackEndurance( bool track );
+    /* 
+     *  Number of partitions in the device part this store covers, written or
+     *  not. Used only by ProjectFailures.
+     */
+    void SetPartitionCount( uint64_t count );
+
+    /* Returns false if the partition was already worn out. */
+    bool Decrement( uint64_t key );
+    /* 
+     *  Decrements partition baseKey + i for each bit i set in mask, where
+     *  mask holds maskBits bits in 64-bit words. Returns false if any of
+     *  them was already worn out.
+     */
+    bool DecrementMask( uint64_t baseKey, const uint64_t *mask, uint64_t maskBits );
+
+    bool IsDead( uint64_t key );
+    /* Returns true if any partition in [baseKey, baseKey + count) is worn out. */
+    bool AnyDead( uint64_t baseKey, uint64_t count );
+
+    /* Life statistics are kept up to date on each write, so these are O(1). */
+    uint64_t GetWorstLife( );
+    uint64_t GetAverageLife( );
+    /* Number of partitions written at least once. */
+    uint64_t GetSize( );
+    /* 
+     *  Number of written partitions per power-of-two range of remaining
+     *  life, keyed by the lower bound of the range (0, 1, 2, 4, 8, ...).
+     */
+    void GetLifeHistogram( std::map<uint64_t, uint64_t>& histogram );
+    /* Starts a new projection window at the current lives of all partitions. */
+    void StartWindow( );
+    /*
+     *  Projects when each partition written in the window wears out if it
+     *  keeps the write rate it had over the window, which lasted window
+     *  seconds. Returns the earliest failure in seconds, or -1 if no
+     *  partition was written in the window. The histogram counts every
+     *  partition set by SetPartitionCount: projections per decade of
+     *  seconds, worn out partitions under 0, and the partitions that never
+     *  fail at their rate (not written in the window, or never written)
+     *  under -1. Worn out partitions are not projected. Requires
+     *  SetTrackEndurance and scans every page.
+     */
+    double ProjectFailures( double window, std::map<double, uint64_t>& histogram );
+
+    void Clear( );
+
+  private:
+    /* Counter value of a partition that has not been written. */
+    static const uint32_t unwritten = 0xFFFFFFFF;
+    static const uint32_t maxLife = 0xFFFFFFFE;
+    /* Life 0 plus one bucket per bit of a 32-bit life. */
+    static const int lifeBuckets = 33;
+
+    EnduranceDistribution *enduranceDist;
+    uint64_t pageSize;
+    uint64_t partitionCount;
+    bool trackEndurance;
+    std::map<uint64_t, uint32_t *> pages;
+    uint64_t lastPageId;
+    uint32_t *lastPage;
+    uint64_t writtenCount;
+    uint64_t worstLife;
+    uint64_t lifeSum;
+    uint64_t lifeHisto[lifeBuckets];
+    bool warnedClamp;
+
+    uint32_t *FindPage( uint64_t pageId, bool allocate );
+    bool DecrementCounter( uint32_t *page, uint64_t idx );
+    int LifeBucket( uint32_t lifeValue );
+};
+
+};
+
+#endif
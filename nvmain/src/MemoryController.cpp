@@ -193,10 +193,13 @@ void MemoryController::Enqueue( ncounter_t queueNum, NVMainRequest *request )
     /* Retranslate once for this channel, but leave channel the same */
     ncounter_t channel, rank, bank, row, col, subarray;
 
-     GetDecoder( )->Translate( request->address.GetPhysicalAddress( ),
-                               &row, &col, &bank, &rank, &channel, &subarray );
-    channel = request->address.GetChannel( );
-    request->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    if( (request->flags & NVMainRequest::FLAG_TRANSLATED) == 0 )
+    {
+        GetDecoder( )->Translate( request->address.GetPhysicalAddress( ),
+                                  &row, &col, &bank, &rank, &channel, &subarray );
+        channel = request->address.GetChannel( );
+        request->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+    }
 
     /* Enqueue the request. */
     assert( queueNum < transactionQueueCount );
@@ -340,6 +343,22 @@ bool MemoryController::IsIssuable( NVMainRequest * /*request*/, FailReason * /*f
     return true;
 }
 
+bool MemoryController::IssueAtomic( NVMainRequest *request )
+{
+    /* 
+     *  Retranslate with this channel's decoder as Enqueue does, so remapping
+     *  decoders (e.g., StartGap) see atomic and warm-up accesses too.
+     */
+    ncounter_t channel, rank, bank, row, col, subarray;
+
+    GetDecoder( )->Translate( request->address.GetPhysicalAddress( ),
+                              &row, &col, &bank, &rank, &channel, &subarray );
+    channel = request->address.GetChannel( );
+    request->address.SetTranslatedAddress( row, col, bank, rank, channel, subarray );
+
+    return NVMObject::IssueAtomic( request );
+}
+
 void MemoryController::SetMappingScheme( )
 {
     /* Configure common memory controller parameters. */
@@ -578,7 +597,7 @@ void MemoryController::SetConfig( Config *conf, bool createChildren )
             {
                 delayedRefreshCounter[i][j] = 0;
 
-                ncounter_t refreshBankHead = j * p->BanksPerRefresh;
+                ncounter_t refreshBankHead = GetRefreshBank( j, 0 );
 
                 /* create first refresh pulse to start the refresh countdown */ 
                 NVMainRequest* refreshPulse = MakeRefreshRequest( 
@@ -630,7 +649,7 @@ bool MemoryController::NeedRefresh( const ncounter_t bank, const uint64_t rank )
     bool rv = false;
 
     if( p->UseRefresh )
-        if( delayedRefreshCounter[rank][bank/p->BanksPerRefresh] 
+        if( delayedRefreshCounter[rank][GetRefreshGroup( bank )] 
                 >= p->DelayedRefreshThreshold )
             rv = true;
         
@@ -642,11 +661,10 @@ bool MemoryController::NeedRefresh( const ncounter_t bank, const uint64_t rank )
  */
 void MemoryController::SetRefresh( const ncounter_t bank, const uint64_t rank )
 {
-    /* align to the head of bank group */
-    ncounter_t bankHead = ( bank / p->BanksPerRefresh ) * p->BanksPerRefresh;
+    ncounter_t refreshGroup = GetRefreshGroup( bank );
 
     for( ncounter_t i = 0; i < p->BanksPerRefresh; i++ )
-        bankNeedRefresh[rank][bankHead + i] = true;
+        bankNeedRefresh[rank][GetRefreshBank( refreshGroup, i )] = true;
 }
 
 /* 
@@ -654,11 +672,10 @@ void MemoryController::SetRefresh( const ncounter_t bank, const uint64_t rank )
  */
 void MemoryController::ResetRefresh( const ncounter_t bank, const uint64_t rank )
 {
-    /* align to the head of bank group */
-    ncounter_t bankHead = ( bank / p->BanksPerRefresh ) * p->BanksPerRefresh;
+    ncounter_t refreshGroup = GetRefreshGroup( bank );
 
     for( ncounter_t i = 0; i < p->BanksPerRefresh; i++ )
-        bankNeedRefresh[rank][bankHead + i] = false;
+        bankNeedRefresh[rank][GetRefreshBank( refreshGroup, i )] = false;
 }
 
 /*
@@ -666,13 +683,12 @@ void MemoryController::ResetRefresh( const ncounter_t bank, const uint64_t rank
  */
 void MemoryController::ResetRefreshQueued( const ncounter_t bank, const ncounter_t rank )
 {
-    /* align to the head of bank group */
-    ncounter_t bankHead = ( bank / p->BanksPerRefresh ) * p->BanksPerRefresh;
+    ncounter_t refreshGroup = GetRefreshGroup( bank );
 
     for( ncounter_t i = 0; i < p->BanksPerRefresh; i++ )
     {
-        assert( refreshQueued[rank][bankHead + i] );
-        refreshQueued[rank][bankHead + i] = false;
+        assert( refreshQueued[rank][GetRefreshBank( refreshGroup, i )] );
+        refreshQueued[rank][GetRefreshBank( refreshGroup, i )] = false;
     }
 }
 
@@ -682,7 +698,7 @@ void MemoryController::ResetRefreshQueued( const ncounter_t bank, const ncounter
 void MemoryController::IncrementRefreshCounter( const ncounter_t bank, const uint64_t rank )
 {
     /* get the bank group ID */
-    ncounter_t bankGroupID = bank / p->BanksPerRefresh;
+    ncounter_t bankGroupID = GetRefreshGroup( bank );
 
     delayedRefreshCounter[rank][bankGroupID]++;
 }
@@ -693,7 +709,7 @@ void MemoryController::IncrementRefreshCounter( const ncounter_t bank, const uin
 void MemoryController::DecrementRefreshCounter( const ncounter_t bank, const uint64_t rank )
 {
     /* get the bank group ID */
-    ncounter_t bankGroupID = bank / p->BanksPerRefresh;
+    ncounter_t bankGroupID = GetRefreshGroup( bank );
 
     delayedRefreshCounter[rank][bankGroupID]--;
 }
@@ -710,7 +726,7 @@ bool MemoryController::HandleRefresh( )
 
         for( ncounter_t bankIdx = 0; bankIdx < m_refreshBankNum; bankIdx++ )
         {
-            ncounter_t j = (nextRefreshBank + bankIdx * p->BanksPerRefresh) % p->BANKS;
+            ncounter_t j = GetRefreshBank( (nextRefreshBank + bankIdx) % m_refreshBankNum, 0 );
             FailReason fail;
 
             if( NeedRefresh( j, i ) /*&& IsRefreshBankQueueEmpty( j , i )*/ )
@@ -723,8 +739,7 @@ bool MemoryController::HandleRefresh( )
                 {
                     for( ncounter_t tmpBank = 0; tmpBank < p->BanksPerRefresh; tmpBank++ ) 
                     {
-                        /* Use modulo to allow for an odd number of banks per refresh. */
-                        ncounter_t refBank = (tmpBank + j) % p->BANKS;
+                        ncounter_t refBank = GetRefreshBank( GetRefreshGroup( j ), tmpBank );
                         ncounter_t queueId = GetCommandQueueId( NVMAddress( 0, 0, refBank, i /*rank*/, 0, 0 ) );
 
                         /* Precharge all active banks and active subarrays */
@@ -758,7 +773,7 @@ bool MemoryController::HandleRefresh( )
 
                 for( ncounter_t tmpBank = 0; tmpBank < p->BanksPerRefresh; tmpBank++ )
                 {
-                    ncounter_t refBank = (tmpBank + j) % p->BANKS;
+                    ncounter_t refBank = GetRefreshBank( GetRefreshGroup( j ), tmpBank );
 
                     /* Disallow queuing commands to non-bank-head queues. */
                     refreshQueued[i][refBank] = true;
@@ -772,8 +787,8 @@ bool MemoryController::HandleRefresh( )
                     ResetRefresh( j, i );
 
                 /* round-robin */
-                nextRefreshBank += p->BanksPerRefresh;
-                if( nextRefreshBank >= p->BANKS )
+                nextRefreshBank++;
+                if( nextRefreshBank >= m_refreshBankNum )
                 {
                     nextRefreshBank = 0;
                     nextRefreshRank++;
@@ -794,6 +809,29 @@ bool MemoryController::HandleRefresh( )
     return false;
 }
 
+/*
+ *  Banks are refreshed in groups of BanksPerRefresh consecutive banks. With
+ *  SameBankRefresh (DDR5 REFsb), a group is the same bank in every bank group
+ *  (banks b, b + BANKS/BankGroups, ...), so the other banks stay available.
+ */
+ncounter_t MemoryController::GetRefreshGroup( const ncounter_t bank )
+{
+    if( p->SameBankRefresh )
+        return bank % ( p->BANKS / p->BankGroups );
+
+    return bank / p->BanksPerRefresh;
+}
+
+ncounter_t MemoryController::GetRefreshBank( const ncounter_t group, 
+                                             const ncounter_t index )
+{
+    if( p->SameBankRefresh )
+        return group + index * ( p->BANKS / p->BankGroups );
+
+    /* Use modulo to allow for an odd number of banks per refresh. */
+    return ( group * p->BanksPerRefresh + index ) % p->BANKS;
+}
+
 /* 
  * it simply increments the corresponding delayed refresh counter 
  * and re-insert the refresh pulse into event queue
@@ -823,12 +861,11 @@ void MemoryController::ProcessRefreshPulse( NVMainRequest* refresh )
  */
 bool MemoryController::IsRefreshBankQueueEmpty( const ncounter_t bank, const uint64_t rank )
 {
-    /* align to the head of bank group */
-    ncounter_t bankHead = ( bank / p->BanksPerRefresh ) * p->BanksPerRefresh;
+    ncounter_t refreshGroup = GetRefreshGroup( bank );
 
     for( ncounter_t i = 0; i < p->BanksPerRefresh; i++ )
     {
-        ncounter_t queueId = GetCommandQueueId( NVMAddress( 0, 0, bankHead + i, rank, 0, 0 ) );
+        ncounter_t queueId = GetCommandQueueId( NVMAddress( 0, 0, GetRefreshBank( refreshGroup, i ), rank, 0, 0 ) );
         if( !EffectivelyEmpty( queueId ) )
         {
             return false;
@@ -901,7 +938,7 @@ void MemoryController::HandleLowPower( )
         {
             for( ncounter_t bankId = 0; bankId < m_refreshBankNum; bankId++ )
             {
-                ncounter_t bankGroupHead = bankId * p->BanksPerRefresh;
+                ncounter_t bankGroupHead = GetRefreshBank( bankId, 0 );
 
                 if( NeedRefresh( bankGroupHead, rankId ) )
                 {
@@ -2013,6 +2050,7 @@ void MemoryController::CycleCommandQueues( )
  * 0 -- Fixed Scheduling from Rank0 and Bank0
  * 1 -- Rank-first round-robin
  * 2 -- Bank-first round-robin
+ * 3 -- Bank-group-first round-robin
  */
 ncounter_t MemoryController::GetCommandQueueId( NVMAddress addr )
 {
@@ -2035,6 +2073,19 @@ ncounter_t MemoryController::GetCommandQueueId( NVMAddress addr )
             /* Bank-first round-robin. */
             queueId = (addr.GetRank( ) * p->BANKS + addr.GetBank( ));
         }
+        else if( p->ScheduleScheme == 3 )
+        {
+            /* 
+             *  Bank-group-first round-robin. Neighboring queues are in
+             *  different bank groups, so consecutive column commands can
+             *  use the shorter tCCD_S.
+             */
+            ncounter_t banksPerGroup = p->BANKS / p->BankGroups;
+
+            queueId = (addr.GetRank( ) * p->BANKS 
+                       + (addr.GetBank( ) % banksPerGroup) * p->BankGroups
+                       + addr.GetBank( ) / banksPerGroup);
+        }
     }
     else if( queueModel == PerSubArrayQueues )
     {   
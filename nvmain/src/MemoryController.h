@@ -112,6 +112,7 @@ class MemoryController : public NVMObject
 
     virtual bool RequestComplete( NVMainRequest *request );
     virtual bool IsIssuable( NVMainRequest *request, FailReason *fail );
+    virtual bool IssueAtomic( NVMainRequest *request );
     ncycle_t NextIssuable( NVMainRequest *request );
 
     virtual void RegisterStats( );
@@ -255,9 +256,12 @@ class MemoryController : public NVMObject
     void IncrementRefreshCounter(const ncounter_t, const ncounter_t); 
     /* decrement the delayedRefreshCounter in a given bank group */
     void DecrementRefreshCounter(const ncounter_t, const ncounter_t); 
+    /* the refresh group of a bank, and the index-th bank of a refresh group */
+    ncounter_t GetRefreshGroup( const ncounter_t bank );
+    ncounter_t GetRefreshBank( const ncounter_t group, const ncounter_t index );
     
     ncycle_t handledRefresh;
-    /* next Refresh rank and bank */
+    /* next Refresh rank and refresh group */
     ncounter_t nextRefreshRank, nextRefreshBank; 
     /* issue REFRESH command if necessary; otherwise do nothing */
     virtual bool HandleRefresh( ); 
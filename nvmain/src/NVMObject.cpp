@@ -88,7 +88,27 @@ bool NVMObject_hook::IssueCommand( NVMainRequest *req )
 
 bool NVMObject_hook::IsIssuable( NVMainRequest *req, FailReason *reason )
 {
-    return trampoline->IsIssuable( req, reason );
+    std::vector<NVMObject *>& preHooks  = trampoline->GetHooks( NVMHOOK_PREISSUE );
+    std::vector<NVMObject *>::iterator it;
+    bool rv = true;
+
+    /* Pre-issue hooks may hold back requests, e.g., to make room for their own. */
+    for( it = preHooks.begin(); it != preHooks.end() && rv; it++ )
+    {
+        /* Skip hooks asking from inside their own callback (e.g., migrators). */
+        if( (*it)->GetParent( ) != NULL )
+            continue;
+
+        (*it)->SetParent( trampoline );
+        (*it)->SetCurrentHookType( NVMHOOK_PREISSUE );
+        rv = (*it)->IsIssuable( req, reason );
+        (*it)->UnsetParent( );
+    }
+
+    if( rv )
+        rv = trampoline->IsIssuable( req, reason );
+
+    return rv;
 }
 
 bool NVMObject_hook::IssueAtomic( NVMainRequest *req )
@@ -295,9 +315,16 @@ void NVMObject::Notify( NVMainRequest * )
 {
 }
 
-bool NVMObject::IssueAtomic( NVMainRequest * )
+bool NVMObject::IssueAtomic( NVMainRequest *req )
 {
-    return true;
+    /* 
+     *  Assume module has no functional state, simply pass the request to
+     *  the child module so the leaves (e.g., subarrays) can warm up.
+     */
+    if( GetChildCount( ) == 0 )
+        return true;
+
+    return GetChild( req )->IssueAtomic( req );
 }
 
 bool NVMObject::IssueFunctional( NVMainRequest * )
@@ -162,6 +162,11 @@ Params::Params( )
     tXS = 5;
     tXSDLL = 512;
 
+    BankGroups = 1;
+    tCCD_L = tCCD;
+    tRRD_L = tRRDR;
+    tWTR_L = tWTR;
+
     tRDPDEN = 24;
     tWRPDEN = 19;
     tWRAPDEN = 22;
@@ -170,6 +175,7 @@ Params::Params( )
     HighWaterMark = 32;
     LowWaterMark = 16;
     BanksPerRefresh = BANKS;
+    SameBankRefresh = false;
     DelayedRefreshThreshold = 1;
     AddressMappingScheme = "R:SA:RK:BK:CH:C";
 
@@ -254,6 +260,13 @@ ncycle_t Params::ConvertTiming( Config *conf, std::string param )
 /* This can be called whenever timings change. (Will not update the "next" vars) */
 void Params::SetParams( Config *c )
 {
+    /* Modules sharing a configuration reuse the values parsed for the first. */
+    if( c->GetParsedParams( ) != NULL )
+    {
+        *this = *(c->GetParsedParams( ));
+        return;
+    }
+
     c->GetValueUL( "BusWidth", BusWidth );
     c->GetValueUL( "DeviceWidth", DeviceWidth );
     c->GetValueUL( "CLK", CLK );
@@ -353,6 +366,22 @@ void Params::SetParams( Config *c )
     ConvertTiming( c, "tXS", tXS );
     ConvertTiming( c, "tXSDLL", tXSDLL );
 
+    /* Without bank groups, or if unset, the _L timings are the usual ones. */
+    if( c->KeyExists( "BankGroups" ) )
+        BankGroups = c->GetValueUL( "BankGroups" );
+    if( BankGroups == 0 || BANKS % BankGroups != 0 )
+    {
+        std::cout << "NVMain Warning: BANKS is not a multiple of BankGroups. "
+            << "Using one bank group." << std::endl;
+        BankGroups = 1;
+    }
+    tCCD_L = tCCD;
+    tRRD_L = tRRDR;
+    tWTR_L = tWTR;
+    ConvertTiming( c, "tCCD_L", tCCD_L );
+    ConvertTiming( c, "tRRD_L", tRRD_L );
+    ConvertTiming( c, "tWTR_L", tWTR_L );
+
     c->GetValueUL( "tRDPDEN", tRDPDEN );
     c->GetValueUL( "tWRPDEN", tWRPDEN );
     c->GetValueUL( "tWRAPDEN", tWRAPDEN );
@@ -361,6 +390,12 @@ void Params::SetParams( Config *c )
     c->GetValue( "HighWaterMark", HighWaterMark );
     c->GetValue( "LowWaterMark", LowWaterMark );
     c->GetValueUL( "BanksPerRefresh", BanksPerRefresh );
+    if( c->KeyExists( "SameBankRefresh" ) )
+        SameBankRefresh = c->GetBool( "SameBankRefresh" );
+
+    /* A same-bank refresh covers one bank in each bank group. */
+    if( SameBankRefresh )
+        BanksPerRefresh = BankGroups;
     c->GetValueUL( "DelayedRefreshThreshold", DelayedRefreshThreshold );
     c->GetString( "AddressMappingScheme", AddressMappingScheme );
 
@@ -426,5 +461,7 @@ void Params::SetParams( Config *c )
             std::cout << "Unknown PauseMode: " << c->GetString( "PauseMode" )
                       << ". Defaulting to Normal" << std::endl;
     }
+
+    c->SetParsedParams( new Params( *this ) );
 }
 
@@ -163,6 +163,15 @@ class Params
     ncycle_t tXS;
     ncycle_t tXSDLL;
 
+    /* 
+     *  DDR4/DDR5 bank groups (see BankGroupRank). tCCD, tRRDR and tWTR apply
+     *  across bank groups, the _L timings within a bank group.
+     */
+    ncounter_t BankGroups;
+    ncycle_t tCCD_L;
+    ncycle_t tRRD_L;
+    ncycle_t tWTR_L;
+
     ncycle_t tRDPDEN; // interval between Read/ReadA and PowerDown
     ncycle_t tWRPDEN; // interval between Write and PowerDown
     ncycle_t tWRAPDEN; // interval between WriteA and PowerDown
@@ -171,6 +180,7 @@ class Params
     int HighWaterMark; // write drain high watermark
     int LowWaterMark; // write drain low watermark
     ncounter_t BanksPerRefresh; // the number of banks in a refresh (in lockstep)
+    bool SameBankRefresh; // refresh the same bank in every bank group (DDR5 REFsb)
     ncounter_t DelayedRefreshThreshold; // the threshold that indicates how many refresh can be delayed
     std::string AddressMappingScheme; // the address mapping scheme
 
@@ -106,6 +106,32 @@ StatType Stats::getStat( std::string name )
     return rv;
 }
 
+/*
+ *  Adds up the double stats named <object>.suffix, e.g., the totalEnergy of
+ *  every rank in the system.
+ */
+double Stats::sumStats( std::string suffix )
+{
+    double rv = 0.0;
+    std::string statSuffix = "." + suffix;
+    std::vector<StatBase *>::iterator it;
+
+    for( it = statList.begin(); it != statList.end(); it++ )
+    {
+        std::string name = (*it)->GetName( );
+
+        if( name.length( ) >= statSuffix.length( )
+            && name.compare( name.length( ) - statSuffix.length( ),
+                             statSuffix.length( ), statSuffix ) == 0
+            && (*it)->GetTypeName( ) == typeid(double).name( ) )
+        {
+            rv += *(static_cast<double *>((*it)->GetValue( )));
+        }
+    }
+
+    return rv;
+}
+
 void Stats::PrintAll( std::ostream& stream )
 {
     std::vector<StatBase *>::iterator it;
@@ -131,6 +131,7 @@ class Stats
     void addStat( StatType stat, StatType resetValue, std::string statType, size_t typeSize, std::string name, std::string units, std::string statNameOp,std::string addPart );
     void removeStat( StatType stat );
     StatType getStat( std::string name );
+    double sumStats( std::string suffix );
 
     void PrintAll( std::ostream& );
     void ResetAll( );
@@ -35,6 +35,7 @@
 #include "src/Bank.h"
 #include "src/MemoryController.h"
 #include "src/EventQueue.h"
+#include "src/ConfigSchema.h"
 #include "include/NVMHelpers.h"
 #include "Endurance/EnduranceModelFactory.h"
 #include "Endurance/NullModel/NullModel.h"
@@ -133,6 +134,10 @@ SubArray::SubArray( )
     cancelCountHisto = "";
     wpPauseHisto = "";
     wpCancelHisto = "";
+    lifetimeHisto = "";
+    projectedFirstFailure = 0.0;
+    projectedLifetimeHisto = "";
+    projectionStart = 0;
     averageWriteTime = 0.0;
     measuredWriteTimes = 0;
     averageWriteIterations = 1;
@@ -151,6 +156,11 @@ SubArray::~SubArray( )
 
 void SubArray::SetConfig( Config *c, bool createChildren )
 {
+    /* Resolved once, since every subarray reads these. */
+    static const ConfigKey matWidthKey( "MATWidth" );
+    static const ConfigKey writeModeKey( "WriteMode" );
+    static const ConfigKey directWriteKey( "DirectWrite" );
+
     conf = c;
 
     Params *params = new Params( );
@@ -159,24 +169,24 @@ void SubArray::SetConfig( Config *c, bool createChildren )
 
     MATHeight = p->MATHeight;
     /* customize MAT size */
-    if( conf->KeyExists( "MATWidth" ) )
-        MATWidth = static_cast<ncounter_t>( conf->GetValue( "MATWidth" ) );
+    if( conf->KeyExists( matWidthKey ) )
+        MATWidth = static_cast<ncounter_t>( conf->GetValue( matWidthKey ) );
 
     /* Configure the write mode. */
-    if( conf->KeyExists( "WriteMode" ) )
+    if( conf->KeyExists( writeModeKey ) )
     {
-        if( conf->GetString( "WriteMode" ) == "WriteThrough" )
+        if( conf->GetString( writeModeKey ) == "WriteThrough" )
         {
             writeMode = WRITE_THROUGH;
         }
-        else if( conf->GetString( "WriteMode" ) == "WriteBack" )
+        else if( conf->GetString( writeModeKey ) == "WriteBack" )
         {
             writeMode = WRITE_BACK;
         }
         else
         {
             std::cout << "NVMain Warning: Unknown write mode `"
-                      << conf->GetString( "WriteMode" )
+                      << conf->GetString( writeModeKey )
                       << "'. Defaulting to WriteThrough" << std::endl;
             writeMode = WRITE_THROUGH;
         }
@@ -208,14 +218,14 @@ void SubArray::SetConfig( Config *c, bool createChildren )
     }
 */
 
-    if( conf->KeyExists( "DirectWrite" ) )
+    if( conf->KeyExists( directWriteKey ) )
     {
-        if( conf->GetBool( "DirectWrite" ) == true )
+        if( conf->GetBool( directWriteKey ) == true )
         {
             directWriteOn = true;
             std::cout << "NVMain Warning: Direct Write On" << std::endl;
         }
-        else if( conf->GetBool( "DirectWrite" ) == false )
+        else if( conf->GetBool( directWriteKey ) == false )
         {
             directWriteOn = false;
             std::cout << "NVMain Warning: Direct Write Off" << std::endl;
@@ -242,6 +252,7 @@ void SubArray::SetConfig( Config *c, bool createChildren )
         endrModel = EnduranceModelFactory::CreateEnduranceModel( p->EnduranceModel );
         if( endrModel )
         {
+            endrModel->StatName( StatName( ) + ".endurance" );
             endrModel->SetConfig( conf, createChildren );
             endrModel->SetStats( GetStats( ) );
         }
@@ -303,6 +314,15 @@ void SubArray::RegisterStats( )
     {
         AddStat(worstCaseEndurance);
         AddStat(averageEndurance);
+
+        if( endrModel->UsesLifeStore( ) )
+            AddStat(lifetimeHisto);
+
+        if( endrModel->ProjectsLifetime( ) )
+        {
+            AddUnitStat(projectedFirstFailure, "s");
+            AddStat(projectedLifetimeHisto);
+        }
     }
 
     AddStat(actWaits);
@@ -1408,6 +1428,34 @@ bool SubArray::IssueCommand( NVMainRequest *req )
     return rv;
 }
 
+/*
+ * IssueAtomic() updates the data-dependent state of the subarray (data
+ * encoder and endurance) without touching any timing state or events
+ */
+bool SubArray::IssueAtomic( NVMainRequest *req )
+{
+    if( req->type == WRITE || req->type == WRITE_PRECHARGE )
+    {
+        if( dataEncoder )
+            dataEncoder->Write( req );
+
+        UpdateEndurance( req );
+    }
+    else if( ( req->type == READ || req->type == READ_PRECHARGE )
+             && conf->GetSimInterface( ) != NULL && endrModel != NULL )
+    {
+        /* Remember data never written before, same as Read(). */
+        if( !conf->GetSimInterface( )->GetDataAtAddress( 
+                    req->address.GetPhysicalAddress( ), NULL ) )
+        {
+            conf->GetSimInterface( )->SetDataAtAddress( 
+                    req->address.GetPhysicalAddress( ), req->data );
+        }
+    }
+
+    return true;
+}
+
 bool SubArray::RequestComplete( NVMainRequest *req )
 {
     if( req->type == WRITE || req->type == WRITE_PRECHARGE )
@@ -1538,6 +1586,8 @@ ncycle_t SubArray::UpdateEndurance( NVMainRequest *request )
                      !conf->GetSimInterface( )-> GetDataAtAddress( 
                         request->address.GetPhysicalAddress( ), &oldData ) )
             {
+                oldData.SetSize( wordSize );
+
                 for( uint64_t i = 0; i < wordSize; i++ )
                   oldData.SetByte( i, 0 );
             }
@@ -1608,8 +1658,30 @@ ncounter_t SubArray::GetId( )
 
 void SubArray::CalculateStats( )
 {
-    worstCaseEndurance = endrModel->GetWorstLife( );
-    averageEndurance = endrModel->GetAverageLife( );
+    if( endrModel )
+    {
+        std::map<uint64_t, uint64_t> lifetimeMap;
+
+        worstCaseEndurance = endrModel->GetWorstLife( );
+        averageEndurance = endrModel->GetAverageLife( );
+
+        if( endrModel->UsesLifeStore( ) )
+        {
+            endrModel->GetLifeHistogram( lifetimeMap );
+            lifetimeHisto = PyDictHistogram<uint64_t, uint64_t>( lifetimeMap );
+        }
+
+        if( endrModel->ProjectsLifetime( ) )
+        {
+            std::map<double, uint64_t> projectedMap;
+            double window = static_cast<double>( GetEventQueue( )->GetCurrentCycle( ) 
+                                                 - projectionStart )
+                          / (static_cast<double>( p->CLK ) * 1000000.0);
+
+            projectedFirstFailure = endrModel->ProjectLifetime( window, projectedMap );
+            projectedLifetimeHisto = PyDictHistogram<double, uint64_t>( projectedMap );
+        }
+    }
 
     actWaitAverage = static_cast<double>(actWaitTotal) / static_cast<double>(actWaits);
 
@@ -1620,6 +1692,18 @@ void SubArray::CalculateStats( )
     wpCancelHisto = PyDictHistogram<double, uint64_t>( wpCancelMap );
 }
 
+void SubArray::ResetStats( )
+{
+    /* Writes before a reset (e.g., warm up) do not count toward the rate. */
+    if( endrModel && endrModel->ProjectsLifetime( ) )
+    {
+        projectionStart = GetEventQueue( )->GetCurrentCycle( );
+        endrModel->StartProjectionWindow( );
+    }
+
+    NVMObject::ResetStats( );
+}
+
 bool SubArray::Idle( )
 {
     return ( state == SUBARRAY_CLOSED || state == SUBARRAY_PRECHARGING );
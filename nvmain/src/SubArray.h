@@ -91,6 +91,7 @@ class SubArray : public NVMObject
 
     bool IsIssuable( NVMainRequest *req, FailReason *reason = NULL );
     bool IssueCommand( NVMainRequest *req );
+    bool IssueAtomic( NVMainRequest *req );
     bool RequestComplete( NVMainRequest *req );
     ncycle_t NextIssuable( NVMainRequest *request );
 
@@ -115,6 +116,7 @@ class SubArray : public NVMObject
 
     void RegisterStats( );
     void CalculateStats( );
+    void ResetStats( );
 
     ncounter_t GetId( );
     std::string GetName( );
@@ -207,6 +209,10 @@ class SubArray : public NVMObject
     std::string cancelCountHisto;
     std::string wpPauseHisto;
     std::string wpCancelHisto;
+    std::string lifetimeHisto;
+    double projectedFirstFailure;
+    std::string projectedLifetimeHisto;
+    ncycle_t projectionStart;
 
     ncycle_t WriteCellData( NVMainRequest *request );
     void CheckWritePausing( );
@@ -37,9 +37,40 @@
 using namespace NVM;
 
 
+/* Names of the static tags, in the same order as enum StaticTag. */
+static const char *staticTagNames[TAG_STATIC_COUNT] =
+{
+    "",
+    "DRC_TAGREAD1",
+    "DRC_TAGREAD2",
+    "DRC_TAGREAD3",
+    "DRC_MEMREAD",
+    "DRC_FILL",
+    "DRC_ACCESS",
+    "DRC_EVICT",
+    "MISSMAP_READ",
+    "MISSMAP_WRITE",
+    "MISSMAP_MEMREAD",
+    "MISSMAP_FORCE_EVICT",
+    "MIGREAD",
+    "MIGWRITE",
+    "GAPREAD",
+    "GAPWRITE",
+    "GAPREWRITE"
+};
+
+
 TagGenerator::TagGenerator( int startId )
 {
-    nextTag = startId;
+    /* Runtime tags may not overlap the static tags. */
+    startTag = (startId < TAG_STATIC_COUNT) ? TAG_STATIC_COUNT : startId;
+    nextTag = startTag;
+
+    /* Static tags resolve to their fixed IDs when looked up by name. */
+    for( int tag = TAG_NONE + 1; tag < TAG_STATIC_COUNT; tag++ )
+    {
+        tagNames.insert( std::pair<std::string, int>( staticTagNames[tag], tag ) );
+    }
 
     // Create the "null tag"
     (void)CreateTag( );
@@ -53,34 +84,41 @@ TagGenerator::~TagGenerator( )
 int TagGenerator::CreateTag( std::string name )
 {
     int rv = 0;
+    std::map<std::string, int>::iterator it = tagNames.find( name );
 
-    if( tagNames.count( name ) == 0 )
+    if( it == tagNames.end( ) )
     {
         tagNames.insert( std::pair<std::string, int>( name, nextTag ) );
+        tagIds.push_back( name );
         rv = nextTag;
         nextTag++;
     }
     else
     {
-        rv = tagNames[name];
+        rv = it->second;
     }
 
     return rv;
 }
 
+const char *TagGenerator::GetStaticTagName( int tag )
+{
+    const char *rv = "";
+
+    if( tag >= 0 && tag < TAG_STATIC_COUNT )
+        rv = staticTagNames[tag];
+
+    return rv;
+}
+
 std::string TagGenerator::GetTagName( int tag )
 {
     std::string rv = "";
-    std::map<std::string, int>::iterator it;
 
-    for( it = tagNames.begin( ); it != tagNames.end( ); it++ )
-    {
-        if( it->second == tag )
-        {
-            rv = it->first;
-            break;
-        }
-    }
+    if( tag < TAG_STATIC_COUNT )
+        rv = GetStaticTagName( tag );
+    else if( tag >= startTag && tag < nextTag )
+        rv = tagIds[tag - startTag];
 
     return rv;
 }
@@ -88,10 +126,10 @@ std::string TagGenerator::GetTagName( int tag )
 int TagGenerator::GetTagId( std::string name )
 {
     int rv = 0;
+    std::map<std::string, int>::iterator it = tagNames.find( name );
 
-    if( tagNames.count( name ) != 0 )
-        rv = tagNames[name];
+    if( it != tagNames.end( ) )
+        rv = it->second;
 
     return rv;
 }
-
@@ -37,10 +37,39 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 
 namespace NVM {
 
+/*
+ *  Tags used by the built-in modules. These are fixed at compile time so
+ *  requests can be tagged and dispatched with integer compares only. Tag 0
+ *  means "no tag", and runtime tags from CreateTag() start after these.
+ *  The names are listed in the same order in TagGenerator.cpp.
+ */
+enum StaticTag
+{
+    TAG_NONE = 0,
+    TAG_DRC_TAGREAD1,
+    TAG_DRC_TAGREAD2,
+    TAG_DRC_TAGREAD3,
+    TAG_DRC_MEMREAD,
+    TAG_DRC_FILL,
+    TAG_DRC_ACCESS,
+    TAG_DRC_EVICT,
+    TAG_MISSMAP_READ,
+    TAG_MISSMAP_WRITE,
+    TAG_MISSMAP_MEMREAD,
+    TAG_MISSMAP_FORCE_EVICT,
+    TAG_MIGREAD,
+    TAG_MIGWRITE,
+    TAG_GAPREAD,
+    TAG_GAPWRITE,
+    TAG_GAPREWRITE,
+    TAG_STATIC_COUNT
+};
+
 /*
  *  Generate tags at runtime that are unique to all modules in a system
  */
@@ -55,9 +84,14 @@ class TagGenerator
     std::string GetTagName( int tag );
     int GetTagId( std::string name );
 
+    static const char *GetStaticTagName( int tag );
+
   private:
     /* using this order since it is more likely to call CreateTag than GetTagName. */
     std::map<std::string, int> tagNames;
+    /* Reverse lookup of runtime tags, indexed by tag - startTag. */
+    std::vector<std::string> tagIds;
+    int startTag;
     int nextTag;
 };
 
@@ -0,0 +1,236 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "traceReader/BinaryTrace/BinaryTraceReader.h"
+#include "traceWriter/BinaryTrace/BinaryTraceFormat.h"
+#include <iostream>
+#include <cstring>
+#include <zlib.h>
+
+using namespace NVM;
+
+BinaryTraceReader::BinaryTraceReader( )
+{
+    traceFile = "";
+    trace = NULL;
+
+    dataWidth = 0;
+    recordSize = 0;
+    blockOffset = 0;
+}
+
+BinaryTraceReader::~BinaryTraceReader( )
+{
+    if( trace != NULL )
+        fclose( trace );
+}
+
+void BinaryTraceReader::SetTraceFile( std::string file )
+{
+    traceFile = file;
+}
+
+std::string BinaryTraceReader::GetTraceFile( )
+{
+    return traceFile;
+}
+
+bool BinaryTraceReader::IsBinaryTrace( std::string file )
+{
+    FILE *f = fopen( file.c_str( ), "rb" );
+    char magic[4];
+    bool rv = false;
+
+    if( f != NULL )
+    {
+        rv = ( fread( magic, 1, 4, f ) == 4 
+               && memcmp( magic, binaryTraceMagic, 4 ) == 0 );
+
+        fclose( f );
+    }
+
+    return rv;
+}
+
+bool BinaryTraceReader::OpenTrace( )
+{
+    uint32_t header[4];
+
+    trace = fopen( traceFile.c_str( ), "rb" );
+    if( trace == NULL )
+    {
+        std::cerr << "Could not open trace file: " << traceFile << "!" << std::endl;
+        return false;
+    }
+
+    if( fread( header, 1, binaryTraceHeaderSize, trace ) != binaryTraceHeaderSize
+        || memcmp( &header[0], binaryTraceMagic, 4 ) != 0 )
+    {
+        std::cerr << "BinaryTraceReader: " << traceFile 
+                  << " is not a binary trace!" << std::endl;
+        return false;
+    }
+
+    if( header[1] != binaryTraceVersion )
+    {
+        std::cerr << "BinaryTraceReader: Unsupported trace version " 
+                  << header[1] << "!" << std::endl;
+        return false;
+    }
+
+    dataWidth = header[2];
+    recordSize = header[3];
+
+    return true;
+}
+
+bool BinaryTraceReader::ReadBlock( )
+{
+    uint32_t blockHeader[2];
+
+    if( fread( blockHeader, 1, binaryTraceBlockHeaderSize, trace ) 
+            != binaryTraceBlockHeaderSize )
+        return false;
+
+    block.resize( blockHeader[0] );
+    blockOffset = 0;
+
+    if( blockHeader[1] == blockHeader[0] )
+        return ( fread( &block[0], 1, blockHeader[0], trace ) == blockHeader[0] );
+
+    storedBlock.resize( blockHeader[1] );
+
+    if( fread( &storedBlock[0], 1, blockHeader[1], trace ) != blockHeader[1] )
+        return false;
+
+    uLongf rawSize = blockHeader[0];
+
+    if( uncompress( &block[0], &rawSize, &storedBlock[0], blockHeader[1] ) != Z_OK
+        || rawSize != blockHeader[0] )
+    {
+        std::cerr << "BinaryTraceReader: Corrupt block in " << traceFile 
+                  << "!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BinaryTraceReader::GetNextAccess( TraceLine *nextAccess )
+{
+    /* If there is no trace file, we can't do anything. */
+    if( traceFile == "" )
+    {
+        std::cerr << "No trace file specified!" << std::endl;
+        return false;
+    }
+
+    if( trace == NULL && !OpenTrace( ) )
+        return false;
+
+    NVMDataBlock dataBlock;
+    NVMDataBlock oldDataBlock;
+
+    /* There are no more records in the trace... Send back a "dummy" line */
+    if( recordSize == 0 
+        || ( blockOffset + recordSize > block.size( ) && !ReadBlock( ) ) )
+    {
+        NVMAddress nAddress;
+        nAddress.SetPhysicalAddress( 0xDEADC0DEDEADBEEFULL );
+        nextAccess->SetLine( nAddress, NOP, 0, dataBlock, oldDataBlock, 0 );
+        std::cout << "BinaryTraceReader: Reached EOF!" << std::endl;
+        return false;
+    }
+
+    const uint8_t *record = &block[blockOffset];
+    uint64_t cycle, address;
+    uint32_t threadId;
+    uint8_t op;
+    uint16_t dataSize;
+
+    memcpy( &cycle, record, 8 );
+    memcpy( &address, record + 8, 8 );
+    memcpy( &threadId, record + 16, 4 );
+    memcpy( &op, record + 20, 1 );
+    memcpy( &dataSize, record + 22, 2 );
+
+    if( dataSize > 0 )
+    {
+        dataBlock.SetSize( dataSize );
+        oldDataBlock.SetSize( dataSize );
+
+        memcpy( dataBlock.rawData, record + binaryTraceRecordHeaderSize, 
+                dataSize );
+        memcpy( oldDataBlock.rawData, 
+                record + binaryTraceRecordHeaderSize + dataWidth, dataSize );
+    }
+
+    blockOffset += recordSize;
+
+    NVMAddress nAddress;
+
+    nAddress.SetPhysicalAddress( address );
+
+    nextAccess->SetLine( nAddress, ( op == 1 ) ? WRITE : READ, cycle, 
+                         dataBlock, oldDataBlock, threadId );
+
+    return true;
+}
+
+/* 
+ * Get the next N accesses to main memory. Called GetNextAccess N times and 
+ * places the return values into a vector of TraceLine pointers.
+ */
+int BinaryTraceReader::GetNextNAccesses( unsigned int N, 
+                                         std::vector<TraceLine *> *nextAccesses )
+{
+    int successes = 0;
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        /* We need a new TraceLine so the old values are not overwritten. */
+        TraceLine *nextLine = new TraceLine( );
+
+        if( GetNextAccess( nextLine ) )
+        {
+            nextAccesses->push_back( nextLine );
+            successes++;
+        }
+        else
+        {
+            delete nextLine;
+        }
+    }
+
+    return successes;
+}
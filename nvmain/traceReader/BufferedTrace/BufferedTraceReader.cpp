@@ -0,0 +1,120 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "traceReader/BufferedTrace/BufferedTraceReader.h"
+
+using namespace NVM;
+
+BufferedTraceReader::BufferedTraceReader( std::vector<TraceLine *> *buffer )
+{
+    traceFile = "";
+    traceBuffer = buffer;
+    nextLine = 0;
+}
+
+BufferedTraceReader::~BufferedTraceReader( )
+{
+}
+
+void BufferedTraceReader::SetTraceFile( std::string file )
+{
+    /* Only used for reporting; the lines come from the buffer. */
+    traceFile = file;
+}
+
+std::string BufferedTraceReader::GetTraceFile( )
+{
+    return traceFile;
+}
+
+bool BufferedTraceReader::GetNextAccess( TraceLine *nextAccess )
+{
+    if( nextLine >= traceBuffer->size( ) )
+        return false;
+
+    TraceLine *line = (*traceBuffer)[nextLine];
+
+    nextAccess->SetLine( line->GetAddress( ), line->GetOperation( ),
+                         line->GetCycle( ), line->GetData( ), 
+                         line->GetOldData( ), line->GetThreadId( ) );
+
+    nextLine++;
+
+    return true;
+}
+
+int BufferedTraceReader::GetNextNAccesses( unsigned int N, 
+                                     std::vector<TraceLine *> *nextAccesses )
+{
+    int successes = 0;
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        TraceLine *nextAccess = new TraceLine( );
+
+        if( !GetNextAccess( nextAccess ) )
+        {
+            delete nextAccess;
+            break;
+        }
+
+        nextAccesses->push_back( nextAccess );
+        successes++;
+    }
+
+    return successes;
+}
+
+size_t BufferedTraceReader::FillBuffer( GenericTraceReader *trace, 
+                                        bool ignoreData,
+                                        std::vector<TraceLine *> *buffer )
+{
+    TraceLine line;
+    NVMDataBlock noData;
+
+    while( trace->GetNextAccess( &line ) )
+    {
+        TraceLine *bufferedLine = new TraceLine( );
+
+        /* Data is not needed when every run ignores it, so don't keep it. */
+        bufferedLine->SetLine( line.GetAddress( ), line.GetOperation( ),
+                               line.GetCycle( ),
+                               (ignoreData ? noData : line.GetData( )),
+                               (ignoreData ? noData : line.GetOldData( )),
+                               line.GetThreadId( ) );
+
+        buffer->push_back( bufferedLine );
+    }
+
+    return buffer->size( );
+}
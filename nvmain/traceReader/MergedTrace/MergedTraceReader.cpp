@@ -0,0 +1,236 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "traceReader/MergedTrace/MergedTraceReader.h"
+#include "traceReader/TraceReaderFactory.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+using namespace NVM;
+
+MergedTraceReader::MergedTraceReader( std::string reader )
+{
+    traceFile = "";
+    sourceReader = reader;
+    lastSource = 0;
+    refillLast = false;
+}
+
+MergedTraceReader::~MergedTraceReader( )
+{
+    for( ncounter_t source = 0; source < sources.size( ); source++ )
+    {
+        delete sources[source].reader;
+        delete sources[source].line;
+    }
+}
+
+void MergedTraceReader::SetTraceFile( std::string file )
+{
+    traceFile = file;
+
+    OpenSources( );
+}
+
+std::string MergedTraceReader::GetTraceFile( )
+{
+    return traceFile;
+}
+
+bool MergedTraceReader::IsTraceList( std::string file )
+{
+    return ( !file.empty( ) && file[0] == '@' )
+           || file.find( ',' ) != std::string::npos;
+}
+
+void MergedTraceReader::OpenSources( )
+{
+    std::vector<std::string> files;
+    std::string file;
+
+    if( !traceFile.empty( ) && traceFile[0] == '@' )
+    {
+        std::ifstream manifest( traceFile.substr( 1 ).c_str( ) );
+        std::string line;
+
+        if( !manifest.is_open( ) )
+        {
+            std::cerr << "MergedTraceReader: Could not read trace manifest "
+                      << traceFile.substr( 1 ) << "!" << std::endl;
+            return;
+        }
+
+        /* One trace per line. Blank lines and comments beginning with ';' are skipped. */
+        while( getline( manifest, line ) )
+        {
+            std::istringstream fields( line );
+
+            if( fields >> file && file[0] != ';' )
+                files.push_back( file );
+        }
+    }
+    else
+    {
+        std::istringstream list( traceFile );
+
+        while( getline( list, file, ',' ) )
+        {
+            if( !file.empty( ) )
+                files.push_back( file );
+        }
+    }
+
+    for( size_t fileIdx = 0; fileIdx < files.size( ); fileIdx++ )
+    {
+        TraceSource source;
+
+        source.reader = TraceReaderFactory::CreateNewTraceReader( 
+                TraceReaderFactory::DetectTraceReader( files[fileIdx], sourceReader ) );
+
+        if( source.reader == NULL )
+            continue;
+
+        source.reader->SetTraceFile( files[fileIdx] );
+        source.line = new TraceLine( );
+        source.delay = 0;
+        source.held = false;
+
+        std::cout << "MergedTraceReader: Thread " << sources.size( ) << " replays "
+                  << files[fileIdx] << std::endl;
+
+        sources.push_back( source );
+
+        ReadSource( sources.size( ) - 1 );
+    }
+}
+
+void MergedTraceReader::ReadSource( ncounter_t source )
+{
+    /* Exhausted sources are simply never queued again. */
+    if( sources[source].reader->GetNextAccess( sources[source].line ) )
+    {
+        nextLines.push( std::make_pair( sources[source].line->GetCycle( ) 
+                                        + sources[source].delay, source ) );
+    }
+}
+
+/* The source's next line is read lazily so the source can still be held. */
+void MergedTraceReader::RefillLast( )
+{
+    if( refillLast )
+    {
+        refillLast = false;
+
+        if( !sources[lastSource].held )
+            ReadSource( lastSource );
+    }
+}
+
+bool MergedTraceReader::GetNextAccess( TraceLine *nextAccess )
+{
+    RefillLast( );
+
+    /* Either all traces ended or the remaining sources are held. */
+    if( nextLines.empty( ) )
+        return false;
+
+    ncycle_t cycle = nextLines.top( ).first;
+    ncounter_t source = nextLines.top( ).second;
+    TraceLine *line = sources[source].line;
+
+    nextLines.pop( );
+
+    nextAccess->SetLine( line->GetAddress( ), line->GetOperation( ), cycle, 
+                         line->GetData( ), line->GetOldData( ), 
+                         static_cast<ncounters_t>( source ) );
+
+    lastSource = source;
+    refillLast = true;
+
+    return true;
+}
+
+bool MergedTraceReader::PeekNextCycle( ncycle_t& cycle )
+{
+    RefillLast( );
+
+    if( nextLines.empty( ) )
+        return false;
+
+    cycle = nextLines.top( ).first;
+
+    return true;
+}
+
+int MergedTraceReader::GetNextNAccesses( unsigned int N, 
+                                     std::vector<TraceLine *> *nextAccesses )
+{
+    int successes = 0;
+
+    for( unsigned int i = 0; i < N; i++ )
+    {
+        TraceLine *nextAccess = new TraceLine( );
+
+        if( !GetNextAccess( nextAccess ) )
+        {
+            delete nextAccess;
+            break;
+        }
+
+        nextAccesses->push_back( nextAccess );
+        successes++;
+    }
+
+    return successes;
+}
+
+ncounter_t MergedTraceReader::GetSourceCount( )
+{
+    return sources.size( );
+}
+
+void MergedTraceReader::HoldSource( ncounter_t source )
+{
+    sources[source].held = true;
+}
+
+void MergedTraceReader::ReleaseSource( ncounter_t source, ncycle_t delay )
+{
+    sources[source].held = false;
+    sources[source].delay += delay;
+
+    /* A source held right after its line was returned is refilled lazily. */
+    if( !( refillLast && lastSource == source ) )
+        ReadSource( source );
+}
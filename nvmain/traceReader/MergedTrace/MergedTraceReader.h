@@ -0,0 +1,110 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __MERGEDTRACEREADER_H__
+#define __MERGEDTRACEREADER_H__
+
+#include "traceReader/GenericTraceReader.h"
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <utility>
+
+namespace NVM {
+
+/*
+ *  Merges several single-core traces into one stream ordered by cycle. Each
+ *  source trace may use any reader and is assigned the thread ID of its
+ *  position in the list. A source can be held while its core is stalled;
+ *  once released, its remaining lines are delayed by the stall.
+ */
+class MergedTraceReader : public GenericTraceReader
+{
+  public:
+    MergedTraceReader( std::string reader );
+    ~MergedTraceReader( );
+    
+    void SetTraceFile( std::string file );
+    std::string GetTraceFile( );
+    
+    bool GetNextAccess( TraceLine *nextAccess );
+    int  GetNextNAccesses( unsigned int N, std::vector<TraceLine *> *nextAccess );
+    /* 
+     *  Sets cycle to the cycle of the line GetNextAccess would return next.
+     *  Returns false if there is none.
+     */
+    bool PeekNextCycle( ncycle_t& cycle );
+
+    ncounter_t GetSourceCount( );
+
+    /* Stops the source of the last returned line from supplying lines. */
+    void HoldSource( ncounter_t source );
+    /* Resumes a held source, delaying its remaining lines by delay cycles. */
+    void ReleaseSource( ncounter_t source, ncycle_t delay );
+
+    /* 
+     *  Returns true if file names several traces, either as a comma separated
+     *  list or as @MANIFEST, a file listing one trace per line.
+     */
+    static bool IsTraceList( std::string file );
+  
+  private:
+    struct TraceSource
+    {
+        GenericTraceReader *reader;
+        TraceLine *line;
+        ncycle_t delay;
+        bool held;
+    };
+
+    std::string traceFile;
+    std::string sourceReader;
+    std::vector<TraceSource> sources;
+
+    /* Cycle of the next line of each source, ties go to the lower source. */
+    std::priority_queue<std::pair<ncycle_t, ncounter_t>,
+                        std::vector<std::pair<ncycle_t, ncounter_t> >,
+                        std::greater<std::pair<ncycle_t, ncounter_t> > > nextLines;
+
+    ncounter_t lastSource;
+    bool refillLast;
+
+    void OpenSources( );
+    void ReadSource( ncounter_t source );
+    void RefillLast( );
+};
+
+};
+
+#endif
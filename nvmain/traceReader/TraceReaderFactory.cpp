@@ -37,6 +37,7 @@
 /* Add your trace reader's include below. */
 #include "traceReader/NVMainTrace/NVMainTraceReader.h"
 #include "traceReader/RubyTrace/RubyTraceReader.h"
+#include "traceReader/BinaryTrace/BinaryTraceReader.h"
 
 using namespace NVM;
 
@@ -52,6 +53,8 @@ GenericTraceReader *TraceReaderFactory::CreateNewTraceReader( std::string reader
         tracer = new NVMainTraceReader( );
     else if( reader == "RubyTrace" )
         tracer = new RubyTraceReader( );
+    else if( reader == "BinaryTrace" )
+        tracer = new BinaryTraceReader( );
 
     if( tracer == NULL )
         std::cout << "NVMain: Unknown trace reader `" << reader << "'." 
@@ -59,3 +62,13 @@ GenericTraceReader *TraceReaderFactory::CreateNewTraceReader( std::string reader
 
     return tracer;
 }
+
+std::string TraceReaderFactory::DetectTraceReader( std::string file, 
+                                                  std::string reader )
+{
+    /* Pre-traces are binary by default, so recognize them by their header. */
+    if( BinaryTraceReader::IsBinaryTrace( file ) )
+        return "BinaryTrace";
+
+    return reader;
+}
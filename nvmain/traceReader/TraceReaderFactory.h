@@ -46,6 +46,9 @@ class TraceReaderFactory
     ~TraceReaderFactory( ) { }
 
     static GenericTraceReader *CreateNewTraceReader( std::string reader );
+
+    /* Returns BinaryTrace for binary trace files, otherwise reader. */
+    static std::string DetectTraceReader( std::string file, std::string reader );
 };
 
 };
@@ -0,0 +1,283 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "traceSim/TraceSampler.h"
+#include <cmath>
+#include <iostream>
+
+using namespace NVM;
+
+/* Two-sided 95% Student t quantiles for 1 to 30 degrees of freedom. */
+static const double tQuantile95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+SampleMetric::SampleMetric( )
+{
+    count = 0;
+    mean = 0.0;
+    m2 = 0.0;
+}
+
+void SampleMetric::Add( double value )
+{
+    double delta = value - mean;
+
+    count++;
+    mean += delta / static_cast<double>(count);
+    m2 += delta * ( value - mean );
+}
+
+ncounter_t SampleMetric::GetCount( )
+{
+    return count;
+}
+
+double SampleMetric::GetMean( )
+{
+    return mean;
+}
+
+/*
+ *  Half width of the 95% confidence interval of the mean. Zero until there
+ *  are at least two samples.
+ */
+double SampleMetric::GetHalfWidth( )
+{
+    if( count < 2 )
+        return 0.0;
+
+    ncounter_t df = count - 1;
+    double t = ( df <= 30 ) ? tQuantile95[df - 1] : 1.96;
+    double variance = m2 / static_cast<double>(df);
+
+    return t * sqrt( variance / static_cast<double>(count) );
+}
+
+TraceSampler::TraceSampler( )
+{
+    unit = 0;
+    interval = 0;
+    warmUp = 0;
+    position = 0;
+
+    clock = 1.0;
+    requestBytes = 0;
+
+    measuring = false;
+    sampleStartCycle = 0;
+    sampleStartEnergy = 0.0;
+    windowCompleted = 0;
+    sampleCompleted = 0;
+    sampleLatency = 0;
+
+    detailedRequests = 0;
+    fastForwardedRequests = 0;
+}
+
+void TraceSampler::Init( Config *conf )
+{
+    if( conf->KeyExists( "SamplingUnit" ) )
+        unit = conf->GetValueUL( "SamplingUnit" );
+
+    if( unit == 0 )
+        return;
+
+    /* Detailed warming defaults to one sampling unit. */
+    warmUp = unit;
+    if( conf->KeyExists( "SamplingWarmUp" ) )
+        warmUp = conf->GetValueUL( "SamplingWarmUp" );
+
+    /* Without an interval every request is simulated in detail. */
+    interval = warmUp + unit;
+    if( conf->KeyExists( "SamplingInterval" ) )
+        interval = conf->GetValueUL( "SamplingInterval" );
+
+    if( interval < warmUp + unit )
+    {
+        std::cout << "TraceSampler: SamplingInterval " << interval 
+            << " is shorter than SamplingWarmUp + SamplingUnit. Using " 
+            << warmUp + unit << "." << std::endl;
+
+        interval = warmUp + unit;
+    }
+
+    clock = static_cast<double>( conf->GetValue( "CLK" ) );
+    requestBytes = ( conf->GetValueUL( "BusWidth" ) / 8 ) 
+                   * conf->GetValueUL( "tBURST" ) * conf->GetValueUL( "RATE" );
+
+    if( conf->GetString( "EnergyModel" ) == "current" )
+        energyUnits = "mA*t";
+    else
+        energyUnits = "nJ";
+
+    std::cout << "*** Sampling " << unit << " of every " << interval 
+        << " requests after " << warmUp << " warm up requests ***" << std::endl;
+}
+
+bool TraceSampler::IsEnabled( )
+{
+    return ( unit > 0 );
+}
+
+bool TraceSampler::IsMeasuring( )
+{
+    return measuring;
+}
+
+TraceSampler::SamplePhase TraceSampler::NextPhase( )
+{
+    SamplePhase phase;
+
+    if( position < warmUp )
+        phase = SAMPLE_WARMUP;
+    else if( position < warmUp + unit )
+        phase = SAMPLE_MEASURE;
+    else
+        phase = SAMPLE_FASTFORWARD;
+
+    if( phase == SAMPLE_FASTFORWARD )
+        fastForwardedRequests++;
+    else
+        detailedRequests++;
+
+    position = ( position + 1 ) % interval;
+
+    return phase;
+}
+
+void TraceSampler::BeginSample( ncycle_t cycle, double energy )
+{
+    FinishLatency( );
+
+    measuring = true;
+    sampleStartCycle = cycle;
+    sampleStartEnergy = energy;
+    windowCompleted = 0;
+}
+
+void TraceSampler::RequestIssued( NVMainRequest *request, ncycle_t cycle )
+{
+    issueCycles[request] = cycle;
+}
+
+void TraceSampler::RequestComplete( NVMainRequest *request, ncycle_t cycle )
+{
+    std::unordered_map<NVMainRequest *, ncycle_t>::iterator it;
+
+    if( measuring )
+        windowCompleted++;
+
+    it = issueCycles.find( request );
+    if( it == issueCycles.end( ) )
+        return;
+
+    sampleCompleted++;
+    sampleLatency += cycle - it->second;
+
+    issueCycles.erase( it );
+}
+
+/*
+ *  Closes the measurement window once the last measured request has been
+ *  issued. Bandwidth and energy per request cover only the window.
+ */
+void TraceSampler::EndWindow( ncycle_t cycle, double windowEnergy )
+{
+    if( !measuring )
+        return;
+
+    measuring = false;
+
+    if( cycle <= sampleStartCycle || windowCompleted == 0 )
+        return;
+
+    /* Bytes per microsecond is MB/s. */
+    double microseconds = static_cast<double>( cycle - sampleStartCycle ) / clock;
+
+    bandwidth.Add( static_cast<double>( windowCompleted * requestBytes ) 
+                   / microseconds );
+    energy.Add( ( windowEnergy - sampleStartEnergy ) 
+                / static_cast<double>( windowCompleted ) );
+}
+
+/*
+ *  Measured requests complete after their window closes, so the latency of
+ *  a sample is only known when the next one begins. Requests that are still
+ *  in flight by then (e.g., writes held back by a write queue) are dropped.
+ */
+void TraceSampler::FinishLatency( )
+{
+    if( sampleCompleted > 0 )
+        latency.Add( static_cast<double>( sampleLatency ) 
+                     / static_cast<double>( sampleCompleted ) );
+
+    sampleCompleted = 0;
+    sampleLatency = 0;
+    issueCycles.clear( );
+}
+
+void TraceSampler::PrintStats( std::ostream& stream )
+{
+    FinishLatency( );
+
+    ncounter_t totalRequests = detailedRequests + fastForwardedRequests;
+
+    stream << "sampling.samples " << bandwidth.GetCount( ) << std::endl;
+    stream << "sampling.detailedRequests " << detailedRequests << std::endl;
+    stream << "sampling.fastForwardedRequests " << fastForwardedRequests 
+        << std::endl;
+
+    if( bandwidth.GetCount( ) < 2 )
+    {
+        stream << "sampling.note Too few samples for confidence intervals." 
+            << std::endl;
+    }
+
+    stream << "sampling.bandwidth " << bandwidth.GetMean( ) << "MB/s" 
+        << std::endl;
+    stream << "sampling.bandwidthCI95 " << bandwidth.GetHalfWidth( ) << "MB/s" 
+        << std::endl;
+    stream << "sampling.averageLatency " << latency.GetMean( ) << "cycles" 
+        << std::endl;
+    stream << "sampling.averageLatencyCI95 " << latency.GetHalfWidth( ) 
+        << "cycles" << std::endl;
+    stream << "sampling.energyPerRequest " << energy.GetMean( ) << energyUnits 
+        << std::endl;
+    stream << "sampling.energyPerRequestCI95 " << energy.GetHalfWidth( ) 
+        << energyUnits << std::endl;
+    stream << "sampling.estimatedEnergy " 
+        << energy.GetMean( ) * static_cast<double>( totalRequests ) 
+        << energyUnits << std::endl;
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __TRACESIM_TRACESAMPLER_H__
+#define __TRACESIM_TRACESAMPLER_H__
+
+#include "src/Config.h"
+#include "include/NVMTypes.h"
+#include "include/NVMainRequest.h"
+#include <ostream>
+#include <unordered_map>
+
+namespace NVM {
+
+/*
+ *  Running mean and variance of one per-sample metric (Welford's method).
+ */
+class SampleMetric
+{
+  public:
+    SampleMetric( );
+
+    void Add( double value );
+
+    ncounter_t GetCount( );
+    double GetMean( );
+    double GetHalfWidth( );
+
+  private:
+    ncounter_t count;
+    double mean;
+    double m2;
+};
+
+/*
+ *  SMARTS-style systematic sampling for traceMain. Every SamplingInterval
+ *  trace requests, SamplingWarmUp requests are simulated in detail to warm
+ *  the queues and banks, then SamplingUnit requests are simulated in detail
+ *  and measured. The rest of the interval is fast-forwarded through the
+ *  atomic path, which keeps DRAM cache tags, endurance and data state warm.
+ *  Bandwidth, latency and energy are reported with 95% confidence intervals
+ *  over the samples.
+ */
+class TraceSampler
+{
+  public:
+    enum SamplePhase
+    {
+        SAMPLE_WARMUP,
+        SAMPLE_MEASURE,
+        SAMPLE_FASTFORWARD
+    };
+
+    TraceSampler( );
+
+    void Init( Config *conf );
+    bool IsEnabled( );
+    bool IsMeasuring( );
+
+    /* Phase of the next trace request. */
+    SamplePhase NextPhase( );
+
+    void BeginSample( ncycle_t cycle, double energy );
+    void RequestIssued( NVMainRequest *request, ncycle_t cycle );
+    void RequestComplete( NVMainRequest *request, ncycle_t cycle );
+    void EndWindow( ncycle_t cycle, double energy );
+
+    void PrintStats( std::ostream& stream );
+
+  private:
+    ncounter_t unit;
+    ncounter_t interval;
+    ncounter_t warmUp;
+    ncounter_t position;
+
+    double clock;
+    ncounter_t requestBytes;
+    std::string energyUnits;
+
+    bool measuring;
+    ncycle_t sampleStartCycle;
+    double sampleStartEnergy;
+    ncounter_t windowCompleted;
+    ncounter_t sampleCompleted;
+    ncycle_t sampleLatency;
+    std::unordered_map<NVMainRequest *, ncycle_t> issueCycles;
+
+    ncounter_t detailedRequests;
+    ncounter_t fastForwardedRequests;
+
+    SampleMetric bandwidth;
+    SampleMetric latency;
+    SampleMetric energy;
+
+    void FinishLatency( );
+};
+
+};
+
+#endif
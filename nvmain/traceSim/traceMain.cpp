@@ -33,6 +33,8 @@
 
 #include <sstream>
 #include <cmath>
+#include <atomic>
+#include <thread>
 #include <stdlib.h>
 #include <fstream>
 
@@ -41,6 +43,7 @@
 #include "src/Config.h"
 #include "src/TranslationMethod.h"
 #include "traceReader/TraceReaderFactory.h"
+#include "traceReader/BufferedTrace/BufferedTraceReader.h"
 #include "src/AddressTranslator.h"
 #include "Decoders/DecoderFactory.h"
 #include "src/MemoryController.h"
@@ -55,6 +58,13 @@
 
 using namespace NVM;
 
+/* Detailed simulation resumes at skipSimCycle where the trace skipped to skipTraceCycle. */
+static ncycle_t RebaseCycle( ncycle_t traceCycle, ncycle_t skipTraceCycle, 
+                             ncycle_t skipSimCycle )
+{
+    return skipSimCycle + ((traceCycle > skipTraceCycle) ? traceCycle - skipTraceCycle : 0);
+}
+
 int main( int argc, char *argv[] )
 {
     TraceMain *traceRunner = new TraceMain( );
@@ -64,7 +74,9 @@ int main( int argc, char *argv[] )
 
 TraceMain::TraceMain( )
 {
-
+    outstandingRequests = 0;
+    coreMaxOutstanding = 0;
+    mergedTrace = NULL;
 }
 
 TraceMain::~TraceMain( )
@@ -74,24 +86,17 @@ TraceMain::~TraceMain( )
 
 int TraceMain::RunTrace( int argc, char *argv[] )
 {
-    Stats *stats = new Stats( );
     Config *config = new Config( );
     GenericTraceReader *trace = NULL;
-    TraceLine *tl = new TraceLine( );
-    SimInterface *simInterface = new NullInterface( );
-    NVMain *nvmain = new NVMain( );
-    EventQueue *mainEventQueue = new EventQueue( );
-    GlobalEventQueue *globalEventQueue = new GlobalEventQueue( );
-    TagGenerator *tagGenerator = new TagGenerator( 1000 );
-    bool IgnoreData = false;
-
     uint64_t simulateCycles;
-    uint64_t currentCycle;
+    int rv;
     
     if( argc < 4 )
     {
         std::cout << "Usage: nvmain CONFIG_FILE TRACE_FILE CYCLES [PARAM=value ...]" 
             << std::endl;
+        std::cout << "TRACE_FILE may be TRACE,TRACE,... or @MANIFEST to merge "
+            << "one trace per core." << std::endl;
         return 1;
     }
 
@@ -104,12 +109,6 @@ int TraceMain::RunTrace( int argc, char *argv[] )
     std::cout << std::endl << std::endl;
 
     config->Read( argv[1] );
-    config->SetSimInterface( simInterface );
-    SetEventQueue( mainEventQueue );
-    SetGlobalEventQueue( globalEventQueue );
-    SetStats( stats );
-    SetTagGenerator( tagGenerator );
-    std::ofstream statStream;
 
     /* Allow for overriding config parameter values for trace simulations from command line. */
     if( argc > 4 )
@@ -128,6 +127,216 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         }
     }
 
+    if( argc == 3 )
+        simulateCycles = 0;
+    else
+        simulateCycles = atoi( argv[3] );
+
+    if( config->KeyExists( "SweepFile" ) )
+    {
+        rv = RunSweep( config, argv[2], simulateCycles );
+
+        delete config;
+
+        return rv;
+    }
+
+    trace = CreateTraceReader( config, argv[2] );
+
+    rv = SimulateTrace( config, trace, simulateCycles );
+
+    delete config;
+
+    return rv;
+}
+
+/*
+ *  Runs a parameter sweep. Each line of the file named by SweepFile is a set
+ *  of PARAM=value overrides applied on top of the base configuration. The
+ *  trace is decoded once into memory and shared by all points, which are
+ *  simulated in parallel by SweepThreads threads (default: one per core).
+ *  Each point writes its statistics to <StatsFile>.<point> (or
+ *  <SweepFile>.<point> if StatsFile is not set) unless it sets StatsFile.
+ */
+int TraceMain::RunSweep( Config *config, std::string traceFile, 
+                         uint64_t simulateCycles )
+{
+    std::string sweepFileName = config->GetString( "SweepFile" );
+    std::ifstream sweepFile( sweepFileName.c_str( ) );
+    std::string statsBase = sweepFileName;
+    std::vector<Config *> pointConfigs;
+    std::vector<TraceLine *> traceBuffer;
+    GenericTraceReader *trace = NULL;
+    bool ignoreData = true;
+    std::string line;
+
+    if( !sweepFile.is_open( ) )
+    {
+        std::cout << "NVMain: Could not read sweep file: " << sweepFileName
+            << std::endl;
+        return 1;
+    }
+
+    if( config->KeyExists( "StatsFile" ) )
+        statsBase = config->GetString( "StatsFile" );
+
+    while( getline( sweepFile, line ) )
+    {
+        /* Blank lines and comments beginning with ';' are skipped. */
+        size_t cPos = line.find_first_not_of( " \t\r\n" );
+        if( cPos == std::string::npos || line[cPos] == ';' )
+            continue;
+
+        Config *pointConfig = new Config( *config );
+        std::istringstream overrides( line );
+        std::string clPair;
+        std::stringstream pointStats;
+        bool pointStatsSet = false;
+
+        pointStats << statsBase << "." << pointConfigs.size( );
+
+        std::cout << "Sweep point " << pointConfigs.size( ) << ":";
+
+        while( overrides >> clPair )
+        {
+            std::string clParam, clValue;
+
+            clParam = clPair.substr( 0, clPair.find_first_of("="));
+            clValue = clPair.substr( clPair.find_first_of("=") + 1, std::string::npos );
+
+            std::cout << " " << clParam << "=" << clValue;
+
+            pointConfig->SetValue( clParam, clValue );
+
+            if( clParam == "StatsFile" )
+                pointStatsSet = true;
+        }
+
+        if( !pointStatsSet )
+            pointConfig->SetValue( "StatsFile", pointStats.str( ) );
+
+        std::cout << " -> " << pointConfig->GetString( "StatsFile" ) << std::endl;
+
+        if( !pointConfig->KeyExists( "IgnoreData" ) 
+            || !pointConfig->GetBool( "IgnoreData" ) )
+        {
+            ignoreData = false;
+        }
+
+        pointConfigs.push_back( pointConfig );
+    }
+
+    if( pointConfigs.empty( ) )
+    {
+        std::cout << "NVMain: No sweep points in " << sweepFileName << std::endl;
+        return 1;
+    }
+
+    /* Decode the trace once. All points replay the same buffer. */
+    trace = CreateTraceReader( config, traceFile );
+
+    BufferedTraceReader::FillBuffer( trace, ignoreData, &traceBuffer );
+
+    delete trace;
+
+    ncounter_t threadCount = std::thread::hardware_concurrency( );
+    if( config->KeyExists( "SweepThreads" ) )
+        threadCount = config->GetValueUL( "SweepThreads" );
+    if( threadCount == 0 )
+        threadCount = 1;
+    if( threadCount > pointConfigs.size( ) )
+        threadCount = pointConfigs.size( );
+
+    std::cout << "*** Sweeping " << pointConfigs.size( ) << " points over " 
+        << traceBuffer.size( ) << " trace lines with " << threadCount 
+        << " threads ***" << std::endl;
+
+    /* 
+     *  Each point is a separate system with its own event queues, stats, and
+     *  tag generator, so the only shared state is the read-only trace.
+     *  As with a single run, the simulated systems live until exit.
+     */
+    std::atomic<size_t> nextPoint( 0 );
+    std::vector<std::thread> workers;
+
+    for( ncounter_t threadIdx = 0; threadIdx < threadCount; threadIdx++ )
+    {
+        workers.push_back( std::thread( [&]( )
+        {
+            size_t pointIdx;
+
+            while( (pointIdx = nextPoint++) < pointConfigs.size( ) )
+            {
+                TraceMain *pointRunner = new TraceMain( );
+                BufferedTraceReader *pointTrace = new BufferedTraceReader( &traceBuffer );
+
+                pointTrace->SetTraceFile( traceFile );
+                pointRunner->SimulateTrace( pointConfigs[pointIdx], pointTrace, 
+                                            simulateCycles );
+
+                std::cout << "Sweep point " << pointIdx << " done." << std::endl;
+
+                delete pointRunner;
+                delete pointTrace;
+            }
+        } ) );
+    }
+
+    for( size_t threadIdx = 0; threadIdx < workers.size( ); threadIdx++ )
+        workers[threadIdx].join( );
+
+    for( size_t lineIdx = 0; lineIdx < traceBuffer.size( ); lineIdx++ )
+        delete traceBuffer[lineIdx];
+
+    return 0;
+}
+
+/*
+ *  Several traces (see MergedTraceReader) are merged into one stream with a
+ *  thread ID per trace. Otherwise the reader is TraceReader, unless the file
+ *  is recognized as a binary trace.
+ */
+GenericTraceReader *TraceMain::CreateTraceReader( Config *config, 
+                                                  std::string traceFile )
+{
+    GenericTraceReader *trace = NULL;
+    std::string traceReader = "NVMainTrace";
+
+    if( config->KeyExists( "TraceReader" ) )
+        traceReader = config->GetString( "TraceReader" );
+
+    if( MergedTraceReader::IsTraceList( traceFile ) )
+        trace = new MergedTraceReader( traceReader );
+    else
+        trace = TraceReaderFactory::CreateNewTraceReader( 
+                TraceReaderFactory::DetectTraceReader( traceFile, traceReader ) );
+
+    trace->SetTraceFile( traceFile );
+
+    return trace;
+}
+
+int TraceMain::SimulateTrace( Config *config, GenericTraceReader *trace,
+                              uint64_t simulateCycles )
+{
+    Stats *stats = new Stats( );
+    TraceLine *tl = new TraceLine( );
+    SimInterface *simInterface = new NullInterface( );
+    NVMain *nvmain = new NVMain( );
+    EventQueue *mainEventQueue = new EventQueue( );
+    GlobalEventQueue *globalEventQueue = new GlobalEventQueue( );
+    TagGenerator *tagGenerator = new TagGenerator( 1000 );
+    bool IgnoreData = false;
+
+    uint64_t currentCycle;
+
+    config->SetSimInterface( simInterface );
+    SetEventQueue( mainEventQueue );
+    SetGlobalEventQueue( globalEventQueue );
+    SetStats( stats );
+    SetTagGenerator( tagGenerator );
+    std::ofstream statStream;
+
     if( config->KeyExists( "StatsFile" ) )
     {
         statStream.open( config->GetString( "StatsFile" ).c_str(), 
@@ -173,19 +382,6 @@ int TraceMain::RunTrace( int argc, char *argv[] )
     std::cout << "traceMain (" << (void*)(this) << ")" << std::endl;
     nvmain->PrintHierarchy( );
 
-    if( config->KeyExists( "TraceReader" ) )
-        trace = TraceReaderFactory::CreateNewTraceReader( 
-                config->GetString( "TraceReader" ) );
-    else
-        trace = TraceReaderFactory::CreateNewTraceReader( "NVMainTrace" );
-
-    trace->SetTraceFile( argv[2] );
-
-    if( argc == 3 )
-        simulateCycles = 0;
-    else
-        simulateCycles = atoi( argv[3] );
-
     std::cout << "*** Simulating " << simulateCycles << " input cycles. (";
 
     /*
@@ -197,9 +393,118 @@ int TraceMain::RunTrace( int argc, char *argv[] )
 
     std::cout << simulateCycles << " memory cycles) ***" << std::endl;
 
+    /*
+     *  Optionally use a prefix of the trace to functionally warm up the
+     *  memory system (DRAM caches, migration tables, prefetchers, endurance)
+     *  before the detailed simulation starts. No events are generated.
+     */
+    ncounter_t warmUpRequests = 0;
+    ncycle_t warmUpCycles = 0;
+
+    if( config->KeyExists( "WarmUpRequests" ) )
+        warmUpRequests = config->GetValueUL( "WarmUpRequests" );
+
+    if( warmUpRequests > 0 )
+    {
+        ncounter_t warmedUp = 0;
+
+        std::cout << "*** Warming up with " << warmUpRequests 
+            << " trace requests ***" << std::endl;
+
+        while( warmedUp < warmUpRequests && trace->GetNextAccess( tl ) )
+        {
+            NVMainRequest *request = new NVMainRequest( );
+
+            request->address = tl->GetAddress( );
+            request->type = tl->GetOperation( );
+            request->bulkCmd = CMD_NOP;
+            request->threadId = tl->GetThreadId( );
+            if( !IgnoreData ) request->data = tl->GetData( );
+            if( !IgnoreData ) request->oldData = tl->GetOldData( );
+            request->status = MEM_REQUEST_INCOMPLETE;
+            request->owner = (NVMObject *)this;
+
+            GetChild( )->IssueAtomic( request );
+
+            delete request;
+
+            warmUpCycles = tl->GetCycle( );
+            warmedUp++;
+        }
+
+        /* Only the detailed portion should be reported. */
+        GetChild( )->ResetStats( );
+        stats->ResetAll( );
+
+        std::cout << "*** Warm up done after " << warmedUp << " requests ***" 
+            << std::endl;
+    }
+
+    bool ignoreTraceCycle = false;
+    if( config->KeyExists( "IgnoreTraceCycle" ) )
+        ignoreTraceCycle = config->GetBool( "IgnoreTraceCycle" );
+
+    /* 
+     *  Trace cycles are shifted so that the first detailed request after a
+     *  warm up or fast-forward issues right away.
+     */
+    bool rebaseTraceCycle = ( warmUpCycles > 0 );
+    ncycle_t skipTraceCycle = warmUpCycles;
+    ncycle_t skipSimCycle = 0;
+
+    sampler.Init( config );
+
+    /* 
+     *  Optionally bound the requests each core (thread ID) has outstanding.
+     *  With merged traces, only the core with a full window stalls and its
+     *  trace is delayed by the stall. A single trace stalls as a whole.
+     */
+    if( config->KeyExists( "MaxOutstandingPerCore" ) )
+        coreMaxOutstanding = config->GetValueUL( "MaxOutstandingPerCore" );
+
+    mergedTrace = dynamic_cast<MergedTraceReader *>( trace );
+
     currentCycle = 0;
     while( currentCycle <= simulateCycles || simulateCycles == 0 )
     {
+        /* 
+         *  Stalled cores released before the next merged line is due may have
+         *  earlier lines of their own, so they are released before a line is
+         *  taken. Stalls end on completions, so time skips from event to event.
+         */
+        while( !stalledRequests.empty( ) )
+        {
+            ncycle_t nextLine = 0;
+            bool haveLine = mergedTrace->PeekNextCycle( nextLine );
+
+            if( ignoreTraceCycle )
+                nextLine = 0;
+            else if( rebaseTraceCycle )
+                nextLine = RebaseCycle( nextLine, skipTraceCycle, skipSimCycle );
+
+            if( (haveLine && nextLine <= currentCycle)
+                || (currentCycle >= simulateCycles && simulateCycles != 0) )
+                break;
+
+            ncycle_t nextWakeup = globalEventQueue->GetNextEvent( );
+
+            if( haveLine && nextLine < nextWakeup )
+                nextWakeup = nextLine;
+            if( simulateCycles != 0 && nextWakeup > simulateCycles )
+                nextWakeup = simulateCycles;
+            if( nextWakeup <= currentCycle )
+                nextWakeup = currentCycle + 1;
+
+            globalEventQueue->Cycle( nextWakeup - currentCycle );
+            currentCycle = globalEventQueue->GetCurrentCycle( );
+
+            IssueStalledRequests( );
+        }
+
+        if( !stalledRequests.empty( ) 
+            && currentCycle >= simulateCycles && simulateCycles != 0 )
+            break;
+
         if( !trace->GetNextAccess( tl ) )
         {
             /* Force all modules to drain requests. */
@@ -233,15 +538,57 @@ int TraceMain::RunTrace( int argc, char *argv[] )
         if( !IgnoreData ) request->oldData = tl->GetOldData( );
         request->status = MEM_REQUEST_INCOMPLETE;
         request->owner = (NVMObject *)this;
+
+        if( sampler.IsEnabled( ) )
+        {
+            TraceSampler::SamplePhase phase = sampler.NextPhase( );
+
+            /* 
+             *  The measurement window closes after the last measured request
+             *  is issued. Requests still in flight keep completing when the
+             *  next detailed window advances time.
+             */
+            if( phase != TraceSampler::SAMPLE_MEASURE && sampler.IsMeasuring( ) )
+            {
+                GetChild( )->CalculateStats( );
+                sampler.EndWindow( GetEventQueue( )->GetCurrentCycle( ),
+                                   stats->sumStats( "totalEnergy" ) );
+            }
+
+            /* Between samples, only warm the functional state. */
+            if( phase == TraceSampler::SAMPLE_FASTFORWARD )
+            {
+                GetChild( )->IssueAtomic( request );
+
+                delete request;
+
+                rebaseTraceCycle = true;
+                skipTraceCycle = tl->GetCycle( );
+                skipSimCycle = currentCycle;
+
+                continue;
+            }
+
+            if( phase == TraceSampler::SAMPLE_MEASURE && !sampler.IsMeasuring( ) )
+            {
+                GetChild( )->CalculateStats( );
+                sampler.BeginSample( GetEventQueue( )->GetCurrentCycle( ),
+                                     stats->sumStats( "totalEnergy" ) );
+            }
+        }
         
         /* 
          * If you want to ignore the cycles used in the trace file, just set
          * the cycle to 0. 
          */
-        if( config->KeyExists( "IgnoreTraceCycle" ) 
-                && config->GetString( "IgnoreTraceCycle" ) == "true" )
+        if( ignoreTraceCycle )
             tl->SetLine( tl->GetAddress( ), tl->GetOperation( ), 0, 
                          tl->GetData( ), tl->GetOldData( ), tl->GetThreadId( ) );
+        /* Detailed simulation resumes where the last skipped request was. */
+        else if( rebaseTraceCycle )
+            tl->SetLine( tl->GetAddress( ), tl->GetOperation( ), 
+                         RebaseCycle( tl->GetCycle( ), skipTraceCycle, skipSimCycle ),
+                         tl->GetData( ), tl->GetOldData( ), tl->GetThreadId( ) );
 
         if( request->type != READ && request->type != WRITE )
             std::cout << "traceMain: Unknown Operation: " << request->type 
@@ -275,6 +622,29 @@ int TraceMain::RunTrace( int argc, char *argv[] )
                     break;
             }
 
+            /* A core with a full window stalls until one of its requests completes. */
+            if( coreMaxOutstanding > 0 
+                && coreOutstanding[request->threadId] >= coreMaxOutstanding )
+            {
+                if( mergedTrace != NULL )
+                {
+                    stalledRequests[request->threadId] = std::make_pair( request, currentCycle );
+                    mergedTrace->HoldSource( request->threadId );
+
+                    continue;
+                }
+
+                while( coreOutstanding[request->threadId] >= coreMaxOutstanding )
+                {
+                    if( currentCycle >= simulateCycles && simulateCycles != 0 )
+                        break;
+
+                    globalEventQueue->Cycle( 1 );
+                    currentCycle = globalEventQueue->GetCurrentCycle( );
+                    coreStallCycles[request->threadId]++;
+                }
+            }
+
             /* 
              *  Wait for the memory controller to accept the next command.. 
              *  the trace reader is "stalling" until then.
@@ -286,32 +656,102 @@ int TraceMain::RunTrace( int argc, char *argv[] )
 
                 globalEventQueue->Cycle( 1 );
                 currentCycle = globalEventQueue->GetCurrentCycle( );
+
+                IssueStalledRequests( );
             }
 
-            outstandingRequests++;
-            GetChild( )->IssueCommand( request );
+            IssueRequest( request );
 
             if( currentCycle >= simulateCycles && simulateCycles != 0 )
                 break;
         }
     }       
 
+    nvmain->FlushPreTrace( );
+
+    /* The trace or the cycle limit ended in the middle of a sample. */
+    if( sampler.IsMeasuring( ) )
+    {
+        GetChild( )->CalculateStats( );
+        sampler.EndWindow( GetEventQueue( )->GetCurrentCycle( ),
+                           stats->sumStats( "totalEnergy" ) );
+    }
+
     GetChild( )->CalculateStats( );
     std::ostream& refStream = (statStream.is_open()) ? statStream : std::cout;
     stats->PrintAll( refStream );
 
+    if( sampler.IsEnabled( ) )
+        sampler.PrintStats( refStream );
+
+    if( coreMaxOutstanding > 0 )
+    {
+        std::map<ncounters_t, ncycle_t>::iterator it;
+
+        for( it = coreStallCycles.begin( ); it != coreStallCycles.end( ); it++ )
+        {
+            refStream << "traceMain.thread" << it->first << ".stallCycles " 
+                << it->second << std::endl;
+        }
+    }
+
     std::cout << "Exiting at cycle " << currentCycle << " because simCycles " 
         << simulateCycles << " reached." << std::endl; 
     if( outstandingRequests > 0 )
         std::cout << "Note: " << outstandingRequests << " requests still in-flight."
                   << std::endl;
 
-    delete config;
     delete stats;
 
     return 0;
 }
 
+void TraceMain::IssueRequest( NVMainRequest *request )
+{
+    outstandingRequests++;
+
+    if( coreMaxOutstanding > 0 )
+        coreOutstanding[request->threadId]++;
+
+    if( sampler.IsMeasuring( ) )
+        sampler.RequestIssued( request, GetEventQueue( )->GetCurrentCycle( ) );
+
+    GetChild( )->IssueCommand( request );
+}
+
+/*
+ *  Issues the requests of stalled cores that have room again and resumes
+ *  their traces, shifted by the time spent stalled.
+ */
+void TraceMain::IssueStalledRequests( )
+{
+    ncycle_t currentCycle = GetGlobalEventQueue( )->GetCurrentCycle( );
+    std::map<ncounters_t, std::pair<NVMainRequest *, ncycle_t> >::iterator it;
+
+    it = stalledRequests.begin( );
+    while( it != stalledRequests.end( ) )
+    {
+        NVMainRequest *request = it->second.first;
+
+        if( coreOutstanding[it->first] < coreMaxOutstanding 
+            && GetChild( )->IsIssuable( request ) )
+        {
+            ncycle_t stall = currentCycle - it->second.second;
+
+            coreStallCycles[it->first] += stall;
+
+            IssueRequest( request );
+            mergedTrace->ReleaseSource( it->first, stall );
+
+            stalledRequests.erase( it++ );
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
 void TraceMain::Cycle( ncycle_t /*steps*/ )
 {
 
@@ -324,6 +764,12 @@ bool TraceMain::RequestComplete( NVMainRequest* request )
 
     outstandingRequests--;
 
+    if( coreMaxOutstanding > 0 )
+        coreOutstanding[request->threadId]--;
+
+    if( sampler.IsEnabled( ) )
+        sampler.RequestComplete( request, GetEventQueue( )->GetCurrentCycle( ) );
+
     delete request;
 
     return true;
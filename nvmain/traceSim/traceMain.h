@@ -38,6 +38,11 @@
 
 
 #include "src/NVMObject.h"
+#include "traceReader/GenericTraceReader.h"
+#include "traceReader/MergedTrace/MergedTraceReader.h"
+#include "traceSim/TraceSampler.h"
+
+#include <map>
 
 
 namespace NVM {
@@ -50,6 +55,9 @@ class TraceMain : public NVMObject
     ~TraceMain( );
 
     int RunTrace( int argc, char *argv[] );
+    int RunSweep( Config *config, std::string traceFile, uint64_t simulateCycles );
+    int SimulateTrace( Config *config, GenericTraceReader *trace, 
+                       uint64_t simulateCycles );
 
     void Cycle( ncycle_t steps );
 
@@ -57,6 +65,20 @@ class TraceMain : public NVMObject
 
   private:
     ncounter_t outstandingRequests;
+    TraceSampler sampler;
+
+    /* Per-core limit on outstanding requests, 0 for no limit. */
+    ncounter_t coreMaxOutstanding;
+    std::map<ncounters_t, ncounter_t> coreOutstanding;
+    std::map<ncounters_t, ncycle_t> coreStallCycles;
+
+    /* Requests of stalled cores, with the cycle each core stalled. */
+    std::map<ncounters_t, std::pair<NVMainRequest *, ncycle_t> > stalledRequests;
+    MergedTraceReader *mergedTrace;
+
+    GenericTraceReader *CreateTraceReader( Config *config, std::string traceFile );
+    void IssueRequest( NVMainRequest *request );
+    void IssueStalledRequests( );
 };
 
 
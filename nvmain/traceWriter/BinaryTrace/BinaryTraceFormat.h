@@ -0,0 +1,70 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __BINARYTRACEFORMAT_H__
+#define __BINARYTRACEFORMAT_H__
+
+#include <stdint.h>
+
+namespace NVM {
+
+/*
+ *  Layout of traces written by BinaryTraceWriter. Values are stored in host
+ *  byte order, so a trace is replayed on the same kind of machine it was
+ *  captured on.
+ *
+ *  The file starts with a header, followed by any number of blocks:
+ *
+ *    header : "NVMB" VERSION DATAWIDTH RECORDSIZE      (4 x 32 bits)
+ *    block  : RAWSIZE STOREDSIZE BYTES[STOREDSIZE]     (2 x 32 bits + data)
+ *
+ *  A block holds whole records. When STOREDSIZE equals RAWSIZE the bytes
+ *  are stored as-is, otherwise they are zlib compressed.
+ *
+ *  Each record has a fixed size of 24 + 2 * DATAWIDTH bytes:
+ *
+ *    CYCLE(64) ADDRESS(64) THREADID(32) OP(8) PAD(8) DATASIZE(16)
+ *    DATA[DATAWIDTH] OLDDATA[DATAWIDTH]
+ *
+ *  OP is 0 for reads and 1 for writes. DATASIZE is the number of valid bytes
+ *  in DATA and OLDDATA; the remainder is zero.
+ */
+static const char binaryTraceMagic[4] = { 'N', 'V', 'M', 'B' };
+static const uint32_t binaryTraceVersion = 1;
+static const uint32_t binaryTraceHeaderSize = 16;
+static const uint32_t binaryTraceBlockHeaderSize = 8;
+static const uint32_t binaryTraceRecordHeaderSize = 24;
+
+};
+
+#endif
@@ -0,0 +1,336 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#include "traceWriter/BinaryTrace/BinaryTraceWriter.h"
+#include "traceWriter/BinaryTrace/BinaryTraceFormat.h"
+#include <iostream>
+#include <cstring>
+#include <zlib.h>
+
+using namespace NVM;
+
+/* Number of full buffers that may wait for the flush thread. */
+static const size_t maxQueuedBuffers = 2;
+static const ncounter_t maxBlockSize = 1 << 30;
+
+BinaryTraceWriter::BinaryTraceWriter( )
+{
+    trace = NULL;
+
+    bufferRecords = 65536;
+    compressionLevel = Z_BEST_SPEED;
+    dataWidth = 0;
+    recordSize = 0;
+    truncatedData = false;
+
+    fillBuffer = NULL;
+    stopping = false;
+    writing = false;
+    headerWritten = false;
+    writeFailed = false;
+}
+
+BinaryTraceWriter::~BinaryTraceWriter( )
+{
+    if( trace != NULL )
+    {
+        if( !fillBuffer->empty( ) )
+            QueueBuffer( );
+
+        {
+            std::lock_guard<std::mutex> lock( bufferLock );
+            stopping = true;
+        }
+        bufferReady.notify_one( );
+        flusher.join( );
+
+        /* Empty traces still get a header so readers recognize them. */
+        if( !headerWritten )
+            WriteHeader( );
+
+        fclose( trace );
+    }
+
+    delete fillBuffer;
+
+    while( !freeBuffers.empty( ) )
+    {
+        delete freeBuffers.front( );
+        freeBuffers.pop_front( );
+    }
+}
+
+void BinaryTraceWriter::Init( Config *conf )
+{
+    if( conf->KeyExists( "PreTraceBufferSize" ) )
+        bufferRecords = conf->GetValueUL( "PreTraceBufferSize" );
+
+    if( conf->KeyExists( "PreTraceCompression" ) )
+        compressionLevel = conf->GetValue( "PreTraceCompression" );
+}
+
+void BinaryTraceWriter::SetTraceFile( std::string file )
+{
+    // Note: This function assumes an absolute path is given, otherwise
+    // the current directory is used. 
+
+    traceFile = file;
+
+    trace = fopen( traceFile.c_str( ), "wb" );
+
+    if( trace == NULL )
+    {
+        std::cout << "Warning: Could not open trace file " << file
+                  << ". Output will be suppressed." << std::endl;
+        return;
+    }
+
+    fillBuffer = new std::vector<uint8_t>( );
+    flusher = std::thread( &BinaryTraceWriter::FlushThread, this );
+}
+
+std::string BinaryTraceWriter::GetTraceFile( )
+{
+    return traceFile;
+}
+
+bool BinaryTraceWriter::SetNextAccess( TraceLine *nextAccess )
+{
+    if( trace == NULL )
+        return false;
+
+    /* Only record reads or writes. */
+    if( nextAccess->GetOperation( ) != READ 
+        && nextAccess->GetOperation( ) != WRITE )
+        return true;
+
+    NVMDataBlock& data = nextAccess->GetData( );
+    NVMDataBlock& oldData = nextAccess->GetOldData( );
+
+    /* The record size is fixed by the first request written. */
+    if( recordSize == 0 )
+    {
+        dataWidth = static_cast<uint32_t>( data.GetSize( ) );
+        recordSize = binaryTraceRecordHeaderSize + 2 * dataWidth;
+
+        /* Block sizes are stored in 32 bits. */
+        if( bufferRecords * recordSize > maxBlockSize )
+            bufferRecords = maxBlockSize / recordSize;
+
+        fillBuffer->reserve( bufferRecords * recordSize );
+    }
+
+    uint64_t cycle = nextAccess->GetCycle( );
+    uint64_t address = nextAccess->GetAddress( ).GetPhysicalAddress( );
+    uint32_t threadId = static_cast<uint32_t>( nextAccess->GetThreadId( ) );
+    uint8_t op = ( nextAccess->GetOperation( ) == WRITE ) ? 1 : 0;
+    uint8_t pad = 0;
+    uint64_t size = data.GetSize( );
+
+    if( size > dataWidth )
+    {
+        if( !truncatedData )
+            std::cout << "BinaryTraceWriter: Request data is larger than the "
+                      << dataWidth << " bytes recorded per request. Data "
+                      << "will be truncated." << std::endl;
+
+        truncatedData = true;
+        size = dataWidth;
+    }
+
+    uint16_t dataSize = static_cast<uint16_t>( size );
+    uint64_t oldSize = ( oldData.GetSize( ) < size ) ? oldData.GetSize( ) : size;
+
+    size_t offset = fillBuffer->size( );
+    fillBuffer->resize( offset + recordSize, 0 );
+    uint8_t *record = &(*fillBuffer)[offset];
+
+    memcpy( record, &cycle, 8 );
+    memcpy( record + 8, &address, 8 );
+    memcpy( record + 16, &threadId, 4 );
+    memcpy( record + 20, &op, 1 );
+    memcpy( record + 21, &pad, 1 );
+    memcpy( record + 22, &dataSize, 2 );
+
+    if( size > 0 )
+        memcpy( record + binaryTraceRecordHeaderSize, data.rawData, size );
+    if( oldSize > 0 )
+        memcpy( record + binaryTraceRecordHeaderSize + dataWidth,
+                oldData.rawData, oldSize );
+
+    if( fillBuffer->size( ) >= bufferRecords * recordSize )
+        QueueBuffer( );
+
+    return true;
+}
+
+/*
+ *  Waits until everything recorded so far has reached the file. Since the
+ *  partial buffer is written as its own block, this is meant for the end of
+ *  a run or a stats dump, not for every request.
+ */
+void BinaryTraceWriter::Flush( )
+{
+    if( trace == NULL )
+        return;
+
+    if( !fillBuffer->empty( ) )
+        QueueBuffer( );
+
+    std::unique_lock<std::mutex> lock( bufferLock );
+
+    while( !fullBuffers.empty( ) || writing )
+        bufferFree.wait( lock );
+
+    /*
+     *  The header is only written once the first record fixes the record
+     *  size. Readers treat a record size of zero as an empty trace.
+     */
+    if( !headerWritten && recordSize != 0 )
+        WriteHeader( );
+
+    fflush( trace );
+}
+
+/*
+ *  Hands the fill buffer to the flush thread and picks up an empty one. The
+ *  simulator only blocks here if the flush thread falls behind.
+ */
+void BinaryTraceWriter::QueueBuffer( )
+{
+    std::unique_lock<std::mutex> lock( bufferLock );
+
+    while( fullBuffers.size( ) >= maxQueuedBuffers )
+        bufferFree.wait( lock );
+
+    fullBuffers.push_back( fillBuffer );
+
+    if( freeBuffers.empty( ) )
+    {
+        fillBuffer = new std::vector<uint8_t>( );
+        fillBuffer->reserve( bufferRecords * recordSize );
+    }
+    else
+    {
+        fillBuffer = freeBuffers.front( );
+        freeBuffers.pop_front( );
+    }
+
+    lock.unlock( );
+    bufferReady.notify_one( );
+}
+
+void BinaryTraceWriter::FlushThread( )
+{
+    std::unique_lock<std::mutex> lock( bufferLock );
+
+    while( true )
+    {
+        while( fullBuffers.empty( ) && !stopping )
+            bufferReady.wait( lock );
+
+        if( fullBuffers.empty( ) )
+            break;
+
+        std::vector<uint8_t> *block = fullBuffers.front( );
+        fullBuffers.pop_front( );
+        writing = true;
+
+        lock.unlock( );
+
+        WriteBlock( *block );
+        block->clear( );
+
+        lock.lock( );
+
+        freeBuffers.push_back( block );
+        writing = false;
+        bufferFree.notify_all( );
+    }
+}
+
+void BinaryTraceWriter::WriteHeader( )
+{
+    uint32_t header[4];
+
+    memcpy( &header[0], binaryTraceMagic, 4 );
+    header[1] = binaryTraceVersion;
+    header[2] = dataWidth;
+    header[3] = recordSize;
+
+    if( fwrite( header, 1, binaryTraceHeaderSize, trace ) != binaryTraceHeaderSize )
+        writeFailed = true;
+
+    headerWritten = true;
+}
+
+void BinaryTraceWriter::WriteBlock( std::vector<uint8_t>& block )
+{
+    if( !headerWritten )
+        WriteHeader( );
+
+    uint32_t blockHeader[2];
+    const uint8_t *stored = &block[0];
+    uLongf storedSize = block.size( );
+
+    blockHeader[0] = static_cast<uint32_t>( block.size( ) );
+
+    /* Keep the raw bytes if compression is off or does not pay off. */
+    if( compressionLevel > 0 )
+    {
+        uLongf compressedSize = compressBound( block.size( ) );
+
+        compressBuffer.resize( compressedSize );
+
+        if( compress2( &compressBuffer[0], &compressedSize, &block[0], 
+                       block.size( ), compressionLevel ) == Z_OK
+            && compressedSize < block.size( ) )
+        {
+            stored = &compressBuffer[0];
+            storedSize = compressedSize;
+        }
+    }
+
+    blockHeader[1] = static_cast<uint32_t>( storedSize );
+
+    if( fwrite( blockHeader, 1, binaryTraceBlockHeaderSize, trace ) 
+            != binaryTraceBlockHeaderSize
+        || fwrite( stored, 1, storedSize, trace ) != storedSize )
+    {
+        if( !writeFailed )
+            std::cout << "Warning: Could not write to trace file " 
+                      << traceFile << "." << std::endl;
+
+        writeFailed = true;
+    }
+}
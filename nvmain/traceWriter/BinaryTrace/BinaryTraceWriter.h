@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Copyright (c) 2012-2014, The Microsystems Design Labratory (MDL)
+* Department of Computer Science and Engineering, The Pennsylvania State University
+* All rights reserved.
+* 
+* This source code is part of NVMain - A cycle accurate timing, bit accurate
+* energy simulator for both volatile (e.g., DRAM) and non-volatile memory
+* (e.g., PCRAM). The source code is free and you can redistribute and/or
+* modify it by providing that the following conditions are met:
+* 
+*  1) Redistributions of source code must retain the above copyright notice,
+*     this list of conditions and the following disclaimer.
+* 
+*  2) Redistributions in binary form must reproduce the above copyright notice,
+*     this list of conditions and the following disclaimer in the documentation
+*     and/or other materials provided with the distribution.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+* 
+* Author list: 
+*   Matt Poremba    ( Email: mrp5060 at psu dot edu 
+*                     Website: http://www.cse.psu.edu/~poremba/ )
+*******************************************************************************/
+
+#ifndef __BINARYTRACEWRITER_H__
+#define __BINARYTRACEWRITER_H__
+
+#include "traceWriter/GenericTraceWriter.h"
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <stdint.h>
+
+namespace NVM {
+
+/*
+ *  Writes fixed-size binary records (see BinaryTraceFormat.h) into a memory
+ *  buffer. Full buffers are handed to a background thread that compresses
+ *  them and writes each one to the file with a single sequential write, so
+ *  the simulator only pays for a memcpy per request. Echo is not supported;
+ *  use NVMainTrace to print requests to the console.
+ */
+class BinaryTraceWriter : public GenericTraceWriter
+{
+  public:
+    BinaryTraceWriter( );
+    ~BinaryTraceWriter( );
+
+    void Init( Config *conf );
+
+    void SetTraceFile( std::string file );
+    std::string GetTraceFile( );
+
+    bool SetNextAccess( TraceLine *nextAccess );
+    void Flush( );
+
+  private:
+    std::string traceFile;
+    FILE *trace;
+
+    ncounter_t bufferRecords;
+    int compressionLevel;
+    uint32_t dataWidth;
+    uint32_t recordSize;
+    bool truncatedData;
+
+    std::vector<uint8_t> *fillBuffer;
+
+    /* Shared with the flush thread, protected by bufferLock. */
+    std::deque<std::vector<uint8_t> *> fullBuffers;
+    std::deque<std::vector<uint8_t> *> freeBuffers;
+    bool stopping;
+    bool writing;
+    std::mutex bufferLock;
+    std::condition_variable bufferReady;
+    std::condition_variable bufferFree;
+    std::thread flusher;
+
+    /* Only touched by the flush thread once it is running. */
+    std::vector<uint8_t> compressBuffer;
+    bool headerWritten;
+    bool writeFailed;
+
+    void QueueBuffer( );
+    void FlushThread( );
+    void WriteHeader( );
+    void WriteBlock( std::vector<uint8_t>& block );
+};
+
+};
+
+#endif
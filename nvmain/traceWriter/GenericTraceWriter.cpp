@@ -84,6 +84,11 @@ bool GenericTraceWriter::GetPerRankTraces( )
     return this->perRank;
 }
 
+void GenericTraceWriter::Flush( )
+{
+
+}
+
 int GenericTraceWriter::SetNextNAccesses( unsigned int N, std::vector<TraceLine *> *nextAccesses )
 {
     int numWritten = 0;
@@ -68,6 +68,9 @@ class GenericTraceWriter
     virtual int  SetNextNAccesses( unsigned int N, 
                                    std::vector<TraceLine *> *nextAccesses );
 
+    /* Writes out any buffered accesses. */
+    virtual void Flush( );
+
   private:
     bool echo_on;
     bool perChannel;
@@ -88,6 +88,12 @@ bool NVMainTraceWriter::SetNextAccess( TraceLine *nextAccess )
     return rv;
 }
 
+void NVMainTraceWriter::Flush( )
+{
+    if( trace.is_open( ) )
+        trace.flush( );
+}
+
 void NVMainTraceWriter::WriteTraceLine( std::ostream& stream, TraceLine *line )
 {
     NVMDataBlock& data = line->GetData( );
@@ -117,6 +123,6 @@ void NVMainTraceWriter::WriteTraceLine( std::ostream& stream, TraceLine *line )
     stream << oldData << " ";
 
     /* Print the thread ID */
-    stream << line->GetThreadId( ) << std::endl;
+    stream << line->GetThreadId( ) << "\n";
 }
 
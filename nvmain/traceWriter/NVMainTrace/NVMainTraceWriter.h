@@ -51,6 +51,7 @@ class NVMainTraceWriter : public GenericTraceWriter
     std::string GetTraceFile( );
     
     bool SetNextAccess( TraceLine *nextAccess );
+    void Flush( );
   
   private:
     std::string traceFile;
@@ -38,6 +38,7 @@
 #include "traceWriter/NVMainTrace/NVMainTraceWriter.h"
 #include "traceWriter/VerilogTrace/VerilogTraceWriter.h"
 #include "traceWriter/DRAMPower2Trace/DRAMPower2TraceWriter.h"
+#include "traceWriter/BinaryTrace/BinaryTraceWriter.h"
 
 using namespace NVM;
 
@@ -55,6 +56,8 @@ GenericTraceWriter *TraceWriterFactory::CreateNewTraceWriter( std::string writer
         tracer = new VerilogTraceWriter( );
     else if( writer == "DRAMPower2Trace" )
         tracer = new DRAMPower2TraceWriter( );
+    else if( writer == "BinaryTrace" )
+        tracer = new BinaryTraceWriter( );
 
     if( tracer == NULL )
         std::cout << "NVMain: Unknown trace writer `" << writer << "'." 